@@ -42,6 +42,11 @@ struct opencl_command_queue_t
 	pthread_cond_t cond_process;
 
 	volatile int process;
+
+	/* Set by a kernel launch that the device may still be running. The
+	 * next memory command waits for the device first. Only accessed by
+	 * the queue thread. */
+	int ndrange_pending;
 };
 
 
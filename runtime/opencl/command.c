@@ -33,11 +33,28 @@
 #include "misc.h"
 
 
+/* Wait for the nd-ranges that the device may still be running after a
+ * kernel launch earlier in the same queue, so that a memory command sees
+ * their results and does not overwrite their inputs */
+static void opencl_command_wait_ndranges(struct opencl_command_t *command)
+{
+	struct opencl_command_queue_t *command_queue = command->command_queue;
+	struct opencl_device_t *device = command->device;
+
+	if (!command_queue->ndrange_pending)
+		return;
+	if (device->arch_device_finish_func)
+		device->arch_device_finish_func(device->arch_device);
+	command_queue->ndrange_pending = 0;
+}
+
+
 /* Memory read */
 static void opencl_command_run_mem_read(struct opencl_command_t *command)
 {
 	struct opencl_device_t *device = command->device;
 
+	opencl_command_wait_ndranges(command);
 	assert(device->arch_device_mem_read_func);
 	device->arch_device_mem_read_func(
 			device->arch_device,
@@ -52,12 +69,18 @@ static void opencl_command_run_mem_write(struct opencl_command_t *command)
 {
 	struct opencl_device_t *device = command->device;
 
+	opencl_command_wait_ndranges(command);
 	assert(device->arch_device_mem_write_func);
 	device->arch_device_mem_write_func(
 			device->arch_device,
 			command->mem_write.device_ptr,
 			command->mem_write.host_ptr,
 			command->mem_write.size);
+
+	/* The device may still be transferring the data. Its completion
+	 * event must not be signaled before the transfer arrives. */
+	if (command->done_event && device->arch_device_finish_func)
+		device->arch_device_finish_func(device->arch_device);
 }
 
 
@@ -66,12 +89,17 @@ static void opencl_command_run_mem_copy(struct opencl_command_t *command)
 {
 	struct opencl_device_t *device = command->device;
 
+	opencl_command_wait_ndranges(command);
 	assert(device->arch_device_mem_copy_func);
 	device->arch_device_mem_copy_func(
 			device->arch_device,
 			command->mem_copy.device_dest_ptr,
 			command->mem_copy.device_src_ptr,
 			command->mem_copy.size);
+
+	/* Wait for the copy before signaling its completion event */
+	if (command->done_event && device->arch_device_finish_func)
+		device->arch_device_finish_func(device->arch_device);
 }
 
 
@@ -81,6 +109,9 @@ static void opencl_command_run_map_buffer(struct opencl_command_t *command)
 	struct opencl_mem_t *mem = command->map_buffer.mem;
 	struct opencl_device_t *device = command->device;
 
+	/* The host may access the buffer directly once it is mapped */
+	opencl_command_wait_ndranges(command);
+
 	/* Check that host pointer is still valid. This may not be true
 	 * if there was a map/unmap race condition between command queues. */
 	if (!mem->mapped)
@@ -115,6 +146,8 @@ static void opencl_command_run_unmap_buffer(struct opencl_command_t *command)
 	struct opencl_mem_t *mem = command->unmap_buffer.mem;
 	struct opencl_device_t *device = command->device;
 
+	opencl_command_wait_ndranges(command);
+
 	/* Check that host pointer is still valid. This may not be true if
 	 * there was a map/unmap race condition between command queues. */
 	if (!mem->mapped)
@@ -169,6 +202,11 @@ static void opencl_command_run_ndrange(struct opencl_command_t *command)
 
 	command->device->arch_ndrange_run_func(ndrange->arch_ndrange, 
 		command->done_event); 
+
+	/* Without a completion event, the device may still be running the
+	 * nd-range when the call returns */
+	if (!command->done_event)
+		command->command_queue->ndrange_pending = 1;
 }
 
 
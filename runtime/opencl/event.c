@@ -24,6 +24,7 @@
 #include "command.h"
 #include "command-queue.h"
 #include "debug.h"
+#include "device.h"
 #include "event.h"
 #include "list.h"
 #include "mhandle.h"
@@ -390,6 +391,7 @@ cl_int clFinish(
 {
 	struct opencl_command_t *command;
 	struct opencl_event_t *event;
+	struct opencl_device_t *device;
 
 	/* Debug */
 	opencl_debug("call '%s'", __FUNCTION__);
@@ -404,6 +406,12 @@ cl_int clFinish(
 	opencl_command_queue_enqueue(command_queue, command);
 	opencl_event_wait(event);
 
+	/* Wait for nd-ranges and memory transfers still running on the
+	 * device */
+	device = command_queue->device;
+	if (device->arch_device_finish_func)
+		device->arch_device_finish_func(device->arch_device);
+
 	/* Free event and return */
 	clReleaseEvent(event);
 	return CL_SUCCESS;	
@@ -158,6 +158,10 @@ typedef void (*opencl_arch_device_mem_copy_func_t)(
 typedef int (*opencl_arch_device_preferred_workgroups_func_t)(
 		void *device); /* Of type opencl_xxx_device_t */
 
+/* Wait for the memory transfers that the device runs asynchronously */
+typedef void (*opencl_arch_device_finish_func_t)(
+		void *device); /* Of type opencl_xxx_device_t */
+
 
 
 /*
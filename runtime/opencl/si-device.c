@@ -115,6 +115,12 @@ struct opencl_si_device_t *opencl_si_device_create(struct opencl_device_t *paren
 	/* Call-back functions for device */
 	parent->arch_device_free_func = (opencl_arch_device_free_func_t)
 			opencl_si_device_free;
+	parent->arch_device_finish_func = (opencl_arch_device_finish_func_t)
+			opencl_si_device_finish;
+
+	/* Nd-ranges launched asynchronously */
+	device->queued_ndranges = list_create();
+	pthread_mutex_init(&device->queued_ndranges_lock, NULL);
 
 	/* Memory */
 	opencl_shared_memory_str = getenv("M2S_OPENCL_SHARED_MEMORY");
@@ -205,6 +211,9 @@ struct opencl_si_device_t *opencl_si_device_create(struct opencl_device_t *paren
 			"Multi2Sim OpenCL driver version and the version of the simulator.\n"
 			"Please download the latest versions and retry.");
 
+	/* Ask the driver whether kernel launches are queued */
+	device->async_queue = ioctl(parent->fd, SIQueueIsAsync);
+
 	/* Return */
 	return device;
 }
@@ -212,6 +221,10 @@ struct opencl_si_device_t *opencl_si_device_create(struct opencl_device_t *paren
 
 void opencl_si_device_free(struct opencl_si_device_t *device)
 {
+	/* Wait for nd-ranges still running */
+	opencl_si_device_finish(device);
+	list_free(device->queued_ndranges);
+	pthread_mutex_destroy(&device->queued_ndranges_lock);
 	free(device);
 }
 
@@ -261,6 +274,38 @@ void opencl_si_device_mem_copy(struct opencl_si_device_t *device,
 	fatal("%s: not implemented", __FUNCTION__);
 }
 
+/* With option '--si-async-queue', kernel launches and memory writes return
+ * before the device completes them. This call suspends the host until the
+ * nd-ranges launched so far have finished, in launch order, and the
+ * transfers issued so far have reached the device. It works the same way
+ * for fused devices, which have no transfers to wait for. */
+void opencl_si_device_finish(struct opencl_si_device_t *device)
+{
+	struct opencl_si_ndrange_t *ndrange;
+
+	/* Wait for queued nd-ranges and free them */
+	pthread_mutex_lock(&device->queued_ndranges_lock);
+	while ((ndrange = list_dequeue(device->queued_ndranges)))
+	{
+		opencl_si_ndrange_finish(ndrange);
+		opencl_si_ndrange_free(ndrange);
+	}
+	pthread_mutex_unlock(&device->queued_ndranges_lock);
+
+	/* Invoke 'queue_finish' ABI call */
+	ioctl(device->parent->fd, SIQueueFinish);
+}
+
+/* Add an nd-range whose work-groups were sent to the driver to the list of
+ * nd-ranges that the next call to 'opencl_si_device_finish' waits for */
+void opencl_si_device_queue_ndrange(struct opencl_si_device_t *device,
+		struct opencl_si_ndrange_t *ndrange)
+{
+	pthread_mutex_lock(&device->queued_ndranges_lock);
+	list_enqueue(device->queued_ndranges, ndrange);
+	pthread_mutex_unlock(&device->queued_ndranges_lock);
+}
+
 int opencl_si_device_preferred_workgroups(struct opencl_si_device_t *device)
 {
 	return 32; /* TODO: Determine core count */
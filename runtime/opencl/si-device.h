@@ -20,6 +20,8 @@
 #ifndef RUNTIME_OPENCL_SI_DEVICE_H
 #define RUNTIME_OPENCL_SI_DEVICE_H
 
+#include <pthread.h>
+
 #include "opencl.h"
 
 
@@ -30,6 +32,16 @@ struct opencl_si_device_t
 
 	/* Parent generic device object */
 	struct opencl_device_t *parent;
+
+	/* Set when the driver runs with option '--si-async-queue'. Kernel
+	 * launches then return without waiting for their nd-range. */
+	int async_queue;
+
+	/* Nd-ranges launched but not yet waited for, in launch order. Elements
+	 * of type 'struct opencl_si_ndrange_t'. The lock protects the list
+	 * from command queue threads and the host thread in clFinish(). */
+	struct list_t *queued_ndranges;
+	pthread_mutex_t queued_ndranges_lock;
 };
 
 
@@ -49,6 +61,13 @@ void opencl_si_device_mem_write(struct opencl_si_device_t *device,
 void opencl_si_device_mem_copy(struct opencl_si_device_t *device,
 		void *device_dest_ptr, void *device_src_ptr,
 		unsigned int size);
+void opencl_si_device_finish(struct opencl_si_device_t *device);
+
+/* Forward declarations */
+struct opencl_si_ndrange_t;
+
+void opencl_si_device_queue_ndrange(struct opencl_si_device_t *device,
+		struct opencl_si_ndrange_t *ndrange);
 
 #endif
 
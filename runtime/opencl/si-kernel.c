@@ -31,6 +31,7 @@
 #include "misc.h"
 #include "object.h"
 #include "platform.h"
+#include "si-device.h"
 #include "si-kernel.h"
 #include "si-program.h"
 #include "string.h"
@@ -440,6 +441,8 @@ void opencl_si_ndrange_run_partial(struct opencl_si_ndrange_t *ndrange,
 void opencl_si_ndrange_run(struct opencl_si_ndrange_t *ndrange,
 	struct opencl_event_t *event)
 {
+	struct opencl_si_device_t *device = opencl_si_device->arch_device;
+
 	struct sched_param sched_param_old;
 	struct sched_param sched_param_new;
 	struct timespec start, end;
@@ -471,6 +474,18 @@ void opencl_si_ndrange_run(struct opencl_si_ndrange_t *ndrange,
 	/* Run all of the work groups */
 	opencl_si_ndrange_run_partial(ndrange, 0, ndrange->total_num_groups);
 
+	/* With an asynchronous queue, return without waiting. The nd-range is
+	 * finished and freed when the host waits for the device. Launches
+	 * with a completion event still wait here, so that the event is
+	 * complete and timed when the command finishes. */
+	if (device->async_queue && !event)
+	{
+		opencl_si_device_queue_ndrange(device, ndrange);
+		pthread_setschedparam(pthread_self(), sched_policy_old, 
+			&sched_param_old);
+		return;
+	}
+
 	/* Wait for the nd-range to complete and then flush the cache */
 	opencl_si_ndrange_finish(ndrange);
 
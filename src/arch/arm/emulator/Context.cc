@@ -395,6 +395,51 @@ void Context::Wakeup()
 }
 
 
+void Context::DecodeInst()
+{
+	// Get buffer according to the Program Counter
+	char *buffer_ptr;
+	if (regs.getCPSR().thumb != 0)
+		buffer_ptr = memory->getBuffer((regs.getPC() - 2), 2,
+					mem::Memory::AccessExec);
+	else
+		buffer_ptr = memory->getBuffer((regs.getPC() - 4), 4,
+					mem::Memory::AccessExec);
+
+	// Return to default safe mode
+	memory->setSafeDefault();
+
+	// Disassemble
+	if (regs.getCPSR().thumb != 0)
+	{
+		if (IsThumb32(buffer_ptr))
+		{
+			regs.incPC(2);
+			buffer_ptr = memory->getBuffer((regs.getPC() - 4), 4,
+					mem::Memory::AccessExec);
+			inst.Thumb32Decode(buffer_ptr, (regs.getPC() - 4));
+			setInstType(ContextInstTypeThumb32);
+			if (inst.getThumb32Opcode() == Instruction::Thumb32OpcodeInvalid)
+				throw misc::Panic(misc::fmt("0x%x: not supported arm instruction (%02x %02x %02x %02x...)",
+					(regs.getPC() - 4), buffer_ptr[0], buffer_ptr[1], buffer_ptr[2], buffer_ptr[3]));
+		}
+		else
+		{
+			inst.Thumb16Decode(buffer_ptr, (regs.getPC() - 2));
+			setInstType(ContextInstTypeThumb16);
+		}
+	}
+	else
+	{
+		inst.Decode((regs.getPC() - 4), buffer_ptr);
+		setInstType(ContextInstTypeArm32);
+		if (inst.getOpcode() == Instruction::OpcodeInvalid)
+			throw misc::Panic(misc::fmt("0x%x: not supported arm instruction (%02x %02x %02x %02x...)",
+					(regs.getPC() - 4), buffer_ptr[0], buffer_ptr[1], buffer_ptr[2], buffer_ptr[3]));
+	}
+}
+
+
 void Context::Execute()
 {
 	// Memory permissions should not be checked if the context is executing in
@@ -455,45 +500,35 @@ void Context::Execute()
 		}
 	}
 
-	// Get buffer according to the Program Counter
-	char *buffer_ptr;
-	if (regs.getCPSR().thumb != 0)
-		buffer_ptr = memory->getBuffer((regs.getPC() - 2), 2,
-					mem::Memory::AccessExec);
-	else
-		buffer_ptr = memory->getBuffer((regs.getPC() - 4), 4,
-					mem::Memory::AccessExec);
-
-	// Return to default safe mode
-	memory->setSafeDefault();
+	// Discard decoded instructions if the code in memory changed
+	if (decoded_inst_cache_version != memory->getCodeVersion())
+	{
+		decoded_inst_cache.clear();
+		decoded_inst_cache_version = memory->getCodeVersion();
+	}
 
-	// Disassemble
-	if (regs.getCPSR().thumb != 0)
+	// Look up the instruction in the decoded instruction cache, or
+	// fetch and decode it otherwise
+	bool thumb = regs.getCPSR().thumb != 0;
+	unsigned fetch_address = thumb ? regs.getPC() - 2 : regs.getPC() - 4;
+	unsigned index = fetch_address | (thumb ? 1 : 0);
+	auto it = decoded_inst_cache.find(index);
+	if (it != decoded_inst_cache.end())
 	{
-		if (IsThumb32(buffer_ptr))
-		{
+		inst = it->second.inst;
+		setInstType(it->second.type);
+		if (it->second.type == ContextInstTypeThumb32)
 			regs.incPC(2);
-			buffer_ptr = memory->getBuffer((regs.getPC() - 4), 4,
-					mem::Memory::AccessExec);
-			inst.Thumb32Decode(buffer_ptr, (regs.getPC() - 4));
-			setInstType(ContextInstTypeThumb32);
-			if (inst.getThumb32Opcode() == Instruction::Thumb32OpcodeInvalid)
-				throw misc::Panic(misc::fmt("0x%x: not supported arm instruction (%02x %02x %02x %02x...)",
-					(regs.getPC() - 4), buffer_ptr[0], buffer_ptr[1], buffer_ptr[2], buffer_ptr[3]));
-		}
-		else
-		{
-			inst.Thumb16Decode(buffer_ptr, (regs.getPC() - 2));
-			setInstType(ContextInstTypeThumb16);
-		}
+		memory->setSafeDefault();
 	}
 	else
 	{
-		inst.Decode((regs.getPC() - 4), buffer_ptr);
-		setInstType(ContextInstTypeArm32);
-		if (inst.getOpcode() == Instruction::OpcodeInvalid)
-			throw misc::Panic(misc::fmt("0x%x: not supported arm instruction (%02x %02x %02x %02x...)",
-					(regs.getPC() - 4), buffer_ptr[0], buffer_ptr[1], buffer_ptr[2], buffer_ptr[3]));
+		DecodeInst();
+		DecodedInst &entry = decoded_inst_cache[index];
+		entry.inst = inst;
+		entry.type = getInstType();
+		memory->MarkCode(fetch_address);
+		memory->MarkCode(fetch_address + 3);
 	}
 
 	// Execute instruction
@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <arch/common/CallStack.h>
@@ -191,6 +192,23 @@ class Context
 	// Get instruction type
 	ContextInstType getInstType() { return inst_type; }
 
+	// Instruction decoded at a given address and its type
+	struct DecodedInst
+	{
+		Instruction inst;
+		ContextInstType type;
+	};
+
+	// Cache of decoded instructions, indexed by fetch address. The
+	// lowest bit of the index is set for Thumb instructions. The cache is
+	// flushed when the code version of the memory changes.
+	std::unordered_map<unsigned, DecodedInst> decoded_inst_cache;
+	unsigned long long decoded_inst_cache_version = 0;
+
+	// Fetch and decode the instruction at the program counter into
+	// 'inst'. Called on decoded instruction cache misses.
+	void DecodeInst();
+
 	// symbol list used for getting the ARM operating mode
 	std::vector<ELFReader::Symbol *> thumb_symbol_list;
 
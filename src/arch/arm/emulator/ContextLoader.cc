@@ -104,7 +104,7 @@ void Context::LoadProgramHeaders()
 	{
 		// Load program header
 		unsigned address = phdt_base + index * phdr_size;
-		memory->Init(address, phdr_size, (char *)
+		memory->Init(address, phdr_size, (const char *)
 				program_header->getRawInfo());
 
 		// Debug
@@ -19,6 +19,7 @@
 
 #include "CallStack.h"
 
+#include <lib/cpp/Misc.h>
 #include <lib/cpp/String.h>
 #include <lib/esim/Engine.h>
 
@@ -36,12 +37,14 @@ ELFReader::File *CallStack::getELFFile(const std::string &path)
 	if (it != elf_file_map.end())
 		return it->second;
 	
-	// Parse file
-	ELFReader::File *elf_file;
+	// Parse file. The file shares its mapping with other ELF files loaded
+	// from the same path, such as the program loaded by the emulator.
+	std::unique_ptr<ELFReader::File> file;
 	try
 	{
-		// Load file
-		elf_file = new ELFReader::File(path);
+		// Load file and its symbol table, which is read on demand
+		file = misc::new_unique<ELFReader::File>(path);
+		file->getSymbols();
 	}
 	catch (ELFReader::Error &e)
 	{
@@ -52,7 +55,8 @@ ELFReader::File *CallStack::getELFFile(const std::string &path)
 	}
 
 	// Save ELF file
-	elf_file_list.emplace_back(elf_file);
+	ELFReader::File *elf_file = file.get();
+	elf_file_list.push_back(std::move(file));
 	elf_file_map[path] = elf_file;
 
 	// Return it
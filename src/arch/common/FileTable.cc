@@ -17,6 +17,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */ 
  
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "FileTable.h"
@@ -174,5 +175,35 @@ void FileTable::freeFileDescriptor(int index)
 }
 
 
+void FileTable::ReopenHostFiles()
+{
+	for (auto &desc : descriptors)
+	{
+		// Only files with a host path
+		if (!desc || (desc->getType() != FileDescriptor::TypeRegular &&
+				desc->getType() != FileDescriptor::TypeVirtual))
+			continue;
+
+		// Open the file again, without creating or truncating it
+		int host_index = desc->getHostIndex();
+		int flags = desc->getFlags() & ~(O_CREAT | O_EXCL | O_TRUNC);
+		int new_host_index = open(desc->getPath().c_str(), flags);
+		if (new_host_index < 0)
+		{
+			misc::Warning("%s: host file could not be opened again",
+					desc->getPath().c_str());
+			continue;
+		}
+
+		// Move the file offset and replace the old host file
+		off_t offset = lseek(host_index, 0, SEEK_CUR);
+		if (offset >= 0)
+			lseek(new_host_index, offset, SEEK_SET);
+		dup2(new_host_index, host_index);
+		close(new_host_index);
+	}
+}
+
+
 }  // namespace comm
 
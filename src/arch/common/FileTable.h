@@ -192,6 +192,12 @@ public:
 	/// range, the call will ignore it silently.
 	void freeFileDescriptor(int index);
 
+	/// Open again the host files of regular and virtual file descriptors,
+	/// keeping their host file descriptors and file offsets. This is used
+	/// in a process created with fork(), which would otherwise share file
+	/// offsets with its parent.
+	void ReopenHostFiles();
+
 	/// Return the host file descriptor associated with the guest file
 	/// descriptor given in \a guest_index, or -1 if \a index is not a
 	/// valid guest descriptor.
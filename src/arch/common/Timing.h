@@ -110,6 +110,10 @@ public:
 	/// Dump the statistics summary for the timing simulator.
 	virtual void DumpSummary(std::ostream &os) const { }
 
+	/// Return the number of instructions committed so far by the timing
+	/// simulator, or 0 if the architecture does not count them.
+	virtual long long getNumCommittedInstructions() const { return 0; }
+
 	/// Dump report for the timing simulator.
 	virtual void DumpReport() const { }
 
@@ -108,22 +108,49 @@ void HsaExecutable::preprocessRegisters(
 			continue;
 		}
 
-		// Traverse each operands of an instruction
+		// Traverse each operands of an instruction, including the
+		// registers used in addresses and operand lists, so that all
+		// of them get a slot in the stack frame.
 		for (unsigned int j = 0; j < entry->getOperandCount(); j++)
 		{
 			auto operand = entry->getOperand(j);
 			if (!operand.get()) break;
 
-			// operand->Dump(entry->getOperandType(j), std::cout);
-			if (operand->getKind() != BRIG_KIND_OPERAND_REGISTER)
-				continue;
-
-			BrigRegisterKind kind = operand->getRegKind();
-			unsigned short number = operand->getRegNumber() + 1;
-			if (number > max_reg[kind])
+			// Collect register operands
+			std::vector<std::unique_ptr<BrigOperandEntry>> registers;
+			if (operand->getKind() == BRIG_KIND_OPERAND_REGISTER)
+			{
+				registers.push_back(std::move(operand));
+			}
+			else if (operand->getKind() == BRIG_KIND_OPERAND_ADDRESS)
 			{
-				max_reg[kind] = number;
+				auto reg = operand->getReg();
+				if (reg.get())
+					registers.push_back(std::move(reg));
+			}
+			else if (operand->getKind() ==
+					BRIG_KIND_OPERAND_OPERAND_LIST)
+			{
+				for (unsigned k = 0;
+						k < operand->getElementCount();
+						k++)
+				{
+					auto element = operand->
+							getOperandElement(k);
+					if (element->getKind() ==
+						BRIG_KIND_OPERAND_REGISTER)
+						registers.push_back(
+							std::move(element));
+				}
+			}
 
+			// Record the highest register number of each kind
+			for (auto &reg : registers)
+			{
+				BrigRegisterKind kind = reg->getRegKind();
+				unsigned short number = reg->getRegNumber() + 1;
+				if (number > max_reg[kind])
+					max_reg[kind] = number;
 			}
 		}
 
@@ -201,6 +228,7 @@ void HsaExecutable::parseFunction(BrigFile *file,
 	first_entry = entry->getFirstCodeBlockEntry();
 	function->setFirstEntry(std::move(first_entry));
 	function->setFunctionDirective(std::move(entry));
+	function->LoadEntries();
 
 	if (Emulator::loader_debug)
 		function->Dump(Emulator::loader_debug);
@@ -24,6 +24,7 @@
 
 #include "Emulator.h"
 #include "AQLQueue.h"
+#include "WorkItem.h"
 
 namespace HSA
 {
@@ -125,6 +126,25 @@ Emulator *Emulator::getInstance()
 }
 
 
+HsaInstructionWorker *Emulator::getInstructionWorker(BrigOpcode opcode)
+{
+	// Vendor extension opcodes are not supported
+	if (opcode > BRIG_OPCODE_WAVEID)
+		throw misc::Panic(misc::fmt("Opcode %s (%d) not implemented.",
+				AsmService::OpcodeToString(opcode).c_str(),
+				opcode));
+
+	// Create the workers on first use
+	if (instruction_workers.empty())
+		instruction_workers.resize(BRIG_OPCODE_WAVEID + 1);
+	std::unique_ptr<HsaInstructionWorker> &worker =
+			instruction_workers[opcode];
+	if (!worker.get())
+		worker = WorkItem::CreateInstructionWorker(opcode);
+	return worker.get();
+}
+
+
 void Emulator::InstallComponents(const std::string& config_file = "")
 {
 	if (config_file != "")
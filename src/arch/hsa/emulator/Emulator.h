@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <list>
+#include <vector>
 
 #include <arch/common/Arch.h>
 #include <arch/common/Emulator.h>
@@ -29,10 +30,12 @@
 #include <lib/cpp/Debug.h>
 #include <memory/Memory.h>
 #include <memory/Manager.h>
+#include <arch/hsa/disassembler/Brig.h>
 //#include <arch/hsa/driver/runtime.h>
 
 #include "AQLQueue.h"
 #include "Component.h"
+#include "HsaInstructionWorker.h"
 
 namespace HSA
 {
@@ -93,6 +96,10 @@ class Emulator : public comm::Emulator
 	// Global memory manager
 	std::unique_ptr<mem::Manager> manager;
 
+	// Instruction workers indexed by opcode, shared by all work items and
+	// created the first time an opcode is executed.
+	std::vector<std::unique_ptr<HsaInstructionWorker>> instruction_workers;
+
 public:
 
 	/// Destructor
@@ -173,8 +180,15 @@ public:
 	{
 		this->memory = memory;
 		manager.reset(new mem::Manager(memory));
+
+		// Workers may keep a reference to the old memory
+		instruction_workers.clear();
 	}
 
+	/// Return the instruction worker that emulates the given opcode. The
+	/// worker must be bound to a work item before being executed.
+	HsaInstructionWorker *getInstructionWorker(BrigOpcode opcode);
+
 	/// Create a singal with the initial value and returns the handler
 	uint64_t CreateSignal(uint64_t init_value);
 
@@ -17,6 +17,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cstdlib>
 #include <cstring>
 
 #include <lib/cpp/String.h>
@@ -60,6 +61,37 @@ std::unique_ptr<BrigCodeEntry> Function::getLastEntry() const
 }
 
 
+void Function::LoadEntries()
+{
+	// Nothing to do for functions without a body
+	entries.clear();
+	entry_indices.clear();
+	if (!first_entry.get() || !last_entry.get())
+		return;
+
+	// Traverse entries in the function body
+	unsigned int last_offset = last_entry->getOffset();
+	auto entry = getFirstEntry();
+	while (entry.get() && entry->getOffset() <= last_offset)
+	{
+		auto next_entry = entry->Next();
+		entry_indices[entry->getOffset()] = entries.size();
+		entries.push_back(std::move(entry));
+		entry = std::move(next_entry);
+	}
+}
+
+
+unsigned int Function::getEntryIndex(unsigned int offset) const
+{
+	auto it = entry_indices.find(offset);
+	if (it == entry_indices.end())
+		throw misc::Panic(misc::fmt("Offset 0x%x is not a code entry "
+				"of function %s", offset, name.c_str()));
+	return it->second;
+}
+
+
 void Function::addArgument(std::unique_ptr<Variable> argument)
 {
 
@@ -80,54 +112,45 @@ void Function::addArgument(std::unique_ptr<Variable> argument)
 }
 
 
-void Function::addRegister(BrigRegisterKind kind, unsigned short number)
-{
-	// Get register's string representation
-	std::string register_name = AsmService::RegisterToString(kind, number);
-
-	// Check if the register has been added
-	if (register_info.find(register_name) != register_info.end())
-		throw misc::Panic("Duplicate register name");
-
-	// Allocate size for the register
-	register_info.insert(std::make_pair(register_name, register_size));
-	switch(kind)
-	{
-	case BRIG_REGISTER_KIND_CONTROL:
-		break;
-	case BRIG_REGISTER_KIND_SINGLE:
-		register_size += 4;
-		break;
-	case BRIG_REGISTER_KIND_DOUBLE:
-		register_size += 8;
-		break;
-	case BRIG_REGISTER_KIND_QUAD:
-		register_size += 16;
-		break;
-	}
-
-}
-
-
-unsigned int Function::getRegisterOffset(const std::string &name) const
+Function::RegisterSlot Function::getRegisterSlot(const std::string &name) const
 {
-	auto it = register_info.find(name);
-	if (it == register_info.end())
-		throw misc::Panic(misc::fmt("Register %s not found",
+	// Register names have the form "$<kind><number>"
+	BrigRegisterKind kind;
+	if (name.size() < 3)
+		throw misc::Panic(misc::fmt("Unknown register name %s",
 				name.c_str()));
-
-	return it->second;
+	else if (name[1] == 'c')
+		kind = BRIG_REGISTER_KIND_CONTROL;
+	else if (name[1] == 's')
+		kind = BRIG_REGISTER_KIND_SINGLE;
+	else if (name[1] == 'd')
+		kind = BRIG_REGISTER_KIND_DOUBLE;
+	else if (name[1] == 'q')
+		kind = BRIG_REGISTER_KIND_QUAD;
+	else
+		throw misc::Panic(misc::fmt("Unknown register name %s",
+				name.c_str()));
+	return getRegisterSlot(kind, atoi(name.c_str() + 2));
 }
 
 
 void Function::AllocateRegister(unsigned int *max_register)
 {
-	for (unsigned int i = 0; i < 4; i++)
+	// Allocate wider registers first so that all of them are naturally
+	// aligned within the register storage. Control registers go last.
+	static const BrigRegisterKind order[4] = {
+		BRIG_REGISTER_KIND_QUAD,
+		BRIG_REGISTER_KIND_DOUBLE,
+		BRIG_REGISTER_KIND_SINGLE,
+		BRIG_REGISTER_KIND_CONTROL
+	};
+	register_size = 0;
+	for (BrigRegisterKind kind : order)
 	{
-		for(unsigned int j = 0; j < max_register[i]; j++)
-		{
-			addRegister((BrigRegisterKind)i, j);
-		}
+		register_count[kind] = max_register[kind];
+		register_base[kind] = register_size;
+		register_size += max_register[kind] *
+				getRegisterKindSize(kind);
 	}
 }
 
@@ -295,11 +318,16 @@ void Function::DumpRegisterInfo(std::ostream &os = std::cout) const
 {
 	// Dump the argument information
 	os << misc::fmt("\n\t***** Registers *****\n");
-	for (auto it = register_info.begin(); it != register_info.end(); it++)
+	for (unsigned kind = 0; kind < 4; kind++)
 	{
-		os << misc::fmt("\tregister %s, offset %d\n",
-				it->first.c_str(),
-				getRegisterOffset(it->first));
+		for (unsigned i = 0; i < register_count[kind]; i++)
+		{
+			std::string name = AsmService::RegisterToString(
+					(BrigRegisterKind) kind, i);
+			os << misc::fmt("\tregister %s, offset %d\n",
+					name.c_str(),
+					getRegisterOffset(name));
+		}
 	}
 	os << misc::fmt("\tRegister size allocated %d bytes\n", register_size);
 	os << misc::fmt("\t*********************\n\n");
@@ -23,7 +23,10 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include <arch/hsa/disassembler/AsmService.h>
 #include <arch/hsa/disassembler/BrigCodeEntry.h>
 
 #include "Variable.h"
@@ -57,6 +60,14 @@ class Function
 	// The directive where the function is declared
 	std::unique_ptr<BrigCodeEntry> function_directive;
 
+	// Code entries of the function body, from the first to the last
+	// entry, materialized once by LoadEntries()
+	std::vector<std::unique_ptr<BrigCodeEntry>> entries;
+
+	// Index in 'entries' of each code entry, indexed by its offset in
+	// the code section
+	std::unordered_map<unsigned int, unsigned int> entry_indices;
+
 	/// Dump argument related information
 	void DumpArgumentInfo(std::ostream &os) const;
 
@@ -87,14 +98,34 @@ class Function
 	// Allocated register size
 	unsigned int register_size = 0;
 
-	// Maps register
-	std::map<std::string, unsigned int> register_info;
+	// Number of registers of each kind, indexed by BrigRegisterKind
+	unsigned int register_count[4] = {0, 0, 0, 0};
 
-	// Add register information into table
-	void addRegister(BrigRegisterKind kind, unsigned short number);
+	// Offset in the register storage of the first register of each kind,
+	// indexed by BrigRegisterKind. Registers of the same kind are
+	// allocated consecutively.
+	unsigned int register_base[4] = {0, 0, 0, 0};
 
 public:
 
+	/// Location of a register in the register storage of a stack frame
+	struct RegisterSlot
+	{
+		/// Offset in bytes
+		unsigned int offset;
+
+		/// Size in bytes
+		unsigned int size;
+	};
+
+	/// Return the size in bytes of a register of the given kind. Control
+	/// registers take one byte each.
+	static unsigned int getRegisterKindSize(BrigRegisterKind kind)
+	{
+		static const unsigned int sizes[4] = {1, 4, 8, 16};
+		return sizes[kind];
+	}
+
 	/// Constructor
 	Function(const std::string &name);
 
@@ -123,6 +154,24 @@ public:
 	/// Return pointer to the last entry
 	std::unique_ptr<BrigCodeEntry> getLastEntry() const;
 
+	/// Materialize all code entries between the first and the last entry.
+	/// Must be called once both have been set.
+	void LoadEntries();
+
+	/// Return the number of code entries in the function body
+	unsigned int getNumEntries() const { return entries.size(); }
+
+	/// Return the code entry with the given index in the function body,
+	/// or nullptr if the index is past the last entry.
+	BrigCodeEntry *getEntry(unsigned int index) const
+	{
+		return index < entries.size() ? entries[index].get() : nullptr;
+	}
+
+	/// Return the index in the function body of the code entry at the
+	/// given offset of the code section.
+	unsigned int getEntryIndex(unsigned int offset) const;
+
 	/// Set the directive
 	void setFunctionDirective(std::unique_ptr<BrigCodeEntry> directive)
 	{
@@ -144,26 +193,40 @@ public:
 	/// Return the number of arguments
 	unsigned getArgumentCount() const { return arguments.size(); }
 
-	/// Allocate register
+	/// Allocate registers, given the number of registers of each kind
+	/// used by the function, indexed by BrigRegisterKind.
 	void AllocateRegister(unsigned int *max_reg);
 
-	/// Return the offset of an register. If the register does not exist,
-	/// return -1.
-	unsigned int getRegisterOffset(const std::string &name) const;
+	/// Return the slot of the register of the given kind and number. The
+	/// slot is computed from the layout built in AllocateRegister(),
+	/// without looking up the register name.
+	RegisterSlot getRegisterSlot(BrigRegisterKind kind,
+			unsigned short number) const
+	{
+		if (number >= register_count[kind])
+			throw misc::Panic(misc::fmt("Register %s not found",
+					AsmService::RegisterToString(kind,
+					number).c_str()));
+		unsigned int size = getRegisterKindSize(kind);
+		return {register_base[kind] + number * size, size};
+	}
 
-	/// Return the size of register required
-	unsigned int getRegisterSize() const { return register_size; }
+	/// Return the slot of a register given its name, such as "$s1".
+	RegisterSlot getRegisterSlot(const std::string &name) const;
 
-	/// Return the begin iterator of the register
-	std::map<std::string, unsigned>::iterator getRegisterBegin() 
+	/// Return the offset of a register given its name
+	unsigned int getRegisterOffset(const std::string &name) const
 	{
-		return register_info.begin();
+		return getRegisterSlot(name).offset;
 	}
 
-	// Return the end iterator of the register
-	std::map<std::string, unsigned>:: iterator getRegisterEnd()
+	/// Return the size of register required
+	unsigned int getRegisterSize() const { return register_size; }
+
+	/// Return the number of registers of the given kind
+	unsigned int getRegisterCount(BrigRegisterKind kind) const
 	{
-		return register_info.end();
+		return register_count[kind];
 	}
 
 	/*
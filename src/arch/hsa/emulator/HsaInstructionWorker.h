@@ -57,6 +57,23 @@ public:
 	/// Destructor
 	virtual ~HsaInstructionWorker() {};
 
+	/// Make the worker act on the given work item and stack frame. A
+	/// single worker per opcode is shared by all work items, and it is
+	/// bound to the executing work item before each call to Execute().
+	void Bind(WorkItem *work_item, StackFrame *stack_frame)
+	{
+		this->work_item = work_item;
+		this->stack_frame = stack_frame;
+		operand_value_retriever->Bind(work_item, stack_frame);
+		operand_value_writer->Bind(work_item, stack_frame);
+	}
+
+	/// Return the work item that the worker is bound to
+	WorkItem *getWorkItem() const { return work_item; }
+
+	/// Return the stack frame that the worker is bound to
+	StackFrame *getStackFrame() const { return stack_frame; }
+
 	/// Execute the instruction
 	virtual void Execute(BrigCodeEntry *instruction) = 0;
 
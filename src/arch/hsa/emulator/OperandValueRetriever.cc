@@ -67,11 +67,10 @@ void OperandValueRetriever::Retrieve(BrigCodeEntry *instruction,
 
 	case BRIG_KIND_OPERAND_REGISTER:
 
-	{
-		std::string register_name = operand->getRegisterName();
-		stack_frame->getRegisterValue(register_name, buffer);
+		stack_frame->getRegisterValue(operand->getRegKind(),
+				operand->getRegNumber(), buffer);
 		return;
-	}
+
 
 	case BRIG_KIND_OPERAND_ADDRESS:
 
@@ -103,12 +102,12 @@ void OperandValueRetriever::Retrieve(BrigCodeEntry *instruction,
 
 			address += variable->getAddress();
 		}
-		if(operand->getReg().get())
+		auto reg = operand->getReg();
+		if (reg.get())
 		{
-			std::string register_name = operand->getReg()
-						->getRegisterName();
 			unsigned long long reg_address = 0;
-			stack_frame->getRegisterValue(register_name,
+			stack_frame->getRegisterValue(reg->getRegKind(),
+					reg->getRegNumber(),
 					&reg_address);
 			address += reg_address;
 		}
@@ -130,15 +129,13 @@ void OperandValueRetriever::Retrieve(BrigCodeEntry *instruction,
 			case BRIG_KIND_OPERAND_REGISTER:
 
 			{
-				std::string register_name =
-						op_item->
-						getRegisterName();
-				unsigned size = AsmService::getSizeInByteByRegisterName(
-								register_name);
-				stack_frame->getRegisterValue
-						(register_name,
+				Function::RegisterSlot slot = stack_frame->
+						getFunction()->getRegisterSlot(
+						op_item->getRegKind(),
+						op_item->getRegNumber());
+				stack_frame->getRegisterValue(slot,
 						(unsigned char *)buffer
-						+ i * size);
+						+ i * slot.size);
 				break;
 			}
 
@@ -33,6 +33,15 @@ class OperandValueRetriever
 public:
 	OperandValueRetriever(WorkItem *work_item, StackFrame *stack_frame);
 	virtual ~OperandValueRetriever();
+
+	/// Make the following operations act on the given work item and
+	/// stack frame
+	void Bind(WorkItem *work_item, StackFrame *stack_frame)
+	{
+		this->work_item = work_item;
+		this->stack_frame = stack_frame;
+	}
+
 	virtual void Retrieve(BrigCodeEntry *instruction,
 			unsigned int index, void *buffer);
 };
@@ -49,11 +49,10 @@ void OperandValueWriter::Write(BrigCodeEntry *instruction,
 	{
 	case BRIG_KIND_OPERAND_REGISTER:
 
-	{
-		std::string register_name = operand->getRegisterName();
-		stack_frame->setRegisterValue(register_name, buffer);
+		stack_frame->setRegisterValue(operand->getRegKind(),
+				operand->getRegNumber(), buffer);
 		break;
-	}
+
 
 	case BRIG_KIND_OPERAND_OPERAND_LIST:
 
@@ -68,14 +67,13 @@ void OperandValueWriter::Write(BrigCodeEntry *instruction,
 			case BRIG_KIND_OPERAND_REGISTER:
 
 			{
-				std::string register_name =
-						op_item->
-						getRegisterName();
-				unsigned size = AsmService::getSizeInByteByRegisterName(
-						register_name);
-				stack_frame->setRegisterValue
-						(register_name,
-						 (unsigned char *)buffer + i * size);
+				Function::RegisterSlot slot = stack_frame->
+						getFunction()->getRegisterSlot(
+						op_item->getRegKind(),
+						op_item->getRegNumber());
+				stack_frame->setRegisterValue(slot,
+						(unsigned char *)buffer
+						+ i * slot.size);
 				break;
 			}
 
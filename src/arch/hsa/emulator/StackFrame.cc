@@ -35,9 +35,8 @@ StackFrame::StackFrame(Function *function, WorkItem *work_item,
 	// Set work item
 	this->work_item = work_item;
 
-	// Set the program counter to be pointing to the first entry of the
-	// function
-	pc = function->getFirstEntry();
+	// The program counter points to the first entry of the function
+	pc_index = 0;
 
 	// Allocate register space
 	register_storage = misc::new_unique_array<char>(
@@ -73,7 +72,7 @@ StackFrame::~StackFrame()
 
 void StackFrame::setPc(std::unique_ptr<BrigCodeEntry> pc)
 {
-	this->pc = std::move(pc);
+	pc_index = function->getEntryIndex(pc->getOffset());
 }
 
 
@@ -105,6 +104,7 @@ void StackFrame::Dump(std::ostream &os = std::cout) const
 	os << misc::fmt("  Function: %s,\n", function->getName().c_str());
 
 	// Dump program counter and current instruction
+	BrigCodeEntry *pc = getPc();
 	os << misc::fmt("  Program counter (offset in code section): 0x%x, ",
 			pc->getOffset());
 	pc->Dump(os);
@@ -112,11 +112,17 @@ void StackFrame::Dump(std::ostream &os = std::cout) const
 
 	// Dump Register status
 	os << "  ***** Registers *****\n";
-	for (auto it = function->getRegisterBegin(); 
-			it != function->getRegisterEnd(); it++)
+	for (unsigned kind = 0; kind < 4; kind++)
 	{
-		os << "    ";
-		DumpRegister(it->first, os);
+		for (unsigned i = 0;
+				i < function->getRegisterCount(
+					(BrigRegisterKind) kind);
+				i++)
+		{
+			os << "    ";
+			DumpRegister(AsmService::RegisterToString(
+					(BrigRegisterKind) kind, i), os);
+		}
 	}
 	os << "  ***** ********* *****\n\n";
 
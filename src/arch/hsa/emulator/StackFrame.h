@@ -40,8 +40,9 @@ class StackFrame
 	// The work item that this stack frame belongs to
 	WorkItem *work_item;
 
-	// Pointer to the instruction to be executed
-	std::unique_ptr<BrigCodeEntry> pc;
+	// Index of the instruction to be executed in the code entries of the
+	// function
+	unsigned int pc_index = 0;
 
 	// Function input and output arguments
 	std::map<std::string, std::unique_ptr<Variable>> function_arguments;
@@ -61,12 +62,10 @@ class StackFrame
 	// All variables declared in private, group and global segment
 	std::map<std::string, std::unique_ptr<Variable>> variables;
 
- 	// Register storage
+ 	// Register storage, laid out as described by the function's register
+	// slots. Control registers use one byte for each 1-bit boolean value.
 	std::unique_ptr<char[]> register_storage;
 
-	// C registers, use a 8 bit char for each 1 bit boolean value
-	unsigned char c_registers[8];
-
 public:
 
 	/// Constructor
@@ -93,12 +92,23 @@ public:
 	/// Return the function
 	Function *getFunction() const { return function; }
 
-	/// Return the program counter
-	BrigCodeEntry *getPc() const { return pc.get(); }
+	/// Return the program counter, or nullptr if it is past the end of
+	/// the function.
+	BrigCodeEntry *getPc() const { return function->getEntry(pc_index); }
 
 	/// Set the program counter
 	void setPc(std::unique_ptr<BrigCodeEntry> pc);
 
+	/// Move the program counter to the next code entry. Return false if
+	/// the program counter was at the last entry of the function.
+	bool MovePcForward()
+	{
+		if (pc_index + 1 >= function->getNumEntries())
+			return false;
+		pc_index++;
+		return true;
+	}
+
 	/// Dump stack frame information
 	void Dump(std::ostream &os) const;
 
@@ -113,52 +123,48 @@ public:
 	/// Dump the information of a register by name
 	void DumpRegister(const std::string &name, std::ostream &os) const;
 
-	/// Return register value
-	void getRegisterValue(const std::string &name, void *buffer) const
+	/// Copy the value of the register in the given slot into \a buffer
+	void getRegisterValue(const Function::RegisterSlot &slot,
+			void *buffer) const
 	{
-		// Do special action for c registers
-		if (name[1] == 'c')
-		{
-			unsigned int index = name[2] - '0';
-			*(unsigned char *)buffer = c_registers[index];
-			return;
-		}
-
-		// Get the offset of the register
-		unsigned int offset = function->getRegisterOffset(name);
-
-		// Get the size of the register
-		unsigned size = AsmService::getSizeInByteByRegisterName(name);
-
-		// Copy the value of the register
-		memcpy(buffer, register_storage.get() + offset, size);
-
-		// Return the value of the register
-		return;
+		memcpy(buffer, register_storage.get() + slot.offset, slot.size);
 	}
 
-	/// Set a registers value
-	void setRegisterValue(const std::string &name, void *value)
+	/// Copy \a value into the register in the given slot
+	void setRegisterValue(const Function::RegisterSlot &slot,
+			const void *value)
 	{
-		// Do special action for c registers
-		if (name[1] == 'c')
-		{
-			unsigned int index = name[2] - '0';
-			c_registers[index] = *(unsigned char *)value;
-			return;
-		}
+		memcpy(register_storage.get() + slot.offset, value, slot.size);
+	}
 
-		// Get the offset of the register
-		unsigned int offset = function->getRegisterOffset(name);
+	/// Return the value of the register of the given kind and number
+	void getRegisterValue(BrigRegisterKind kind, unsigned short number,
+			void *buffer) const
+	{
+		getRegisterValue(function->getRegisterSlot(kind, number),
+				buffer);
+	}
 
-		// Get the size of the register
-		unsigned size = AsmService::getSizeInByteByRegisterName(name);
+	/// Set the value of the register of the given kind and number
+	void setRegisterValue(BrigRegisterKind kind, unsigned short number,
+			const void *value)
+	{
+		setRegisterValue(function->getRegisterSlot(kind, number),
+				value);
+	}
 
-		// Copy the value to the register
-		memcpy(register_storage.get() + offset, value, size);
+	/// Return register value given the register name. This is slower
+	/// than accessing the register by kind and number, and is intended
+	/// for debugging purposes.
+	void getRegisterValue(const std::string &name, void *buffer) const
+	{
+		getRegisterValue(function->getRegisterSlot(name), buffer);
+	}
 
-		// Set the value of the register
-		return;
+	/// Set a register value given the register name
+	void setRegisterValue(const std::string &name, const void *value)
+	{
+		setRegisterValue(function->getRegisterSlot(name), value);
 	}
 
 	/// Start an argument scope, when a '{' appears. Requires the size to
@@ -113,22 +113,15 @@ bool WorkItem::MovePcForwardByOne()
 	// Retrieve the stack top
 	StackFrame *stack_top = stack.back().get();
 
-	// Set the stackframe's pc to the next instuction
-	auto next_pc = stack_top->getPc()->Next();
-
-	// If next pc is beyond last inst, the last instruction of the function
-	// is executed. Return the function.
-	if (!next_pc ||
-		next_pc->getOffset() >
-		stack_top->getFunction()->getLastEntry()->getOffset())
+	// Set the stackframe's pc to the next instuction. If next pc is
+	// beyond last inst, the last instruction of the function is executed.
+	// Return the function.
+	if (!stack_top->MovePcForward())
 	{
 		ReturnFunction();
 		return false;
 	}
 
-	// Set program counter to next instruction
-	stack_top->setPc(std::move(next_pc));
-
 	// Returns true to tell the caller that the function is not returned
 	return true;
 }
@@ -523,122 +516,120 @@ void WorkItem::DeclareVariable()
 }
 
 
-std::unique_ptr<HsaInstructionWorker> WorkItem::getInstructionWorker(
-		BrigCodeEntry *instruction) 
+std::unique_ptr<HsaInstructionWorker> WorkItem::CreateInstructionWorker(
+		BrigOpcode opcode)
 {
-	BrigOpcode opcode = instruction->getOpcode();
-	StackFrame *stack_top = getStackTop();
 	switch(opcode) 
 	{
 	case BRIG_OPCODE_ADD:
 
-		return misc::new_unique<AddInstructionWorker>(this, stack_top);
+		return misc::new_unique<AddInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_AND:
 
-		return misc::new_unique<AndInstructionWorker>(this, stack_top);
+		return misc::new_unique<AndInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_ATOMICNORET:
 
-		return misc::new_unique<AtomicNoRetInstructionWorker>(this,
-				stack_top,
+		return misc::new_unique<AtomicNoRetInstructionWorker>(nullptr,
+				nullptr,
 				Emulator::getInstance()->getMemory());
 
 	case BRIG_OPCODE_BR:
 
-		return misc::new_unique<BrInstructionWorker>(this, stack_top);
+		return misc::new_unique<BrInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_BARRIER:
 
-		return misc::new_unique<BarrierInstructionWorker>(this,
-				stack_top);
+		return misc::new_unique<BarrierInstructionWorker>(nullptr,
+				nullptr);
 
 	case BRIG_OPCODE_CBR:
 
-		return misc::new_unique<CbrInstructionWorker>(this, stack_top);
+		return misc::new_unique<CbrInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_CURRENTWORKGROUPSIZE:
 
 		return misc::new_unique<CurrentWorkGroupSizeInstructionWorker>(
-				this, stack_top);
+				nullptr, nullptr);
 
 	case BRIG_OPCODE_SHL:
 
-		return misc::new_unique<ShlInstructionWorker>(this, stack_top);
+		return misc::new_unique<ShlInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_SHR:
 
-		return misc::new_unique<ShrInstructionWorker>(this, stack_top);
+		return misc::new_unique<ShrInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_CMP:
 
-		return misc::new_unique<CmpInstructionWorker>(this, stack_top);
+		return misc::new_unique<CmpInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_CVT:
 
-		return misc::new_unique<CvtInstructionWorker>(this, stack_top);
+		return misc::new_unique<CvtInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_GRIDSIZE:
 
-		return misc::new_unique<GridSizeInstructionWorker>(this,
-				stack_top);
+		return misc::new_unique<GridSizeInstructionWorker>(nullptr,
+				nullptr);
 
 	case BRIG_OPCODE_LD:
 
-		return misc::new_unique<LdInstructionWorker>(this, stack_top);
+		return misc::new_unique<LdInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_LDA:
 
-		return misc::new_unique<LdaInstructionWorker>(this, stack_top);
+		return misc::new_unique<LdaInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_MAD:
 
-		return misc::new_unique<MadInstructionWorker>(this, stack_top);
+		return misc::new_unique<MadInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_MUL:
 
-		return misc::new_unique<MulInstructionWorker>(this, stack_top);
+		return misc::new_unique<MulInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_MOV:
 
-		return misc::new_unique<MovInstructionWorker>(this, stack_top);
+		return misc::new_unique<MovInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_MEMFENCE:
 
-		return misc::new_unique<MemFenceInstructionWorker>(this,
-				stack_top);
+		return misc::new_unique<MemFenceInstructionWorker>(nullptr,
+				nullptr);
 
 	case BRIG_OPCODE_OR:
 
-		return misc::new_unique<OrInstructionWorker>(this, stack_top);
+		return misc::new_unique<OrInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_ST:
 
-		return misc::new_unique<StInstructionWorker>(this, stack_top);
+		return misc::new_unique<StInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_SUB:
 
-		return misc::new_unique<SubInstructionWorker>(this, stack_top);
+		return misc::new_unique<SubInstructionWorker>(nullptr, nullptr);
 
 
 	case BRIG_OPCODE_RET:
 
-		return misc::new_unique<RetInstructionWorker>(this, stack_top);
+		return misc::new_unique<RetInstructionWorker>(nullptr, nullptr);
 
 	case BRIG_OPCODE_WORKITEMABSID:
 
 		return misc::new_unique<WorkItemAbsIdInstructionWorker>(
-				this, stack_top);
+				nullptr, nullptr);
 
 	case BRIG_OPCODE_WORKITEMID:
 
 		return misc::new_unique<WorkItemIdInstructionWorker>(
-				this, stack_top);
+				nullptr, nullptr);
 
 	case BRIG_OPCODE_WORKGROUPID:
 
 		return misc::new_unique<WorkGroupIdInstructionWorker>(
-				this, stack_top);
+				nullptr, nullptr);
 
 	default:
 		throw misc::Panic(misc::fmt("Opcode %s (%d) not implemented.",
@@ -685,11 +676,10 @@ bool WorkItem::Execute()
 		}
 
 		// Get the function according to the opcode and perform the inst
-		auto instruction_worker = getInstructionWorker(inst);
-		if (instruction_worker.get())
-		{
-			instruction_worker->Execute(inst);
-		}
+		HsaInstructionWorker *instruction_worker = Emulator::getInstance()
+				->getInstructionWorker(inst->getOpcode());
+		instruction_worker->Bind(this, stack_top);
+		instruction_worker->Execute(inst);
 
 		// Return false if execution finished
 		if (stack.empty())
@@ -101,9 +101,6 @@ private:
  	// Process directives befor an instruction
  	void ExecuteDirective();
 
-	// Get HSA instruction worker according to the instruction
-	std::unique_ptr<HsaInstructionWorker> getInstructionWorker(
-			BrigCodeEntry *instruction);
 
 
 
@@ -150,6 +147,11 @@ public:
  	/// Run one instruction for the workitem at the position pointed 
  	bool Execute();
 
+	/// Create the instruction worker that emulates the given opcode. The
+	/// worker is not bound to any work item.
+	static std::unique_ptr<HsaInstructionWorker> CreateInstructionWorker(
+			BrigOpcode opcode);
+
  	/// Move the program counter by one. Return false if current PC is
  	/// at the end of the function
  	virtual bool MovePcForwardByOne();
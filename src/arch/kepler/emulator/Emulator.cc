@@ -46,6 +46,9 @@ std::string Emulator::isa_debug_file;
 // Simulation kind
 comm::Arch::SimKind Emulator::sim_kind = comm::Arch::SimFunctional;
 
+// Number of host threads
+int Emulator::num_threads = 1;
+
 
 
 //
@@ -102,6 +105,120 @@ void Emulator::DumpSummary(std::ostream &os)
 }
 
 
+void Emulator::getThreadBlockId3(Grid *grid, int id, unsigned *id_3d)
+{
+	// Threadblock.X
+	id_3d[0] = id / (grid->getThreadBlockCount3(1) *
+			grid->getThreadBlockCount3(2));
+
+	// Threadblock.Y
+	id_3d[1] = (id % (grid->getThreadBlockCount3(1) *
+			grid->getThreadBlockCount3(2))) /
+			grid->getThreadBlockCount3(2);
+
+	// ThreadBlock.Z
+	id_3d[2] = (id % (grid->getThreadBlockCount3(1) *
+			grid->getThreadBlockCount3(2))) %
+			grid->getThreadBlockCount3(2);
+}
+
+
+long long Emulator::ExecuteThreadBlock(ThreadBlock *thread_block)
+{
+	while (thread_block->getNumWarpsCompletedEmu()
+			!= thread_block->getWarpCount())
+	{
+		for (auto wp_p = thread_block->WarpsBegin(); wp_p <
+				thread_block->WarpsEnd(); ++wp_p)
+		{
+			if ((*wp_p)->getFinishedEmu() || (*wp_p)->getAtBarrier())
+				continue;
+			(*wp_p)->Execute();
+		}
+	}
+	thread_block->setFinishedEmu(true);
+
+	// Count emulated instructions
+	long long num_instructions = 0;
+	for (auto wp_p = thread_block->WarpsBegin(); wp_p <
+			thread_block->WarpsEnd(); ++wp_p)
+		num_instructions += (*wp_p)->getEmuInstCount();
+	return num_instructions;
+}
+
+
+void *Emulator::ThreadBlockWorker(void *arg)
+{
+	Emulator *emulator = (Emulator *) arg;
+	long long num_instructions = 0;
+	while (true)
+	{
+		// Account for the last thread block and pick the next one
+		pthread_mutex_lock(&emulator->thread_block_mutex);
+		emulator->num_alu_instructions += num_instructions;
+		Grid *grid = emulator->dispatch_grid;
+		if (emulator->thread_block_failed ||
+				!grid->getPendThreadBlocksize())
+		{
+			pthread_mutex_unlock(&emulator->thread_block_mutex);
+			return nullptr;
+		}
+		int thread_block_id = emulator->next_thread_block_id++;
+		grid->PopPendingThreadBlock();
+		pthread_mutex_unlock(&emulator->thread_block_mutex);
+
+		// Create the thread block and run it. Errors are recorded and
+		// reported by the main thread.
+		try
+		{
+			unsigned thread_block_id_3d[3];
+			getThreadBlockId3(grid, thread_block_id, thread_block_id_3d);
+			ThreadBlock thread_block(grid, thread_block_id,
+					thread_block_id_3d);
+			num_instructions = emulator->ExecuteThreadBlock(
+					&thread_block);
+		}
+		catch (misc::Exception &e)
+		{
+			pthread_mutex_lock(&emulator->thread_block_mutex);
+			if (!emulator->thread_block_failed)
+			{
+				emulator->thread_block_failed = true;
+				emulator->thread_block_panic =
+						dynamic_cast<misc::Panic *>(&e);
+				emulator->thread_block_error = e.getMessage();
+			}
+			pthread_mutex_unlock(&emulator->thread_block_mutex);
+			return nullptr;
+		}
+	}
+}
+
+
+void Emulator::ExecuteThreadBlocksParallel(Grid *grid)
+{
+	// Initialize dispatcher
+	dispatch_grid = grid;
+	next_thread_block_id = 0;
+	thread_block_failed = false;
+
+	// Launch host threads and wait for them to run out of thread blocks
+	std::vector<pthread_t> threads(num_threads);
+	for (auto &thread : threads)
+		if (pthread_create(&thread, nullptr, ThreadBlockWorker, this))
+			throw misc::Panic("Cannot create host thread");
+	for (auto &thread : threads)
+		pthread_join(thread, nullptr);
+	dispatch_grid = nullptr;
+
+	// Report errors from host threads
+	if (thread_block_failed && thread_block_panic)
+		throw misc::Panic(thread_block_error);
+	if (thread_block_failed)
+		throw Error(thread_block_error);
+}
+
+
 bool Emulator::Run()
 {
 	// Stop emulation if no grids
@@ -122,40 +239,25 @@ bool Emulator::Run()
 	{
 		grid = pending_grids.front();
 		pending_grids.pop_front();
+
+		// Thread blocks are independent, so they can run concurrently
+		if (num_threads > 1)
+		{
+			ExecuteThreadBlocksParallel(grid);
+			finished_grids.push_back(grid);
+			continue;
+		}
+
 		thread_block_id = 0;
 		while (grid->getPendThreadBlocksize())
 		{
-			// Threadblock.X
-			thread_block_3d_id[0] = thread_block_id /
-					(grid->getThreadBlockCount3(1) *
-							grid->getThreadBlockCount3(2));
-
-			// Threadblock.Y
-			thread_block_3d_id[1] = (thread_block_id %
-					(grid->getThreadBlockCount3(1) *
-							grid->getThreadBlockCount3(2))) /
-								grid->getThreadBlockCount3(2);
-
-			// ThreadBlock.Z
-			thread_block_3d_id[2] = ((thread_block_id %
-					(grid->getThreadBlockCount3(1) *
-							grid->getThreadBlockCount3(2))) %
-								grid->getThreadBlockCount3(2))  ;
+			getThreadBlockId3(grid, thread_block_id,
+					thread_block_3d_id);
 			grid->WaitingToRunning(thread_block_id, thread_block_3d_id);
 			thread_block_id ++;
 			thread_block.reset(grid->getRunningThreadBlocksBegin()->release());
-			while (thread_block.get()->getNumWarpsCompletedEmu()
-					!= thread_block.get()->getWarpCount())
-			{
-				for (auto wp_p = thread_block.get()->WarpsBegin(); wp_p <
-					thread_block.get()->WarpsEnd(); ++wp_p)
-				{
-					if ((*wp_p)->getFinishedEmu() || (*wp_p)->getAtBarrier())
-						continue;
-					(*wp_p)->Execute();
-				}
-			}
-			thread_block.get()->setFinishedEmu(true);
+			num_alu_instructions += ExecuteThreadBlock(
+					thread_block.get());
 			grid->PopRunningThreadBlock();
 			thread_block.reset(); // free the memory of thread block
 		}
@@ -171,6 +273,47 @@ bool Emulator::Run()
 }
 
 
+std::unique_ptr<mem::Memory> Emulator::AllocateLocalMemory()
+{
+	std::unique_ptr<mem::Memory> memory;
+	pthread_mutex_lock(&local_memory_mutex);
+	if (!local_memory_pool.empty())
+	{
+		memory = std::move(local_memory_pool.back());
+		local_memory_pool.pop_back();
+	}
+	pthread_mutex_unlock(&local_memory_mutex);
+
+	// Create a new one if the pool is empty
+	if (!memory)
+	{
+		memory = misc::new_unique<mem::Memory>();
+		memory->setSafe(false);
+	}
+	return memory;
+}
+
+
+void Emulator::FreeLocalMemory(std::unique_ptr<mem::Memory> memory)
+{
+	// Pages written by the previous thread block are discarded, so that
+	// the next one starts with zeroed local memory, as before.
+	memory->Clear();
+	pthread_mutex_lock(&local_memory_mutex);
+	local_memory_pool.push_back(std::move(memory));
+	pthread_mutex_unlock(&local_memory_mutex);
+}
+
+
+int Emulator::getNumFreeLocalMemories()
+{
+	pthread_mutex_lock(&local_memory_mutex);
+	int num_free_local_memories = local_memory_pool.size();
+	pthread_mutex_unlock(&local_memory_mutex);
+	return num_free_local_memories;
+}
+
+
 void Emulator::PushPendingGrid(Grid *grid)
 {
 	pending_grids.push_back(grid);
@@ -202,6 +345,14 @@ void Emulator::RegisterOptions()
 	// Option --kpl-debug-isa <kind>
 	command_line->RegisterString("--kpl-debug-isa <file>",isa_debug_file,
 			"Dump debug information about Kepler isa implementation");
+
+	// Option --kpl-threads <num>
+	command_line->RegisterInt32("--kpl-threads <num> (default = 1)",
+			num_threads,
+			"Number of host threads used to emulate the thread "
+			"blocks of a grid concurrently. Thread blocks only "
+			"share global memory, whose accesses are synchronized "
+			"among host threads.");
 }
 
 
@@ -212,6 +363,14 @@ void Emulator::ProcessOptions()
 		throw misc::Error("The detailed Kepler simulation is not currently "
 				"supported in Multi2Sim.");
 
+	// Check number of host threads
+	if (num_threads < 1)
+		throw misc::Error(misc::fmt("Invalid value for --kpl-threads "
+				"(%d)", num_threads));
+	if (num_threads > 1 && !isa_debug_file.empty())
+		throw misc::Error("Option --kpl-debug-isa cannot be used "
+				"with more than one host thread (--kpl-threads)");
+
 	// Set the path for the debug files
 	isa_debug.setPath(isa_debug_file);
 	isa_debug.setPrefix("[Kepler emulator]");
@@ -23,6 +23,7 @@
 #include <iostream>
 #include <list>
 #include <memory>
+#include <pthread.h>
 #include <vector>
 
 #include <arch/common/Arch.h>
@@ -52,6 +53,9 @@ class Emulator : public comm::Emulator
 	// Simulation kind
 	static comm::Arch::SimKind sim_kind;
 
+	// Number of host threads emulating thread blocks concurrently
+	static int num_threads;
+
 	// Emu singleton instance
 	static std::unique_ptr<Emulator> instance;
 
@@ -94,6 +98,51 @@ class Emulator : public comm::Emulator
 	// Number of global memory instructions executed
 	long long num_global_memory_instructions = 0;
 
+	// Global memory mutex, taken when thread blocks run on several host
+	// threads. Reads are exclusive as well, since mem::Memory updates
+	// its last accessed address on every access.
+	pthread_mutex_t global_memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// Constant memory mutex, taken on reads as well for the same reason
+	// when thread blocks run on several host threads
+	pthread_mutex_t constant_memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// Mutex protecting the thread block dispatch fields below, as well as
+	// the instruction counters when thread blocks run concurrently
+	pthread_mutex_t thread_block_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// Grid whose thread blocks are being dispatched to host threads
+	Grid *dispatch_grid = nullptr;
+
+	// Identifier of the next thread block to dispatch
+	int next_thread_block_id = 0;
+
+	// Error raised in a host thread, thrown again in the main thread once
+	// all host threads have finished
+	bool thread_block_failed = false;
+	bool thread_block_panic = false;
+	std::string thread_block_error;
+
+	// Local memories released by finished thread blocks, ready to be
+	// reused by new thread blocks
+	std::vector<std::unique_ptr<mem::Memory>> local_memory_pool;
+
+	// Mutex protecting the local memory pool
+	pthread_mutex_t local_memory_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// Compute the 3D identifier of a thread block from its 1D identifier
+	static void getThreadBlockId3(Grid *grid, int id, unsigned *id_3d);
+
+	// Run all warps of a thread block until completion. Return the number
+	// of instructions emulated.
+	long long ExecuteThreadBlock(ThreadBlock *thread_block);
+
+	// Run all pending thread blocks of a grid on a pool of host threads
+	void ExecuteThreadBlocksParallel(Grid *grid);
+
+	// Entry point of host threads emulating thread blocks
+	static void *ThreadBlockWorker(void *arg);
+
 	/// Constructor
 	Emulator();
 
@@ -224,7 +273,11 @@ public:
 	/// \param data buffer
 	void WriteConstantMemory(unsigned address, unsigned size, const char *buffer)
 	{
+		if (num_threads > 1)
+			pthread_mutex_lock(&constant_memory_mutex);
 		constant_memory->Write(address, size, buffer);
+		if (num_threads > 1)
+			pthread_mutex_unlock(&constant_memory_mutex);
 	}
 
 	/// Write Global Memory
@@ -233,7 +286,11 @@ public:
 	/// \param data buffer
 	void WriteGlobalMemory(unsigned address, unsigned size, const char *buffer)
 	{
+		if (num_threads > 1)
+			pthread_mutex_lock(&global_memory_mutex);
 		global_memory->Write(address, size, buffer);
+		if (num_threads > 1)
+			pthread_mutex_unlock(&global_memory_mutex);
 	}
 
 	/// Read Global Memory
@@ -242,7 +299,11 @@ public:
 	/// \param data buffer
 	void ReadConstantMemory(unsigned address, unsigned size, char *buffer)
 	{
+		if (num_threads > 1)
+			pthread_mutex_lock(&constant_memory_mutex);
 		constant_memory->Read(address, size, buffer);
+		if (num_threads > 1)
+			pthread_mutex_unlock(&constant_memory_mutex);
 	}
 
 	/// Read Global Memory
@@ -251,9 +312,24 @@ public:
 	/// \param data buffer
 	void ReadGlobalMemory(unsigned address, unsigned size, char *buffer)
 	{
+		if (num_threads > 1)
+			pthread_mutex_lock(&global_memory_mutex);
 		global_memory->Read(address, size, buffer);
+		if (num_threads > 1)
+			pthread_mutex_unlock(&global_memory_mutex);
 	}
 
+	/// Return an empty memory to be used as the local memory of a thread
+	/// block, reusing one released by a finished thread block if possible.
+	std::unique_ptr<mem::Memory> AllocateLocalMemory();
+
+	/// Release the local memory of a finished thread block
+	void FreeLocalMemory(std::unique_ptr<mem::Memory> memory);
+
+	/// Return the number of local memories released by finished thread
+	/// blocks and ready to be reused
+	int getNumFreeLocalMemories();
+
 	/// Push an element into pending grid list
 	void PushPendingGrid(Grid *grid);
 
@@ -54,6 +54,20 @@ Grid::Grid(Function *function)
 	}
 	state = GridStateInvalid;
 
+	// Decode all instructions. The first instruction of every group of 8
+	// (PC multiple of 64) contains scheduling information and is not
+	// decoded, see Warp::Execute().
+	instructions.resize(instruction_buffer_size / 8);
+	for (unsigned i = 0; i < instructions.size(); i++)
+	{
+		if (i % 8 == 0)
+			continue;
+		Instruction::Bytes inst_bytes;
+		inst_bytes.as_uint[0] = instruction_buffer[i] >> 32;
+		inst_bytes.as_uint[1] = instruction_buffer[i];
+		instructions[i].Decode((const char *) &inst_bytes, i * 8);
+	}
+
 	//for(int i = 0; i < inst_buffer_size / 8; i++)
 	//	std::cout<<"in function	"<<__FUNCTION__<<
 	//	"the inst_buffer["<<i <<"] is"<<inst_buffer[i]<<std::endl;
@@ -127,4 +141,9 @@ void Grid::PopRunningThreadBlock()
 	running_thread_blocks.pop_front();
 }
 
+void Grid::PopPendingThreadBlock()
+{
+	pending_thread_blocks.pop_front();
+}
+
 }	//namespace
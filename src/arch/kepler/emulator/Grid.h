@@ -20,12 +20,14 @@
 #ifndef ARCH_KEPLER_EMU_GRID_H
 #define ARCH_KEPLER_EMU_GRID_H
 
+#include <cassert>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <vector>
 #include <memory/Memory.h>
 
+#include <arch/kepler/disassembler/Instruction.h>
 #include <arch/kepler/driver/Function.h>
 
 #include "Emulator.h"
@@ -91,6 +93,10 @@ class Grid
 	// Instruction buffer contains the all the instructions in the kernel binary
 	std::vector<unsigned long long> instruction_buffer;
 
+	// Instructions of the kernel, decoded once when the grid is created
+	// and indexed by PC / 8
+	std::vector<Instruction> instructions;
+
 	// Shared memory top pointer
 	unsigned shared_memory_top;
 
@@ -148,6 +154,13 @@ public:
 		return instruction_buffer.begin();
 	}
 
+	/// Get the decoded instruction at the given PC
+	Instruction *getInstruction(unsigned pc)
+	{
+		assert(pc / 8 < instructions.size());
+		return &instructions[pc / 8];
+	}
+
 	/// Get instruction buffer size
 	unsigned getInstructionBufferSize() const
 	{
@@ -196,6 +209,11 @@ public:
 
 	/// pop the front thread block out of running thread block list
 	void PopRunningThreadBlock();
+
+	/// Remove a thread block from the pending list without adding it to
+	/// the running list. Used when the caller creates and owns the thread
+	/// block, such as a host thread emulating thread blocks concurrently.
+	void PopPendingThreadBlock();
 };
 
 }   //namespace
@@ -50,43 +50,18 @@ enum RegValueType
 };
 
 
-// This class includes all kinds of registers used in Thread
+// This class includes the registers private to each Thread. General purpose
+// and predicate registers are kept for the whole warp in class WarpRegisters.
 class Register
 {
 
 private:
 
-	RegValue gpr[256];  /* General purpose registers */
 	RegValue sr[82];  /* Special registers */
-	unsigned pr[8];  /* Predicate registers */
 	CC cc;
 
 public:
 
-	/// Get value of a GPR
-	/// \param vreg GPR identifier
-	unsigned ReadGPR(int gpr_id) const { return gpr[gpr_id].u32; }
-
-	/// Get float type value of a GPR
-	/// \param vreg GPR identifier
-	float ReadFloatGPR(int gpr_id) const { return gpr[gpr_id].f; }
-
-	/// Set value of a GPR
-	/// \param gpr GPR idenfifier
-	/// \param value Value given as an \a unsigned typed value
-	void WriteGPR(int gpr_id, unsigned value)
-	{
-		gpr[gpr_id].u32 = value;
-	}
-
-	/// Set float value of a GPR
-	/// \param gpr GPR idenfifier
-	/// \param value Value given as an \a float typed value
-	void WriteFloatGPR(int gpr_id, float value)
-	{
-		gpr[gpr_id].f = value;
-	}
-
 	/// Get value of a SR
 	/// \param vreg SR identifier
 	unsigned ReadSpecialRegister(int special_register_id)
@@ -102,17 +77,6 @@ public:
 		sr[special_register_id].u32 = value;
 	}
 
-	/// Get value of a predicate register
-	/// \param pr Predicate register identifier
-	int ReadPredicate(int predicate_id) { return pr[predicate_id]; };
-
-	/// Write value of a predicate register
-	/// \param pr predicate register identifier
-	void WritePredicate(int predicate_id, unsigned value)
-	{
-		pr[predicate_id] = value;
-	};
-
 	/// Read value of Condition Code register
 	unsigned ReadCC_ZF() { return cc.zf; };
 
@@ -136,17 +100,95 @@ public:
 
 	/// Write value of Condition register
 	void WriteCC_OF(unsigned value) { cc.of = value; };
+};
+
+
+
+// General purpose and predicate registers of all threads in a warp, stored as
+// a structure of arrays. Each general purpose register is an array with one
+// value per lane, and each predicate register is a mask with one bit per lane,
+// so that warp-level instructions can operate on all lanes at once.
+class WarpRegisters
+{
+public:
+
+	/// Number of lanes
+	static const int NumLanes = 32;
+
+	/// Number of general purpose registers
+	static const int NumGPRs = 256;
+
+	/// Number of predicate registers
+	static const int NumPredicates = 8;
+
+private:
+
+	RegValue gpr[NumGPRs][NumLanes];  /* General purpose registers */
+	unsigned pr[NumPredicates];  /* Predicate registers */
+
+public:
+
+	/// Constructor. All registers are cleared, except for predicate
+	/// register PT (7), which is always true.
+	WarpRegisters()
+	{
+		memset(gpr, 0, sizeof gpr);
+		memset(pr, 0, sizeof pr);
+		pr[7] = ~0u;
+	}
+
+	/// Get value of a GPR in a lane
+	unsigned ReadGPR(int gpr_id, int lane) const
+	{
+		return gpr[gpr_id][lane].u32;
+	}
+
+	/// Get float type value of a GPR in a lane
+	float ReadFloatGPR(int gpr_id, int lane) const
+	{
+		return gpr[gpr_id][lane].f;
+	}
+
+	/// Set value of a GPR in a lane
+	void WriteGPR(int gpr_id, int lane, unsigned value)
+	{
+		gpr[gpr_id][lane].u32 = value;
+	}
+
+	/// Set float value of a GPR in a lane
+	void WriteFloatGPR(int gpr_id, int lane, float value)
+	{
+		gpr[gpr_id][lane].f = value;
+	}
+
+	/// Return the values of a GPR in all lanes
+	RegValue *getGPR(int gpr_id) { return gpr[gpr_id]; }
+
+	/// Get value of a predicate register in a lane
+	int ReadPredicate(int predicate_id, int lane) const
+	{
+		return (pr[predicate_id] >> lane) & 1u;
+	}
+
+	/// Write value of a predicate register in a lane
+	void WritePredicate(int predicate_id, int lane, unsigned value)
+	{
+		if (value)
+			pr[predicate_id] |= 1u << lane;
+		else
+			pr[predicate_id] &= ~(1u << lane);
+	}
 
-	/// Read value of register
-	void Read_register(unsigned *dst, int gpr_id)
+	/// Get the values of a predicate register in all lanes as a bit mask
+	unsigned getPredicateMask(int predicate_id) const
 	{
-		memcpy(dst, &gpr[gpr_id], 4);
+		return pr[predicate_id];
 	}
 
-	/// Write to register
-	void Write_register(unsigned *src, int gpr_id)
+	/// Write the lanes of a predicate register selected by \a mask
+	void WritePredicateMask(int predicate_id, unsigned mask, unsigned value)
 	{
-		memcpy(&gpr[gpr_id], src, 4);
+		pr[predicate_id] = (pr[predicate_id] & ~mask) | (value & mask);
 	}
 };
 
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cstring>
+
 #include "Emulator.h"
 #include "Grid.h"
 #include "Thread.h"
@@ -36,30 +38,25 @@ Thread::Thread(Warp *warp, int id)
 	grid = thread_block->getGrid();
 	this->id = id + thread_block->getId() * grid->getThreadBlockSize();
 	id_in_warp = id % warp_size;
+	warp_registers = warp->getRegisters();
 	id_in_thread_block = id;
 
-	// Local Memory Initialization
-	local_memory = misc::new_unique<mem::Memory>();
-	local_memory->setSafe(false);
+	// Local memory initialization. The local memory of the thread is a
+	// region of the local memory of the thread block, which is only
+	// allocated when first accessed.
 	local_memory_size = 1 << 20; // current 1MB for local memory
-	local_memory_top_address = 0;
-	local_memory_top_generic_address = local_memory_top_address + id *
-			local_memory_size +	emulator->getGlobalMemoryTotalSize() +
+	local_memory_top_address = id * local_memory_size;
+	local_memory_top_generic_address = local_memory_top_address +
+			emulator->getGlobalMemoryTotalSize() +
 			emulator->getSharedMemoryTotalSize();
 
-	// local mem top generic address record in const mem c[0x0][0x24]
-	emulator->WriteConstantMemory(0x24, sizeof(unsigned),
-			(const char *) &local_memory_top_generic_address);
-
 	// Initialization instruction table
 #define DEFINST(_name, _fmt_str, ...) \
 		inst_func[Instruction::INST_##_name] = &Thread::ExecuteInst_##_name;
 #include "../disassembler/Instruction.def"
 #undef DEFINST
 
-	// Initialize  general purpose registers
-	for (int i = 0; i < 256; ++i)
-		WriteGPR(i, 0);
+	// General purpose and predicate registers are initialized by the warp
 
 	// Initialize CC register
 	this->WriteCC_CF(0);
@@ -107,11 +104,6 @@ Thread::Thread(Warp *warp, int id)
 	// Virual Thread Lane ID
 	WriteSpecialRegister(0, id_in_warp);
 
-	// Initialize predicate registers
-	for (int i = 0; i < 7; ++i)
-		WritePredicate(i, 0);
-	WritePredicate(7, 1);
-
 	// Add thread to warp
 	//warp->threads[this->id_in_warp] = this;
 }
@@ -129,6 +121,47 @@ void Thread::ExecuteSpecial()
 }
 
 
+void Thread::ReadLocalMemory(unsigned address, unsigned size, char *buffer)
+{
+	thread_block->getLocalMemory()->Read(address -
+			local_memory_top_generic_address +
+			local_memory_top_address, size, buffer);
+}
+
+
+void Thread::WriteLocalMemory(unsigned address, unsigned size, char *buffer)
+{
+	thread_block->getLocalMemory()->Write(address -
+			local_memory_top_generic_address +
+			local_memory_top_address, size, buffer);
+}
+
+
+void Thread::ReadConstantMemory(unsigned address, unsigned size,
+		char *buffer)
+{
+	emulator->ReadConstantMemory(address, size, buffer);
+
+	// Shared memory top generic address in c[0x0][0x20]
+	const unsigned shared_memory_entry = 0x20;
+	if (address <= shared_memory_entry && address + size >=
+			shared_memory_entry + sizeof(unsigned))
+	{
+		unsigned value = thread_block->getSharedMemoryTopGenericAddress();
+		memcpy(buffer + shared_memory_entry - address, &value,
+				sizeof(unsigned));
+	}
+
+	// Local memory top generic address in c[0x0][0x24]
+	const unsigned local_memory_entry = 0x24;
+	if (address <= local_memory_entry && address + size >=
+			local_memory_entry + sizeof(unsigned))
+		memcpy(buffer + local_memory_entry - address,
+				&local_memory_top_generic_address,
+				sizeof(unsigned));
+}
+
+
 void Thread::ISAUnimplemented(Instruction *inst)
 {
 	throw misc::Panic(misc::fmt("%s: Unimplemented Kepler "
@@ -89,17 +89,18 @@ private:
 	// Registers
 	Register registers;
 
+	// General purpose and predicate registers, stored in the warp
+	WarpRegisters *warp_registers;
+
 	// Last global memory access
 	unsigned global_memory_access_address;
 	unsigned global_memory_access_size;
 
-	// Local Memory
-	std::unique_ptr<mem::Memory> local_memory;
-
 	// Local memory size
 	unsigned local_memory_size; // currently set as 1MB
 
-	// Local memory top local address
+	// Local memory top address in the local memory of the thread block,
+	// shared by all its threads
 	unsigned local_memory_top_address;
 
 	// Local memory top generic address
@@ -146,18 +147,24 @@ public :
 
 	/// Get value of a GPR
 	/// \param vreg GPR identifier
-	unsigned ReadGPR(int gpr_id) { return registers.ReadGPR(gpr_id); }
+	unsigned ReadGPR(int gpr_id)
+	{
+		return warp_registers->ReadGPR(gpr_id, id_in_warp);
+	}
 
 	/// Get float type value of a GPR
 	/// \param vreg GPR identifier
-	float ReadFloatGPR(int gpr_id) { return registers.ReadFloatGPR(gpr_id); }
+	float ReadFloatGPR(int gpr_id)
+	{
+		return warp_registers->ReadFloatGPR(gpr_id, id_in_warp);
+	}
 
 	/// Set value of a GPR
 	/// \param gpr GPR idenfifier
 	/// \param value Value given as an \a unsigned typed value
 	void WriteGPR(int gpr_id, unsigned value)
 	{
-		registers.WriteGPR(gpr_id, value);
+		warp_registers->WriteGPR(gpr_id, id_in_warp, value);
 	}
 
 	/// Set float value of a GPR
@@ -165,7 +172,7 @@ public :
 	/// \param value Value given as an \a float typed value
 	void WriteFloatGPR(int gpr_id, float value)
 	{
-		registers.WriteFloatGPR(gpr_id, value);
+		warp_registers->WriteFloatGPR(gpr_id, id_in_warp, value);
 	}
 
 	/// Get value of a SR
@@ -187,14 +194,14 @@ public :
 	/// \param pr Predicate register identifier
 	int ReadPredicate(int predicate_id)
 	{
-		return registers.ReadPredicate(predicate_id);
+		return warp_registers->ReadPredicate(predicate_id, id_in_warp);
 	}
 
 	/// Write value of a predicate register
 	/// \param pr predicate register identifier
 	void WritePredicate(int pr_id, unsigned value)
 	{
-		registers.WritePredicate(pr_id, value);
+		warp_registers->WritePredicate(pr_id, id_in_warp, value);
 	}
 
 	/// Read value of Condition Code register
@@ -237,16 +244,30 @@ public :
 	/// Execute special instruction
 	void ExecuteSpecial();
 
+	/// Read constant memory as seen by this thread. Entries c[0x0][0x20]
+	/// and c[0x0][0x24] hold the generic addresses of the shared memory
+	/// of the thread block and the local memory of the thread. They are
+	/// provided here instead of being stored in the constant memory shared
+	/// by all thread blocks, which may run concurrently.
+	void ReadConstantMemory(unsigned address, unsigned size, char *buffer);
+
+	/// Read the local memory of the thread given a generic address,
+	/// relative to the base provided in c[0x0][0x24]
+	void ReadLocalMemory(unsigned address, unsigned size, char *buffer);
+
+	/// Write the local memory of the thread given a generic address
+	void WriteLocalMemory(unsigned address, unsigned size, char *buffer);
+
 	/// Read Register
 	void Read_register(unsigned *dst, int gpr_id)
 	{
-		registers.Read_register(dst, gpr_id);
+		*dst = ReadGPR(gpr_id);
 	}
 
 	/// Write Register
 	void Write_register(unsigned *src, int gpr_id)
 	{
-		registers.Write_register(src, gpr_id);
+		WriteGPR(gpr_id, *src);
 	}
 
 };
@@ -79,10 +79,8 @@ ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
 	shared_memory_top_generic_address = shared_memory_top_address + id *
 				shared_memory_size + emulator->getGlobalMemoryTotalSize();
 
-	// Shared memory top generic address is recorded in constant memory
-	// c[0x0][0x20]
-	emulator->WriteConstantMemory(0x20, sizeof(unsigned),
-			(char *) &shared_memory_top_generic_address);
+	// Shared memory top generic address is provided to threads as
+	// constant memory c[0x0][0x20], see Thread::ReadConstantMemory()
 
 	/* Flags */
 	finished_emu = false;
@@ -93,6 +91,21 @@ ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
 	num_warps_completed_timing = 0;
 }
 
+ThreadBlock::~ThreadBlock()
+{
+	if (local_memory)
+		emulator->FreeLocalMemory(std::move(local_memory));
+}
+
+
+mem::Memory *ThreadBlock::getLocalMemory()
+{
+	if (!local_memory)
+		local_memory = emulator->AllocateLocalMemory();
+	return local_memory.get();
+}
+
+
 unsigned ThreadBlock::getWarpCount() const
 {
     return (grid->getThreadBlockSize() + warp_size - 1) /
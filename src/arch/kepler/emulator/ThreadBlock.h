@@ -90,6 +90,9 @@ class ThreadBlock
 	// Shared Memory
 	std::unique_ptr<mem::Memory> shared_memory;
 
+	// Local memory of all threads, allocated on first access
+	std::unique_ptr<mem::Memory> local_memory;
+
 	// Shared memory size. Field initialized in constructor. Currently set as
 	// 16MB
 	unsigned shared_memory_size;
@@ -109,6 +112,10 @@ public:
 	/// \param id Thread-block global 1D ID
 	ThreadBlock(Grid *grid, int id, unsigned *id_3d);
 
+	/// Destructor. The local memory is returned to the emulator to be
+	/// reused by other thread blocks.
+	~ThreadBlock();
+
 	/// Dump thread-block in human readable format into output stream
 	void Dump(std::ostream &os = std::cout) const;
 
@@ -133,6 +140,12 @@ public:
 	/// Get shared memory size
 	unsigned getSharedMemorySize() const { return shared_memory_size; }
 
+	/// Get the generic address of the top of the shared memory
+	unsigned getSharedMemoryTopGenericAddress() const
+	{
+		return shared_memory_top_generic_address;
+	}
+
 	/// Get counter of completed warps
 	unsigned getNumWarpsCompletedEmu() const
 	{
@@ -198,6 +211,11 @@ public:
 		shared_memory->Read(address, length, buffer);
 	}
 
+	/// Return the local memory shared by all threads in the thread block,
+	/// where each thread owns a region of the local memory size. The
+	/// memory is obtained from the emulator on the first call.
+	mem::Memory *getLocalMemory();
+
 	/// Clear barrier flag in all warps of the threadblock
 	/// To continue simulation
 	void clearWarpAtBarrier();
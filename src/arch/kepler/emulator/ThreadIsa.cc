@@ -202,7 +202,6 @@ void Thread::ExecuteInst_IMUL_B(Instruction *inst)
 	Instruction::BytesIMUL format = inst_bytes.imul;
 
 	// Predicates and active masks
-	Emulator *emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned pred;
@@ -246,7 +245,7 @@ void Thread::ExecuteInst_IMUL_B(Instruction *inst)
 		if ((format.op0 == 2) && (format.op2 == 1))
 			src2 = ReadGPR(src2_id);	// Register Mode
 		else if (format.op2 == 0)	// Const mode
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		//else
 		//	src2 = format.src2 >> 18 ? format.src2 | 0xfff80000 : format.src2;
 
@@ -404,7 +403,6 @@ void Thread::ExecuteInst_ISCADD_B(Instruction *inst)
 	Instruction::BytesISCADD format = inst_bytes.iscadd;
 
 	// Get Warp
-	Emulator* emu = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -454,7 +452,7 @@ void Thread::ExecuteInst_ISCADD_B(Instruction *inst)
 
 		// Read src2 value Check it
 		if (format.op2 == 1) // constant mode
-			emu->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		else if (format.op2 == 3)
 		{
 			unsigned src2_id;
@@ -626,7 +624,6 @@ void Thread::ExecuteInst_ISAD_A(Instruction *inst)
 void Thread::ExecuteInst_ISAD_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator *emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -681,7 +678,7 @@ void Thread::ExecuteInst_ISAD_B(Instruction *inst)
 		if (format.op2 == 1) // src2 is const src3 is register
 		{
 			unsigned src3_id;
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 			src3_id = format.src3;
 			src3 = ReadGPR(src3_id);
 		}
@@ -690,7 +687,7 @@ void Thread::ExecuteInst_ISAD_B(Instruction *inst)
 			unsigned src2_id;
 			src2_id = format.src3;
 			src2 = ReadGPR(src2_id);
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src3);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src3);
 		}
 		else if (format.op2 == 3) // both src2 src3 register
 		{
@@ -1040,7 +1037,6 @@ void Thread::ExecuteInst_IMAD(Instruction *inst)
 	Instruction::BytesGeneral0 format = inst_bytes.general0;
 
 	// Predicates and active masks
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned pred;
@@ -1082,7 +1078,7 @@ void Thread::ExecuteInst_IMAD(Instruction *inst)
 		if (format.srcB_mod == 0)
 		{
 			src_id = format.srcB;
-			emulator->ReadConstantMemory(src_id << 2, 4, (char*)&srcB);
+			ReadConstantMemory(src_id << 2, 4, (char*)&srcB);
 		}
 		else if (format.srcB_mod == 1)
 		{
@@ -1264,7 +1260,6 @@ void Thread::ExecuteInst_IADD_A(Instruction *inst)
 void Thread::ExecuteInst_IADD_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	// Determine whether the warp reaches reconvergence pc.
@@ -1321,7 +1316,7 @@ void Thread::ExecuteInst_IADD_B(Instruction *inst)
 			src2 = ReadGPR(src2_id);
 		}
 		else if (format.op2 == 1) // constant mode
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 
 		// Determine least significant bit value for the add
 		unsigned lsb = 0;
@@ -1587,7 +1582,7 @@ void Thread::ExecuteInst_ISET_B(Instruction *inst)
 
 		// Read Src2
 		if (format.op2 == 1) // src is const
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		else if (format.op2 == 3) // src is register mode
 		{
 			// src2 ID
@@ -1670,7 +1665,6 @@ void Thread::ExecuteInst_ISETP_A(Instruction *inst)
 	Instruction::BytesGeneral0 format = inst_bytes.general0;
 
 	// Predicates and active masks
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned pred;
@@ -1719,7 +1713,7 @@ void Thread::ExecuteInst_ISETP_A(Instruction *inst)
 		srcB_id = format.srcB;
 		if (format.srcB_mod == 0)
 		{
-			emulator->ReadConstantMemory(srcB_id << 2, 4, (char*)&srcB);
+			ReadConstantMemory(srcB_id << 2, 4, (char*)&srcB);
 		}
 		else if (format.srcB_mod == 1)
 			srcB = ReadGPR(srcB_id);
@@ -2011,7 +2005,6 @@ void Thread::ExecuteInst_LOP_A(Instruction *inst)
 void Thread::ExecuteInst_LOP_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator *emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -2061,7 +2054,7 @@ void Thread::ExecuteInst_LOP_B(Instruction *inst)
 
 		// Read Src2
 		if ((format.op0 == 2) && (format.op2 == 1 )) // src is const
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		else if ((format.op0 == 2 && format.op2 == 3)) // src is register mode
 		{
 			// src2 ID
@@ -2104,7 +2097,6 @@ void Thread::ExecuteInst_ICMP_A(Instruction *inst)
 void Thread::ExecuteInst_ICMP_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator *emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	// Determine whether the warp reaches reconvergence pc.
@@ -2154,7 +2146,7 @@ void Thread::ExecuteInst_ICMP_B(Instruction *inst)
 		if (format.op2 == 1) // src2 is const src3 is register
 		{
 			unsigned src3_id;
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 			src3_id = format.src3;
 			src3 = ReadGPR(src3_id);
 		}
@@ -2163,7 +2155,7 @@ void Thread::ExecuteInst_ICMP_B(Instruction *inst)
 			unsigned src2_id;
 			src2_id = format.src3;
 			src2 = ReadGPR(src2_id);
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src3);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src3);
 		}
 		else if (format.op2 == 3) // both src2 src3 register
 		{
@@ -2453,7 +2445,6 @@ void Thread::ExecuteInst_MOV_B(Instruction *inst)
 	Instruction::BytesGeneral0 format = inst_bytes.general0;
 
 	// Predicates and active masks
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned pred;
@@ -2491,7 +2482,7 @@ void Thread::ExecuteInst_MOV_B(Instruction *inst)
 		src_id = format.srcB;
 		if (format.srcB_mod == 0)
 		{
-			emulator->ReadConstantMemory(src_id << 2, 4, (char*)&src);
+			ReadConstantMemory(src_id << 2, 4, (char*)&src);
 		}
 		else if (format.srcB_mod == 1)
 			//src = ReadGPR(src_id);
@@ -2662,7 +2653,6 @@ void Thread::ExecuteInst_SEL_A(Instruction *inst)
 void Thread::ExecuteInst_SEL_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator *emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -2712,7 +2702,7 @@ void Thread::ExecuteInst_SEL_B(Instruction *inst)
 
 		// Read Src2
 		if ((format.op0 == 2) && (format.op2 == 1 )) // src is const
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		else if ((format.op0 == 2 && format.op2 == 3)) // src is register mode
 		{
 			// src2 ID
@@ -2817,7 +2807,6 @@ void Thread::ExecuteInst_I2F_A(Instruction *inst)
 void Thread::ExecuteInst_I2F_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -2864,7 +2853,7 @@ void Thread::ExecuteInst_I2F_B(Instruction *inst)
 	{
 
 		if ((format.op0 == 2) && (format.op2 == 1 )) // src is const
-			emulator->ReadConstantMemory(format.src << 2, 4, (char*)&src);
+			ReadConstantMemory(format.src << 2, 4, (char*)&src);
 		else if ((format.op0 == 2 && format.op2 == 3)) // src is register mode
 		{
 			// src2 ID
@@ -2973,7 +2962,6 @@ void Thread::ExecuteInst_I2I_A(Instruction *inst)
 void Thread::ExecuteInst_I2I_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -3019,7 +3007,7 @@ void Thread::ExecuteInst_I2I_B(Instruction *inst)
 	{
 
 		if ((format.op0 == 2) && (format.op2 == 1 )) // src is const
-			emulator->ReadConstantMemory(format.src << 2, 4, (char*)&src);
+			ReadConstantMemory(format.src << 2, 4, (char*)&src);
 		else if ((format.op0 == 2 && format.op2 == 3)) // src is register mode
 		{
 			// src2 ID
@@ -3144,7 +3132,6 @@ void Thread::ExecuteInst_F2I_A(Instruction *inst)
 void Thread::ExecuteInst_F2I_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -3192,7 +3179,7 @@ void Thread::ExecuteInst_F2I_B(Instruction *inst)
 	{
 
 		if ((format.op0 == 2) && (format.op2 == 1 )) // src is const
-			emulator->ReadConstantMemory(format.src << 2, 4, (char*)&src);
+			ReadConstantMemory(format.src << 2, 4, (char*)&src);
 		else if ((format.op0 == 2 && format.op2 == 3)) // src is register mode
 		{
 			// src ID
@@ -3243,7 +3230,6 @@ void Thread::ExecuteInst_F2F_A(Instruction *inst)
 void Thread::ExecuteInst_F2F_B(Instruction *inst)
 {
 	// Get Warp
-	Emulator* emulator = Emulator::getInstance();
 	SyncStack* stack = warp->getSyncStack()->get();
 
 	unsigned active;
@@ -3290,7 +3276,7 @@ void Thread::ExecuteInst_F2F_B(Instruction *inst)
 	{
 
 		if (format.op2 == 1) // src is const
-			emulator->ReadConstantMemory(format.src << 2, 4, (char*)&src);
+			ReadConstantMemory(format.src << 2, 4, (char*)&src);
 		else if (format.op2 == 3) // src is register mode
 		{
 			// src ID
@@ -3401,10 +3387,7 @@ void Thread::ExecuteInst_LD(Instruction *inst)
 		if (addr > (emulator->getGlobalMemoryTotalSize() +
 						emulator->getSharedMemoryTotalSize())) // Local Memory
 		{
-			unsigned local_mem_addr = addr - emulator->getGlobalMemoryTotalSize()
-					- emulator->getSharedMemoryTotalSize() -
-							id * local_memory_size;
-			local_memory->Read(local_mem_addr, 4, (char*)dst);
+			ReadLocalMemory(addr, 4, (char*)dst);
 		}
 		else if (addr > emulator->getGlobalMemoryTotalSize()) // Shared  Memory
 		{
@@ -3423,11 +3406,7 @@ void Thread::ExecuteInst_LD(Instruction *inst)
 			if (addr > (emulator->getGlobalMemoryTotalSize() +
 							emulator->getSharedMemoryTotalSize()))
 			{
-				unsigned local_mem_addr = addr -
-						emulator->getGlobalMemoryTotalSize() -
-							emulator->getSharedMemoryTotalSize() - id *
-								local_memory_size;
-				local_memory->Read(local_mem_addr + 4, 4, (char*)&dst[1]);
+				ReadLocalMemory(addr + 4, 4, (char*)&dst[1]);
 			}
 			else if (addr > emulator->getGlobalMemoryTotalSize())
 			{
@@ -3447,11 +3426,7 @@ void Thread::ExecuteInst_LD(Instruction *inst)
 			if (addr > (emulator->getGlobalMemoryTotalSize() +
 							emulator->getSharedMemoryTotalSize()))
 			{
-				unsigned local_mem_addr = addr -
-						emulator->getGlobalMemoryTotalSize() -
-							emulator->getSharedMemoryTotalSize() - id *
-								local_memory_size;
-				local_memory->Read(local_mem_addr + 8, 8, (char*)&dst[2]);
+				ReadLocalMemory(addr + 8, 8, (char*)&dst[2]);
 			}
 			else if (addr > emulator->getGlobalMemoryTotalSize())
 			{
@@ -3610,7 +3585,6 @@ void Thread::ExecuteInst_LDC(Instruction *inst)
 	RegValue srcA, srcB, dst;
 
 	// Predicates and active masks
-	Emulator *emulator = Emulator::getInstance();
 
 	SyncStack* stack = warp->getSyncStack()->get();
 
@@ -3656,7 +3630,7 @@ void Thread::ExecuteInst_LDC(Instruction *inst)
 
 			// Caculate mem_addr and read const mem
 			mem_addr = srcB_id2 + srcA.s32 + (srcB_id1 << 16);
-			emulator->ReadConstantMemory(mem_addr, 4, (char*)&srcB.u32);
+			ReadConstantMemory(mem_addr, 4, (char*)&srcB.u32);
 
 			// Execute
 			dst.u32 = srcB.u32;
@@ -3682,7 +3656,7 @@ void Thread::ExecuteInst_LDC(Instruction *inst)
 			mem_addr = srcB_id2 + srcA.s32 + (srcB_id1 << 16);
 
 			// Read the lower 32 bits
-			emulator->ReadConstantMemory(mem_addr, 4, (char*)&srcB.u32);
+			ReadConstantMemory(mem_addr, 4, (char*)&srcB.u32);
 
 			// Execute
 			dst.u32 = srcB.u32;
@@ -3692,7 +3666,7 @@ void Thread::ExecuteInst_LDC(Instruction *inst)
 			WriteGPR(dst_id, dst.u32);
 
 			// Read the upper 32 bits
-			emulator->ReadConstantMemory(mem_addr + 4, 4, (char*)&srcB.u32);
+			ReadConstantMemory(mem_addr + 4, 4, (char*)&srcB.u32);
 
 			// Execute the upper 32 bits
 			dst.u32 = srcB.u32;
@@ -3786,10 +3760,7 @@ void Thread::ExecuteInst_ST(Instruction *inst)
 		if (addr > (emulator->getGlobalMemoryTotalSize() +
 						emulator->getSharedMemoryTotalSize()))
 		{
-			unsigned local_mem_addr = addr - emulator->getGlobalMemoryTotalSize()
-					- emulator->getSharedMemoryTotalSize() -
-								id * local_memory_size;
-			local_memory->Write(local_mem_addr, 4, (char*)src);
+			WriteLocalMemory(addr, 4, (char*)src);
 		}
 		else if (addr > emulator->getGlobalMemoryTotalSize()) // Shared  Memory
 		{
@@ -3808,11 +3779,7 @@ void Thread::ExecuteInst_ST(Instruction *inst)
 			if (addr > (emulator->getGlobalMemoryTotalSize() +
 							emulator->getSharedMemoryTotalSize()))
 			{
-				unsigned local_mem_addr = addr -
-						emulator->getGlobalMemoryTotalSize() -
-							emulator->getSharedMemoryTotalSize() - id *
-								local_memory_size;
-				local_memory->Write(local_mem_addr + 4, 4, (char*)&src[1]);
+				WriteLocalMemory(addr + 4, 4, (char*)&src[1]);
 			}
 			else if (addr > emulator->getGlobalMemoryTotalSize()) // Shared  Memory
 			{
@@ -3833,11 +3800,7 @@ void Thread::ExecuteInst_ST(Instruction *inst)
 			if (addr > (emulator->getGlobalMemoryTotalSize() +
 							emulator->getSharedMemoryTotalSize()))
 			{
-				unsigned local_mem_addr = addr -
-						emulator->getGlobalMemoryTotalSize() -
-							emulator->getSharedMemoryTotalSize() - id *
-								local_memory_size;
-				local_memory->Write(local_mem_addr + 8, 8, (char*)&src[2]);
+				WriteLocalMemory(addr + 8, 8, (char*)&src[2]);
 			}
 			else if (addr > emulator->getGlobalMemoryTotalSize()) // Shared  Memory
 			{
@@ -3973,7 +3936,6 @@ void Thread::ExecuteInst_DADD(Instruction *inst)
 void Thread::ExecuteInst_FMUL(Instruction *inst)
 {
 	// Get emulator
-	Emulator* emulator = Emulator::getInstance();
 
 	// Get Warp
 	SyncStack* stack = warp->getSyncStack()->get();
@@ -4038,7 +4000,7 @@ void Thread::ExecuteInst_FMUL(Instruction *inst)
 
 		if (format.srcB_mod == 0)
 		{
-			emulator->ReadConstantMemory(src_id << 2, 4, (char*)&src2);
+			ReadConstantMemory(src_id << 2, 4, (char*)&src2);
 		}
 		else if (format.srcB_mod == 1 || format.srcB_mod == 2)
 			src2 = ReadFloatGPR(src_id);
@@ -4134,7 +4096,7 @@ void Thread::ExecuteInst_FMUL(Instruction *inst)
 
 		if (format.srcB_mod == 0)
 		{
-			emulator->ReadConstantMemory(src_id << 2, 4, (char*)&src2);
+			ReadConstantMemory(src_id << 2, 4, (char*)&src2);
 		}
 		else if (format.srcB_mod == 1 || format.srcB_mod == 2)
 			src2 = ReadFloatGPR(src_id);
@@ -4169,7 +4131,6 @@ void Thread::ExecuteInst_FADD_A(Instruction *inst)
 void Thread::ExecuteInst_FADD_B(Instruction *inst)
 {
 	// Get emulator
-	Emulator* emulator = Emulator::getInstance();
 
 	// Get Warp
 	SyncStack* stack = warp->getSyncStack()->get();
@@ -4217,7 +4178,7 @@ void Thread::ExecuteInst_FADD_B(Instruction *inst)
 
 		// Read Src2
 		if (format.op2 == 1)
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		else if (format.op2 == 3)
 		{
 			unsigned src2_id;
@@ -4245,7 +4206,7 @@ void Thread::ExecuteInst_FADD_B(Instruction *inst)
 		{
 			if (std::fpclassify(src1) == FP_SUBNORMAL)
 				src1 = 0.0f;
-			if (std::fpclassify(src1) == FP_SUBNORMAL)
+			if (std::fpclassify(src2) == FP_SUBNORMAL)
 				src2 = 0.0f;
 		}
 
@@ -4417,8 +4378,7 @@ void Thread::ExecuteInst_FFMA_B(Instruction *inst)
 		// Read src2 and src3
 		if (format.op2 == 1) // src2 is const src3 is register
 		{
-			Emulator *emulator = Emulator::getInstance();
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 			unsigned src3_id;
 			src3_id = format.src3;
 			src3 = ReadFloatGPR(src3_id);
@@ -4428,8 +4388,7 @@ void Thread::ExecuteInst_FFMA_B(Instruction *inst)
 			unsigned src2_id;
 			src2_id = format.src3; // format.src3 is for register mode
 			src2 = ReadFloatGPR(src2_id);
-			Emulator *emulator = Emulator::getInstance();
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src3);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src3);
 		}
 		else if (format.op2 == 3) // both src2 and src3 are register mode
 		{
@@ -4538,7 +4497,7 @@ void Thread::ExecuteInst_FSET_B(Instruction *inst)
 
 		// Read Src2
 		if (format.op2 == 1) // src is const
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		else if (format.op2 == 3) // src is register mode
 		{
 			// src2 ID
@@ -5040,7 +4999,6 @@ void Thread::ExecuteInst_PLONGJMP(Instruction *inst)
 void Thread::ExecuteInst_SSY(Instruction *inst)
 {
 	// Get emulator
-    Emulator *emulator = Emulator::getInstance();
 
 	// Get synchronization stack
 	SyncStack* stack = warp->getSyncStack()->get();
@@ -5085,7 +5043,7 @@ void Thread::ExecuteInst_SSY(Instruction *inst)
         {
 			// check this
 			if (isconstmem == 1)
-              	emulator->ReadConstantMemory(offset << 2,4, (char*) &address);
+              	ReadConstantMemory(offset << 2,4, (char*) &address);
         }
 
 		stack->push(address,
@@ -5715,10 +5673,9 @@ void Thread::ExecuteInst_SHL_B(Instruction *inst)
 		if (format.op2 == 1) // src2 is constant mode
 		{
 			// Get emulator instance
-			Emulator *emulator = Emulator::getInstance();
 
 			// Read src2
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		}
 		else if (format.op2 == 3) // src2 is register mode
 		{
@@ -5889,10 +5846,9 @@ void Thread::ExecuteInst_SHR_B(Instruction *inst)
 		if (format.op2 == 1) // src2 is const mode
 		{
 			// Get emulator instance
-			Emulator *emulator = Emulator::getInstance();
 
 			// Read src2
-			emulator->ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
+			ReadConstantMemory(format.src2 << 2, 4, (char*)&src2);
 		}
 		else if (format.op2 == 3) // src2 is register mode
 		{
@@ -34,7 +34,7 @@
 namespace Kepler
 {
 
-Warp::Warp(ThreadBlock *thread_block, unsigned id):inst(Instruction())
+Warp::Warp(ThreadBlock *thread_block, unsigned id)
 {
 
 	unsigned am = 0;
@@ -115,26 +115,16 @@ void Warp::Dump(std::ostream &os) const
 
 void Warp::Execute()
 {
-	// Get emu instance
-	Emulator *emulator = Emulator::getInstance();
-
-	// Instruction binary
-	Instruction::Bytes inst_bytes;
-
 	// Instruction opcode
 	Instruction::Opcode inst_op;
 
-	// Read instruction binary
-	inst_bytes.as_uint[0] = instruction_buffer[pc / inst_size] >> 32;
-	inst_bytes.as_uint[1] = instruction_buffer[pc / inst_size];
-
-	// Decode instruction
+	// Get the instruction, decoded when the grid was created
 	if( pc % 64)
 	{
-			inst.Decode((const char *) &inst_bytes, pc);
+			Instruction *inst = grid->getInstruction(pc);
 
 			// Execute instruction
-			inst_op = (Instruction::Opcode) inst.getOpcode();
+			inst_op = (Instruction::Opcode) inst->getOpcode();
 
 			if (!inst_op)
 			{
@@ -143,17 +133,63 @@ void Warp::Execute()
 				misc::Panic("Simulation exits with exception.\n");
 			}
 
-			for (auto thread_id = threads_begin; thread_id < threads_end; ++thread_id)
+			// Try a warp-level implementation first
+			bool executed = false;
+			switch (inst_op)
+			{
+			case Instruction::INST_MOV_B:
+				executed = ExecuteInst_MOV_B(inst);
+				break;
+			case Instruction::INST_MOV32I:
+				executed = ExecuteInst_MOV32I(inst);
+				break;
+			case Instruction::INST_IADD32I:
+				executed = ExecuteInst_IADD32I(inst);
+				break;
+			case Instruction::INST_PSETP:
+				executed = ExecuteInst_PSETP(inst);
+				break;
+			case Instruction::INST_IMAD:
+				executed = ExecuteInst_IMAD(inst);
+				break;
+			case Instruction::INST_IADD_A:
+				executed = ExecuteInst_IADD_A(inst);
+				break;
+			case Instruction::INST_IADD_B:
+				executed = ExecuteInst_IADD_B(inst);
+				break;
+			case Instruction::INST_ISETP_A:
+				executed = ExecuteInst_ISETP_A(inst);
+				break;
+			case Instruction::INST_ISETP_B:
+				executed = ExecuteInst_ISETP_B(inst);
+				break;
+			case Instruction::INST_FMUL:
+				executed = ExecuteInst_FMUL(inst);
+				break;
+			case Instruction::INST_FADD_B:
+				executed = ExecuteInst_FADD_B(inst);
+				break;
+			case Instruction::INST_FFMA_B:
+				executed = ExecuteInst_FFMA_B(inst);
+				break;
+			default:
+				break;
+			}
+
+			// Otherwise, execute the instruction on each thread
+			for (auto thread_id = threads_begin; !executed &&
+					thread_id < threads_end; ++thread_id)
 			{
 				/*
 				if (thread_id->get()->getId() == 0)
-				std::cerr << inst.getName() << " id " << thread_id->get()->getId()
+				std::cerr << inst->getName() << " id " << thread_id->get()->getId()
 						<< " warp_id " << id << " thread count " << this->thread_count
 						<< " block id " << thread_block->getId()
 						<< " warp count " << thread_block->getWarpCount()
 						<< " pc " << pc << std::endl;
 						*/
-				thread_id->get()->Execute(inst_op,&inst);
+				thread_id->get()->Execute(inst_op, inst);
 			}
 	}
 	else
@@ -182,7 +218,6 @@ void Warp::Execute()
 
     inst_count++;
     emu_inst_count++;
-    emulator->incNumAluInstructions();
     pc = this->target_pc;
 
     if(pc >= instruction_buffer_size - 8)
@@ -29,6 +29,7 @@
 #include <lib/util/bit-map.h>
 
 #include "Grid.h"
+#include "Register.h"
 #include "ReturnAddressStack.h"
 #include "ThreadBlock.h"
 #include "Warp.h"
@@ -87,8 +88,8 @@ class Warp
 	// Target PC for next instruction
 	int target_pc;
 
-	// Current instruction
-	Instruction inst;
+	// General purpose and predicate registers of all threads
+	WarpRegisters registers;
 
 	// Pointer points to the starting position of instruction buffer
 	std::vector<unsigned long long>::iterator instruction_buffer;
@@ -140,6 +141,38 @@ class Warp
 	// past-the-end iterator to the thread-block's thread list.
 	std::vector<std::unique_ptr<Thread>>::iterator threads_end;
 
+	// Pop the synchronization stack if the warp reached a reconvergence
+	// point, and return the mask of threads that execute the current
+	// instruction under the given predicate.
+	unsigned getExecutionMask(unsigned pred_id);
+
+	// Read the 32-bit constant memory operand at the given address into
+	// the lanes of the mask
+	void ReadConstantOperand(unsigned address, unsigned mask,
+			RegValue *values);
+
+	// Emulation of instructions at the warp level, operating on all active
+	// threads at once with the register file in structure-of-arrays form.
+	// Each function returns false if it does not support the particular
+	// form of the instruction, which must then be executed on each thread
+	// with Thread::Execute().
+	bool ExecuteInst_MOV_B(Instruction *inst);
+	bool ExecuteInst_MOV32I(Instruction *inst);
+	bool ExecuteInst_IADD32I(Instruction *inst);
+	bool ExecuteInst_PSETP(Instruction *inst);
+	bool ExecuteInst_IMAD(Instruction *inst);
+	bool ExecuteInst_IADD_A(Instruction *inst);
+	bool ExecuteInst_IADD_B(Instruction *inst);
+	bool ExecuteInst_ISETP_A(Instruction *inst);
+	bool ExecuteInst_ISETP_B(Instruction *inst);
+	bool ExecuteInst_FMUL(Instruction *inst);
+	bool ExecuteInst_FADD_B(Instruction *inst);
+	bool ExecuteInst_FFMA_B(Instruction *inst);
+
+	// Common implementation of ISETP_A and ISETP_B, the latter with an
+	// immediate second operand
+	bool ExecuteISETP(Instruction::BytesGeneral0 format, bool immediate);
+
 public:
 	/// Constructor
 	///
@@ -162,6 +195,9 @@ public:
 	/// Return PC
 	unsigned getPC() const { return pc; }
 
+	/// Return the general purpose and predicate registers of the threads
+	WarpRegisters *getRegisters() { return &registers; }
+
 	/// Return pointer to a thread inside this warp
 	Thread *getThread(int id_in_warp)
 	{
@@ -197,6 +233,9 @@ public:
 	/// Get inst_size
 	int getInstructionSize() const {return inst_size;}
 
+	/// Get the number of instructions emulated by the warp
+	long long getEmuInstCount() const { return emu_inst_count; }
+
 	//////////////////////////////////////////////////////////////
 
 	// Setters
@@ -0,0 +1,587 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2012  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include <lib/cpp/String.h>
+
+#include "Emulator.h"
+#include "Thread.h"
+#include "Warp.h"
+
+
+namespace Kepler
+{
+
+unsigned Warp::getExecutionMask(unsigned pred_id)
+{
+	// Determine whether the warp reaches reconvergence pc. If it is, pop
+	// the synchronization stack top and restore the active mask.
+	SyncStack *stack = getSyncStack()->get();
+	if (pc)
+	{
+		unsigned temp_am;
+		if (stack->pop(pc, temp_am))
+			stack->setActiveMask(temp_am);
+	}
+
+	// Active threads
+	unsigned mask = stack->getActiveMask();
+	if (thread_count < warp_size)
+		mask &= (1u << thread_count) - 1;
+
+	// Predicate
+	if (pred_id <= 7)
+		mask &= registers.getPredicateMask(pred_id);
+	else
+		mask &= ~registers.getPredicateMask(pred_id - 8);
+	return mask;
+}
+
+
+void Warp::ReadConstantOperand(unsigned address, unsigned mask,
+		RegValue *values)
+{
+	// Entries c[0x0][0x20] and c[0x0][0x24] are private to each thread
+	if (address == 0x20 || address == 0x24)
+	{
+		for (unsigned lane = 0; lane < thread_count; lane++)
+			if (mask & (1u << lane))
+				threads_begin[lane]->ReadConstantMemory(address,
+						4, (char *) &values[lane]);
+		return;
+	}
+
+	// Other entries are read once for the whole warp
+	RegValue value;
+	Emulator::getInstance()->ReadConstantMemory(address, 4,
+			(char *) &value);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+		if (mask & (1u << lane))
+			values[lane] = value;
+}
+
+
+// Add two operands in a lane with the .PO and .X modifiers, updating the
+// condition codes of its thread if 'cc' is set
+static unsigned Add(Thread *thread, unsigned src1, unsigned src2,
+		unsigned po, unsigned x, bool cc)
+{
+	// Determine least significant bit value for the add
+	unsigned lsb = 0;
+	if (po == 3)
+		lsb = 1; // .PO Plus one(for averaging)
+	else if (po == 1)
+	{
+		src2 = ~src2; // negate src2
+		lsb = 1;
+	}
+	else if (po == 2)
+	{
+		src1 = ~src1; // negate src1
+		lsb = 1;
+	}
+
+	// Extended precision addition read carry bit
+	if (x == 1)
+		lsb = thread->ReadCC_CF(); // Illegal to combine .PO and .X
+
+	// Execute .PO and .X flag
+	unsigned result = src1 + src2 + lsb;
+	if (!cc)
+		return result;
+
+	// Update zero and sign flags
+	if (x == 1)
+		thread->WriteCC_ZF(result == 0 && thread->ReadCC_ZF());
+	else
+		thread->WriteCC_ZF(result == 0);
+	thread->WriteCC_SF((result >> 31) & 0x1);
+
+	// Update overflow flag (for signed arithmetic)
+	long long of_tmp = (long long) (int) src1 + (int) src2 + lsb;
+	thread->WriteCC_OF(((of_tmp >> 32) & 0x1) ^ ((result >> 31) & 0x1));
+
+	// Update carry flag (for unsigned arithmetic)
+	unsigned long long cf_tmp = (unsigned long long) src1 + src2 + lsb;
+	thread->WriteCC_CF((cf_tmp >> 32) & 0x1);
+	return result;
+}
+
+
+bool Warp::ExecuteInst_MOV_B(Instruction *inst)
+{
+	// Inst bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesGeneral0 format = inst_bytes.general0;
+
+	// Execute
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *dst = registers.getGPR(format.dst);
+	if (format.srcB_mod == 0)
+		ReadConstantOperand(format.srcB << 2, mask, dst);
+	else
+	{
+		RegValue *src = registers.getGPR(format.srcB);
+		for (unsigned lane = 0; lane < thread_count; lane++)
+			if (mask & (1u << lane))
+				dst[lane] = src[lane];
+	}
+
+	target_pc = pc + inst_size;
+
+	if (Emulator::isa_debug)
+		Emulator::isa_debug << misc::fmt("Warp id %x MOV_B op0 %x "
+				"dst %x mod0 %x s %x srcB %x mod1 %x op1 %x "
+				"srcB_mod %x\n", id, format.op0, format.dst,
+				format.mod0, format.s, format.srcB, format.mod1,
+				format.op1, format.srcB_mod);
+	return true;
+}
+
+
+bool Warp::ExecuteInst_MOV32I(Instruction *inst)
+{
+	// Inst bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesImm format = inst_bytes.immediate;
+
+	// Execute
+	unsigned mask = getExecutionMask(format.pred);
+	if (mask && format.s)
+		throw misc::Panic(".S = 1 in Function MOV32I");
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+		if (mask & (1u << lane))
+			dst[lane].u32 = format.imm32;
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_IADD32I(Instruction *inst)
+{
+	// Instruction bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesIADD32I format = inst_bytes.iadd32i;
+
+	// Execute
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *src = registers.getGPR(format.src);
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+		if (mask & (1u << lane))
+			dst[lane].u32 = Add(threads_begin[lane].get(),
+					src[lane].u32, format.imm32, format.po,
+					format.x, true);
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_PSETP(Instruction *inst)
+{
+	// Instruction bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesPSETP format = inst_bytes.psetp;
+
+	// Boolean operations other than and, or, and xor are left to the
+	// per-thread implementation
+	if (format.bool_op0 == 2 || format.bool_op1 == 2)
+		return false;
+
+	// Execute
+	unsigned mask = getExecutionMask(format.pred);
+
+	// Read source predicates for all lanes
+	unsigned srcA = format.pred2 <= 7 ?
+			registers.getPredicateMask(format.pred2) :
+			~registers.getPredicateMask(format.pred2 - 8);
+	unsigned srcB = format.pred3 <= 7 ?
+			registers.getPredicateMask(format.pred3) :
+			~registers.getPredicateMask(format.pred3 - 8);
+	unsigned srcC = format.pred4 <= 7 ?
+			registers.getPredicateMask(format.pred4) :
+			~registers.getPredicateMask(format.pred4 - 8);
+
+	// Execute bool opcode0
+	unsigned temp;
+	if (format.bool_op0 == 0)
+		temp = srcA & srcB;
+	else if (format.bool_op0 == 1)
+		temp = srcA | srcB;
+	else
+		temp = srcA ^ srcB;
+
+	// Execute bool opcode1
+	unsigned dst;
+	if (format.bool_op1 == 0)
+		dst = temp & srcC;
+	else if (format.bool_op1 == 1)
+		dst = temp | srcC;
+	else
+		dst = temp ^ srcC;
+
+	// Write result
+	registers.WritePredicateMask(format.pred0, mask, dst);
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_IMAD(Instruction *inst)
+{
+	// Inst bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesGeneral0 format = inst_bytes.general0;
+
+	// Read operands
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *srcA = registers.getGPR(format.mod0);
+	RegValue *src3 = registers.getGPR(format.mod1 & 0xff);
+	RegValue constant[WarpRegisters::NumLanes];
+	RegValue *srcB = constant;
+	if (format.srcB_mod == 0)
+		ReadConstantOperand(format.srcB << 2, mask, constant);
+	else
+		srcB = registers.getGPR(format.srcB & 0x1ff);
+
+	// Execute
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+		if (mask & (1u << lane))
+			dst[lane].u32 = srcA[lane].u32 * srcB[lane].u32 +
+					src3[lane].u32;
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_IADD_A(Instruction *inst)
+{
+	// Instruction bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesIADD format = inst_bytes.iadd;
+
+	// Sign-extended immediate
+	unsigned src2 = ((format.op1 >> 5) & 1) ?
+			format.src2 | 0xfff80000 : format.src2;
+
+	// Execute
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *src1 = registers.getGPR(format.src1);
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+		if (mask & (1u << lane))
+			dst[lane].u32 = Add(threads_begin[lane].get(),
+					src1[lane].u32, src2, format.po,
+					format.x, format.cc);
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_IADD_B(Instruction *inst)
+{
+	// Instruction bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesIADD format = inst_bytes.iadd;
+
+	// Only register and constant second operands are supported
+	bool register_mode = format.op0 == 2 && format.op2 == 3;
+	if (!register_mode && format.op2 != 1)
+		return false;
+
+	// Read operands
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *src1 = registers.getGPR(format.src1);
+	RegValue constant[WarpRegisters::NumLanes];
+	RegValue *src2 = constant;
+	if (register_mode)
+		src2 = registers.getGPR(format.src2);
+	else
+		ReadConstantOperand(format.src2 << 2, mask, constant);
+
+	// Execute
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+		if (mask & (1u << lane))
+			dst[lane].u32 = Add(threads_begin[lane].get(),
+					src1[lane].u32, src2[lane].u32,
+					format.po, format.x, true);
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteISETP(Instruction::BytesGeneral0 format, bool immediate)
+{
+	// Comparisons other than <, ==, <=, >, !=, and >=, and boolean
+	// operations other than and and or, are left to the per-thread
+	// implementation, as well as forms of ISETP_B without an immediate
+	unsigned cmp_op = ((format.op1 & 0x1) << 2) | (format.mod1 >> 10);
+	unsigned bool_op = (format.mod1 >> 6) & 0x3;
+	if (cmp_op < 1 || cmp_op > 6 || bool_op > 1 ||
+			(immediate && format.srcB_mod != 1))
+		return false;
+
+	// Read second operand
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue constant[WarpRegisters::NumLanes];
+	RegValue *srcB = constant;
+	if (immediate)
+	{
+		int value = format.srcB;
+		if (value >> 18)
+			value |= 0xfff80000;
+		for (unsigned lane = 0; lane < thread_count; lane++)
+			constant[lane].s32 = value;
+	}
+	else if (format.srcB_mod == 0)
+		ReadConstantOperand(format.srcB << 2, mask, constant);
+	else
+		srcB = registers.getGPR(format.srcB);
+
+	// Compare, subtracting the carry flag from the first operand if the
+	// .X modifier is present
+	bool x = !immediate && ((format.mod1 >> 4) & 0x1);
+	RegValue *srcA = registers.getGPR(format.mod0);
+	unsigned result = 0;
+	for (unsigned lane = 0; lane < thread_count; lane++)
+	{
+		if (!(mask & (1u << lane)))
+			continue;
+
+		int a = srcA[lane].u32 - (x ? threads_begin[lane]->ReadCC_CF() :
+				0);
+		int b = srcB[lane].s32;
+		bool cmp_res;
+		if (cmp_op == 1)
+			cmp_res = a < b;
+		else if (cmp_op == 2)
+			cmp_res = a == b;
+		else if (cmp_op == 3)
+			cmp_res = a <= b;
+		else if (cmp_op == 4)
+			cmp_res = a > b;
+		else if (cmp_op == 5)
+			cmp_res = a != b;
+		else
+			cmp_res = a >= b;
+		if (cmp_res)
+			result |= 1u << lane;
+	}
+
+	// Combine with the third predicate
+	unsigned pred_3 = registers.getPredicateMask(format.mod1 & 0x7);
+	if ((format.mod1 >> 3) & 0x1)
+		pred_3 = ~pred_3;
+	unsigned pred_1 = bool_op == 0 ? result & pred_3 : result | pred_3;
+	unsigned pred_2 = bool_op == 0 ? ~result & pred_3 : ~result | pred_3;
+
+	// Write results, unless the destination is PT
+	unsigned pred_id_1 = (format.dst >> 3) & 0x7;
+	unsigned pred_id_2 = format.dst & 0x7;
+	if (pred_id_1 != 7)
+		registers.WritePredicateMask(pred_id_1, mask, pred_1);
+	if (pred_id_2 != 7)
+		registers.WritePredicateMask(pred_id_2, mask, pred_2);
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_ISETP_A(Instruction *inst)
+{
+	return ExecuteISETP(inst->getInstBytes().general0, false);
+}
+
+
+bool Warp::ExecuteInst_ISETP_B(Instruction *inst)
+{
+	return ExecuteISETP(inst->getInstBytes().general0, true);
+}
+
+
+bool Warp::ExecuteInst_FMUL(Instruction *inst)
+{
+	// Instruction bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesGeneral0 format = inst_bytes.general0;
+
+	// Read operands
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *src1 = registers.getGPR(format.mod0);
+	RegValue constant[WarpRegisters::NumLanes];
+	RegValue *src2 = constant;
+	if (format.srcB_mod == 0)
+		ReadConstantOperand(format.srcB << 2, mask, constant);
+	else
+		src2 = registers.getGPR(format.srcB);
+
+	// Execute
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+	{
+		if (!(mask & (1u << lane)))
+			continue;
+
+		// Absolute value and negation modifiers
+		float a = src1[lane].f;
+		float b = src2[lane].f;
+		if ((format.mod1 >> 3) & 0x1)
+			a = fabsf(a);
+		if ((format.mod1 >> 5) & 0x1)
+			a = -a;
+		if ((format.mod1 >> 2) & 0x1)
+			b = fabsf(b);
+		if ((format.mod1 >> 4) & 0x1)
+			b = -b;
+
+		dst[lane].f = a * b;
+	}
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_FADD_B(Instruction *inst)
+{
+	// Instruction bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesFADD format = inst_bytes.fadd;
+
+	// Only register and constant second operands are supported, and
+	// the saturate and condition code modifiers are not
+	if ((format.op2 != 1 && format.op2 != 3) || format.sat || format.cc)
+		return false;
+
+	// Read operands
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *src1 = registers.getGPR(format.src1);
+	RegValue constant[WarpRegisters::NumLanes];
+	RegValue *src2 = constant;
+	if (format.op2 == 1)
+		ReadConstantOperand(format.src2 << 2, mask, constant);
+	else
+		src2 = registers.getGPR(format.src2);
+
+	// Execute
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+	{
+		if (!(mask & (1u << lane)))
+			continue;
+
+		// Absolute value and negation modifiers
+		float a = src1[lane].f;
+		float b = src2[lane].f;
+		if (format.src1_abs)
+			a = fabsf(a);
+		if (format.src1_negate)
+			a = -a;
+		if (format.src2_abs)
+			b = fabsf(b);
+		if (format.src2_negate)
+			b = -b;
+
+		// Flush denormal operands and result to zero
+		if (format.ftz)
+		{
+			if (std::fpclassify(a) == FP_SUBNORMAL)
+				a = 0.0f;
+			if (std::fpclassify(b) == FP_SUBNORMAL)
+				b = 0.0f;
+		}
+		float result = a + b;
+		if (format.ftz && std::fpclassify(result) == FP_SUBNORMAL)
+			result = 0.0f;
+
+		dst[lane].f = result;
+	}
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+
+bool Warp::ExecuteInst_FFMA_B(Instruction *inst)
+{
+	// Instruction bytes format
+	Instruction::Bytes inst_bytes = inst->getInstBytes();
+	Instruction::BytesFFMA format = inst_bytes.ffma;
+
+	// Operand forms 1 to 3 are supported, without the .FMZ and saturate
+	// modifiers
+	if (format.op2 == 0 || format.fmz == 1 || format.sat)
+		return false;
+
+	// Read operands. In form 2, the register of the second operand is
+	// encoded in the field of the third one.
+	unsigned mask = getExecutionMask(format.pred);
+	RegValue *src1 = registers.getGPR(format.src1);
+	RegValue constant[WarpRegisters::NumLanes];
+	RegValue *src2 = constant;
+	RegValue *src3 = constant;
+	if (format.op2 == 1)
+	{
+		ReadConstantOperand(format.src2 << 2, mask, constant);
+		src3 = registers.getGPR(format.src3);
+	}
+	else if (format.op2 == 2)
+	{
+		src2 = registers.getGPR(format.src3);
+		ReadConstantOperand(format.src2 << 2, mask, constant);
+	}
+	else
+	{
+		src2 = registers.getGPR(format.src2);
+		src3 = registers.getGPR(format.src3);
+	}
+
+	// Execute
+	RegValue *dst = registers.getGPR(format.dst);
+	for (unsigned lane = 0; lane < thread_count; lane++)
+	{
+		if (!(mask & (1u << lane)))
+			continue;
+
+		float temp = src1[lane].f * src2[lane].f;
+		float c = src3[lane].f;
+		if (format.negate_ab)
+			temp = -temp;
+		else if (format.negate_c)
+			c = -c;
+		temp += c;
+		dst[lane].f = temp;
+	}
+
+	target_pc = pc + inst_size;
+	return true;
+}
+
+}  // namespace Kepler
@@ -376,19 +376,8 @@ void Context::Wakeup()
 }
 
 
-void Context::Execute()
+void Context::DecodeInst()
 {
-	// Memory permissions should not be checked if the context is executing in
-	// speculative mode. This will prevent guest segmentation faults to occur.
-	bool spec_mode = getState(ContextSpecMode);
-	if (spec_mode)
-		memory->setSafe(false);
-	else
-		memory->setSafeDefault();
-
-	// set PC to the next instruction pointer
-	regs.setPC(next_ip);
-
 	// read 4 bytes mips instruction from memory into buffer
 	char buffer[4];
 
@@ -411,6 +400,43 @@ void Context::Execute()
 
 	// Disassemble
 	inst.Decode(regs.getPC(), buffer_ptr);
+}
+
+
+void Context::Execute()
+{
+	// Memory permissions should not be checked if the context is executing in
+	// speculative mode. This will prevent guest segmentation faults to occur.
+	bool spec_mode = getState(ContextSpecMode);
+	if (spec_mode)
+		memory->setSafe(false);
+	else
+		memory->setSafeDefault();
+
+	// set PC to the next instruction pointer
+	regs.setPC(next_ip);
+
+	// Discard decoded instructions if the code in memory changed
+	if (decoded_inst_cache_version != memory->getCodeVersion())
+	{
+		decoded_inst_cache.clear();
+		decoded_inst_cache_version = memory->getCodeVersion();
+	}
+
+	// Look up the instruction in the decoded instruction cache
+	auto it = decoded_inst_cache.find(regs.getPC());
+	if (it != decoded_inst_cache.end())
+	{
+		inst = it->second;
+		memory->setSafeDefault();
+	}
+	else
+	{
+		DecodeInst();
+		decoded_inst_cache[regs.getPC()] = inst;
+		memory->MarkCode(regs.getPC());
+		memory->MarkCode(regs.getPC() + 3);
+	}
 
 	// Debug
 	if (emulator->isa_debug)
@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <arch/common/CallStack.h>
@@ -129,6 +130,15 @@ class Context
 	// Current emulated instruction
 	Instruction inst;
 
+	// Cache of decoded instructions, indexed by address. The cache is
+	// flushed when the code version of the memory changes.
+	std::unordered_map<unsigned, Instruction> decoded_inst_cache;
+	unsigned long long decoded_inst_cache_version = 0;
+
+	// Fetch and decode the instruction at the program counter into
+	// 'inst'. Called on decoded instruction cache misses.
+	void DecodeInst();
+
 	// LLbit Bit of virtual state used to
 	// specify operation for instructions that provide atomic read-modify-write
 	bool ll_bit;
@@ -51,6 +51,8 @@ const Driver::CallFn Driver::call_fn[CallCodeCount] =
 
 std::string Driver::debug_file;
 
+bool Driver::async_queue = false;
+
 std::unique_ptr<Driver> Driver::instance;
 
 misc::Debug Driver::debug;
@@ -101,6 +103,18 @@ void Driver::RegisterOptions()
 	command_line->RegisterString("--si-debug-driver <file>", debug_file,
 			"Dump debug information for the Southern Islands driver, "
 			"including all ABI calls coming from the runtime.");	
+
+	// Option '--si-async-queue'
+	command_line->RegisterBool("--si-async-queue", async_queue,
+			"Let the host continue after kernel launches, memory "
+			"writes and copies, instead of waiting for each of "
+			"them. ND-Ranges run in launch order, and their "
+			"work-groups are dispatched only after the transfers "
+			"queued before them complete. The OpenCL runtime waits "
+			"for the queue in clFinish(), before memory commands "
+			"that follow a kernel launch, and before signaling a "
+			"completion event. Transfers are only queued in "
+			"detailed simulation.");
 }
 
 
@@ -41,6 +41,10 @@ class Driver : public comm::Driver
 {
 	// Debug file name, as set by user
 	static std::string debug_file;
+
+	// Transfers from the host are queued without suspending the host
+	// context, as set by option '--si-async-queue'
+	static bool async_queue;
 	
 	// Unique instance of singleton
 	static std::unique_ptr<Driver> instance;
@@ -54,6 +58,10 @@ class Driver : public comm::Driver
 	// Indicates whether memory is fused or not
 	bool fused = false;
 
+	// ID of the last ND-Range that received work-groups through the
+	// asynchronous queue, or -1 if none
+	int last_queued_ndrange_id = -1;
+
 	// Enumeration with all ABI call codes. Each entry of Driver.def will
 	// expand into an assignment. For example, entry
 	//
@@ -146,6 +154,9 @@ public:
 	/// Process command-line options
 	static void ProcessOptions();
 
+	/// Return whether host transfers are queued asynchronously
+	static bool isAsyncQueue() { return async_queue; }
+
 
 
 
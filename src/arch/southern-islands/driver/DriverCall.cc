@@ -17,6 +17,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <cassert>
 
 #include <arch/southern-islands/disassembler/Argument.h>
@@ -125,10 +126,13 @@ int Driver::CallMemRead(comm::Context *context,
 		throw Error(misc::fmt("%s: accessing device memory not "
 				"allocated", __FUNCTION__));                                   
 
-	// Read memory from host to device
-	auto buffer = misc::new_unique_array<char>(size);
-	video_memory->Read(device_ptr, size, buffer.get());
-	memory->Write(host_ptr, size, buffer.get());
+	// Read memory from device to host
+	memory->CopyFrom(*video_memory, device_ptr, host_ptr, size);
+
+	// Charge the transfer time to the host context
+	if (Timing::getSimKind() == comm::Arch::SimDetailed)
+		Timing::getInstance()->getDmaEngine()->Transfer(context,
+				DmaEngine::TransferDeviceToHost, size);
 	
 	// Return                                                         
 	return 0; 
@@ -174,9 +178,18 @@ int Driver::CallMemWrite(comm::Context *context,
 		throw Error(misc::fmt("Device not allocated"));
 
 	// Read memory from host to device
-	auto buffer = misc::new_unique_array<char>(size);
-	memory->Read(host_ptr, size, buffer.get());
-	video_memory->Write(device_ptr, size, buffer.get());
+	video_memory->CopyFrom(*memory, host_ptr, device_ptr, size);
+
+	// Charge the transfer time to the host context, or queue the
+	// transfer and let the host continue
+	if (Timing::getSimKind() != comm::Arch::SimDetailed)
+		return 0;
+	DmaEngine *dma_engine = Timing::getInstance()->getDmaEngine();
+	if (async_queue)
+		dma_engine->Enqueue(DmaEngine::TransferHostToDevice, size);
+	else
+		dma_engine->Transfer(context, DmaEngine::TransferHostToDevice,
+				size);
 
 	// Return
 	return 0;
@@ -219,10 +232,19 @@ int Driver::CallMemCopy(comm::Context *context,
 		throw Error(misc::fmt("%s: accessing device memory not "
 				"allocated", __FUNCTION__));                                   
 
-	// Read memory from host to device
-	auto buffer = misc::new_unique_array<char>(size);
-	video_memory->Read(src_ptr, size, buffer.get());
-	video_memory->Write(dest_ptr, size, buffer.get());
+	// Copy memory within the device
+	video_memory->CopyFrom(*video_memory, src_ptr, dest_ptr, size);
+
+	// Charge the copy time to the host context, or queue the copy and let
+	// the host continue. The copy does not use the host link.
+	if (Timing::getSimKind() != comm::Arch::SimDetailed)
+		return 0;
+	DmaEngine *dma_engine = Timing::getInstance()->getDmaEngine();
+	if (async_queue)
+		dma_engine->Enqueue(DmaEngine::TransferDeviceToDevice, size);
+	else
+		dma_engine->Transfer(context, DmaEngine::TransferDeviceToDevice,
+				size);
 
 	// Return
 	return 0;  
@@ -694,6 +716,29 @@ int Driver::CallNDRangeSendWorkGroups(comm::Context *context,
 			work_group_count, work_group_start,                              
 			work_group_start + work_group_count - 1);                        
 
+	// With an asynchronous queue, the host does not wait for an ND-Range
+	// before launching the next one. ND-Ranges run in the order in which
+	// they receive their first work-groups.
+	if (async_queue && ndrange_id != last_queued_ndrange_id)
+	{
+		ndrange->setWaitNDRangeId(last_queued_ndrange_id);
+		last_queued_ndrange_id = ndrange_id;
+		debug << misc::fmt("\tqueued after ndrange %d\n",
+				ndrange->getWaitNDRangeId());
+	}
+
+	// With an asynchronous queue, the work-groups cannot be dispatched
+	// before the transfers queued so far reach the device
+	if (async_queue && Timing::getSimKind() == comm::Arch::SimDetailed)
+	{
+		long long ready_cycle = Timing::getInstance()->getDmaEngine()
+				->getQueueDoneCycle();
+		ndrange->setReadyCycle(std::max(ndrange->getReadyCycle(),
+				ready_cycle));
+		debug << misc::fmt("\tdispatch waits for cycle %lld\n",
+				ready_cycle);
+	}
+
 	// Receive work groups (add them to the waiting queue)               
 	for (unsigned work_group_id = work_group_start;                                   
 			work_group_id < work_group_start + work_group_count;             
@@ -948,5 +993,54 @@ int Driver::CallRuntimeDebug(comm::Context *context,
 	return 0;
 }
 
+
+/// ABI Call 'QueueFinish'
+///
+/// Wait until all transfers queued on the device complete. The host context
+/// is suspended until the DMA link becomes idle. With option
+/// '--si-async-queue', this is the point where the host synchronizes with
+/// the memory writes and copies it issued before. The OpenCL runtime issues
+/// this call after waiting for its queued ND-Ranges with 'NDRangeFinish',
+/// in clFinish(), before a memory command that follows a kernel launch, and
+/// before signaling a completion event.
+///
+/// \return
+///	No return value.
+int Driver::CallQueueFinish(comm::Context *context,
+		mem::Memory *memory,
+		unsigned args_ptr)
+{
+	// Transfers take no time in functional simulation
+	if (Timing::getSimKind() != comm::Arch::SimDetailed)
+		return 0;
+
+	// Wait for the queue to drain
+	DmaEngine *dma_engine = Timing::getInstance()->getDmaEngine();
+	if (dma_engine->isBusy())
+		debug << misc::fmt("\twaiting for queued transfers "
+				"(blocking)\n");
+	dma_engine->Drain(context);
+
+	// Return
+	return 0;
+}
+
+
+/// ABI Call 'QueueIsAsync'
+///
+/// Return whether option '--si-async-queue' is active. If it is, the
+/// OpenCL runtime returns from a kernel launch after sending its
+/// work-groups, and only waits for the ND-Range when the host needs its
+/// results.
+///
+/// \return
+///	1 if the queue is asynchronous, 0 otherwise.
+int Driver::CallQueueIsAsync(comm::Context *context,
+		mem::Memory *memory,
+		unsigned args_ptr)
+{
+	return async_queue;
+}
+
 }  // namepsace SI
 
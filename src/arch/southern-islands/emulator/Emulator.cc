@@ -101,6 +101,10 @@ bool Emulator::Run()
 		// Get NDRange
 		NDRange *ndrange = it->get();
 
+		// Skip ND-Ranges queued behind one that is still running
+		if (!isNDRangeReady(ndrange))
+			continue;
+
 		// Setup WorkGroup pointer
 		WorkGroup *work_group = nullptr;
 		
@@ -429,4 +433,26 @@ NDRange *Emulator::getNDRangeById(unsigned id)
 }
 
 
+bool Emulator::isNDRangeReady(NDRange *ndrange)
+{
+	// Not waiting for any ND-Range
+	int wait_ndrange_id = ndrange->getWaitNDRangeId();
+	if (wait_ndrange_id < 0)
+		return true;
+
+	// The ND-Range queued before is still running. If it was already
+	// freed, it has completed.
+	NDRange *wait_ndrange = getNDRangeById(wait_ndrange_id);
+	if (wait_ndrange && (!wait_ndrange->isWaitingWorkGroupsEmpty() ||
+			!wait_ndrange->isRunningWorkGroupsEmpty()))
+		return false;
+
+	// Stop waiting
+	scheduler_debug << misc::fmt("NDRange %d ready after NDRange %d\n",
+			ndrange->getId(), wait_ndrange_id);
+	ndrange->setWaitNDRangeId(-1);
+	return true;
+}
+
+
 } // SI namespace
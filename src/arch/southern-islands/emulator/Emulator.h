@@ -254,6 +254,11 @@ public:
 	/// \param id ID with which to select and NDRange.
 	NDRange *getNDRangeById(unsigned id);
 
+	/// Return whether the work-groups of an ND-Range can run. An ND-Range
+	/// launched through an asynchronous queue waits until the ND-Range
+	/// queued before it has no waiting or running work-groups left.
+	bool isNDRangeReady(NDRange *ndrange);
+
 	/// Run one iteration of the emulation loop
 	bool Run() override;
 
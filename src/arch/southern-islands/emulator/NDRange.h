@@ -137,6 +137,14 @@ private:
 	// Used by the driver
 	bool last_work_group_sent = false;
 
+	// GPU cycle before which work-groups cannot be dispatched, set when
+	// the ND-Range depends on transfers queued asynchronously
+	long long ready_cycle = 0;
+
+	// ID of the ND-Range queued before this one, which must complete
+	// before this ND-Range is mapped to the GPU, or -1 if none
+	int wait_ndrange_id = -1;
+
 	// Number of work dimensions
 	unsigned work_dim = 0;
 
@@ -450,6 +458,23 @@ public:
 	/// Has the last work group sent
 	bool LastWorkGroupSent() const { return last_work_group_sent; }
 
+	/// Set the GPU cycle before which work-groups of the ND-Range cannot
+	/// be dispatched
+	void setReadyCycle(long long value) { ready_cycle = value; }
+
+	/// Return the GPU cycle before which work-groups of the ND-Range
+	/// cannot be dispatched
+	long long getReadyCycle() const { return ready_cycle; }
+
+	/// Make the ND-Range wait for the ND-Range with the given ID to
+	/// complete before it is mapped to the GPU, or stop waiting if
+	/// \a value is -1
+	void setWaitNDRangeId(int value) { wait_ndrange_id = value; }
+
+	/// Return the ID of the ND-Range that must complete before this one
+	/// is mapped to the GPU, or -1 if none
+	int getWaitNDRangeId() const { return wait_ndrange_id; }
+
 	/// Set const_buf_table
 	void setConstBufferTable(unsigned value) { const_buf_table = value; }
 
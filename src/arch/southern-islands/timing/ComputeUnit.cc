@@ -46,6 +46,14 @@ int ComputeUnit::lds_alloc_size = 64;
 int ComputeUnit::lds_latency = 2;                                                      
 int ComputeUnit::lds_block_size = 64;                                                  
 int ComputeUnit::lds_num_ports = 2; 
+
+esim::ProfileRegion *ComputeUnit::profile_fetch;
+esim::ProfileRegion *ComputeUnit::profile_issue;
+esim::ProfileRegion *ComputeUnit::profile_simd_unit;
+esim::ProfileRegion *ComputeUnit::profile_vector_memory_unit;
+esim::ProfileRegion *ComputeUnit::profile_lds_unit;
+esim::ProfileRegion *ComputeUnit::profile_scalar_unit;
+esim::ProfileRegion *ComputeUnit::profile_branch_unit;
 	
 
 ComputeUnit::ComputeUnit(int index, Gpu *gpu) :
@@ -74,6 +82,23 @@ ComputeUnit::ComputeUnit(int index, Gpu *gpu) :
 		fetch_buffers[i] = misc::new_unique<FetchBuffer>(i, this);
 		simd_units[i] = misc::new_unique<SimdUnit>(this);
 	}
+
+	// Profile regions
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	profile_fetch = esim_engine->RegisterProfileRegion(
+			"SI::ComputeUnit::Fetch");
+	profile_issue = esim_engine->RegisterProfileRegion(
+			"SI::ComputeUnit::Issue");
+	profile_simd_unit = esim_engine->RegisterProfileRegion(
+			"SI::SimdUnit");
+	profile_vector_memory_unit = esim_engine->RegisterProfileRegion(
+			"SI::VectorMemoryUnit");
+	profile_lds_unit = esim_engine->RegisterProfileRegion(
+			"SI::LdsUnit");
+	profile_scalar_unit = esim_engine->RegisterProfileRegion(
+			"SI::ScalarUnit");
+	profile_branch_unit = esim_engine->RegisterProfileRegion(
+			"SI::BranchUnit");
 }
 
 
@@ -661,23 +686,41 @@ void ComputeUnit::Run()
 	assert(active_issue_buffer >= 0 && active_issue_buffer < num_wavefront_pools);
 
 	// SIMDs
-	for (auto &simd_unit : simd_units)
-		simd_unit->Run();
+	{
+		esim::ProfileScope profile(profile_simd_unit);
+		for (auto &simd_unit : simd_units)
+			simd_unit->Run();
+	}
 
 	// Vector memory
-	vector_memory_unit.Run();
+	{
+		esim::ProfileScope profile(profile_vector_memory_unit);
+		vector_memory_unit.Run();
+	}
 
 	// LDS unit
-	lds_unit.Run();
+	{
+		esim::ProfileScope profile(profile_lds_unit);
+		lds_unit.Run();
+	}
 
 	// Scalar unit
-	scalar_unit.Run();
+	{
+		esim::ProfileScope profile(profile_scalar_unit);
+		scalar_unit.Run();
+	}
 
 	// Branch unit
-	branch_unit.Run();
+	{
+		esim::ProfileScope profile(profile_branch_unit);
+		branch_unit.Run();
+	}
 
 	// Issue from the active issue buffer
-	Issue(fetch_buffers[active_issue_buffer].get());
+	{
+		esim::ProfileScope profile(profile_issue);
+		Issue(fetch_buffers[active_issue_buffer].get());
+	}
 
 	// Update visualization in non-active issue buffers
 	for (int i = 0; i < (int) simd_units.size(); i++)
@@ -689,6 +732,7 @@ void ComputeUnit::Run()
 	}
 
 	// Fetch
+	esim::ProfileScope profile(profile_fetch);
 	for (int i = 0; i < num_wavefront_pools; i++)
 		Fetch(fetch_buffers[i].get(), wavefront_pools[i].get());
 }
@@ -22,6 +22,7 @@
 
 #include <list>
 
+#include <lib/esim/Profile.h>
 #include <memory/Module.h>
 
 #include "BranchUnit.h"
@@ -46,6 +47,16 @@ class Gpu;
 /// Class representing one compute unit in the GPU device.
 class ComputeUnit
 {
+	// Profile regions for the stages and execution units of all compute
+	// units
+	static esim::ProfileRegion *profile_fetch;
+	static esim::ProfileRegion *profile_issue;
+	static esim::ProfileRegion *profile_simd_unit;
+	static esim::ProfileRegion *profile_vector_memory_unit;
+	static esim::ProfileRegion *profile_lds_unit;
+	static esim::ProfileRegion *profile_scalar_unit;
+	static esim::ProfileRegion *profile_branch_unit;
+
 	// Fetch an instruction from the given wavefront pool
 	void Fetch(FetchBuffer *fetch_buffer, WavefrontPool *wavefront_pool);
 
@@ -252,6 +263,13 @@ public:
 	// Number of issued LDS instructions
 	long long num_lds_instructions = 0;
 
+	// Number of global memory accesses by individual work-items in
+	// vector memory instructions
+	long long num_vector_memory_work_item_accesses = 0;
+
+	// Number of vector cache accesses after coalescing work-item accesses
+	long long num_vector_memory_cache_accesses = 0;
+
 	// Number of scalar registers being read from
 	long long num_sreg_reads = 0;
 	
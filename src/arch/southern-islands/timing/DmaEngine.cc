@@ -0,0 +1,178 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/String.h>
+
+#include "DmaEngine.h"
+#include "Timing.h"
+
+
+namespace SI
+{
+
+int DmaEngine::latency = 500;
+int DmaEngine::bandwidth = 16;
+int DmaEngine::block_size = 64;
+int DmaEngine::device_bandwidth = 64;
+
+esim::Event *DmaEngine::event_transfer_done;
+
+
+DmaEngine::DmaEngine(Timing *timing) : timing(timing)
+{
+	// Register event in the frequency domain of the GPU
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	event_transfer_done = esim_engine->RegisterEvent(
+			"si_dma_transfer_done",
+			TransferDoneHandler,
+			timing->getFrequencyDomain());
+}
+
+
+void DmaEngine::TransferDoneHandler(esim::Event *event, esim::Frame *frame)
+{
+	// Wake up the host context, if any
+	DmaEngine::Frame *dma_frame = misc::cast<DmaEngine::Frame *>(frame);
+	DmaEngine *dma_engine = dma_frame->dma_engine;
+	dma_engine->num_in_flight--;
+	if (dma_frame->context)
+		dma_frame->context->Wakeup();
+
+	// Wake up the contexts draining the queue once the link is idle
+	if (!dma_engine->num_in_flight)
+	{
+		for (comm::Context *context : dma_engine->draining_contexts)
+			context->Wakeup();
+		dma_engine->draining_contexts.clear();
+	}
+}
+
+
+long long DmaEngine::getTransferCycles(unsigned size)
+{
+	// Every block occupies the link for a whole number of cycles
+	long long num_blocks = (size + block_size - 1) / block_size;
+	long long block_cycles = (block_size + bandwidth - 1) / bandwidth;
+	return num_blocks * block_cycles;
+}
+
+
+long long DmaEngine::getCopyCycles(unsigned size)
+{
+	return (size + device_bandwidth - 1) / device_bandwidth;
+}
+
+
+void DmaEngine::Issue(TransferKind kind, unsigned size,
+		std::shared_ptr<Frame> frame)
+{
+	// Statistics
+	num_transfers[kind]++;
+	num_bytes[kind] += size;
+
+	// A copy within device memory starts when earlier copies release the
+	// device copy path, and completes without crossing the link
+	long long cycle = timing->getCycle();
+	long long done_cycle;
+	if (kind == TransferDeviceToDevice)
+	{
+		long long start_cycle = std::max(cycle, copy_free_cycle);
+		long long copy_cycles = getCopyCycles(size);
+		copy_free_cycle = start_cycle + copy_cycles;
+		num_copy_busy_cycles += copy_cycles;
+		done_cycle = copy_free_cycle;
+	}
+	else
+	{
+		// The transfer starts when the link is released by earlier
+		// transfers
+		long long start_cycle = std::max(cycle, link_free_cycle);
+		long long transfer_cycles = getTransferCycles(size);
+		link_free_cycle = start_cycle + transfer_cycles;
+		num_busy_cycles += transfer_cycles;
+		num_stall_cycles += start_cycle - cycle;
+		done_cycle = link_free_cycle + latency;
+	}
+
+	// Schedule the arrival of the last block
+	queue_done_cycle = std::max(queue_done_cycle, done_cycle);
+	num_in_flight++;
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	esim_engine->Call(event_transfer_done,
+			frame,
+			nullptr,
+			done_cycle - cycle);
+}
+
+
+void DmaEngine::Transfer(comm::Context *context, TransferKind kind,
+		unsigned size)
+{
+	// Suspend the host context until the transfer completes
+	context->Suspend();
+	Issue(kind, size, std::make_shared<Frame>(this, context));
+}
+
+
+void DmaEngine::Enqueue(TransferKind kind, unsigned size)
+{
+	num_queued_transfers++;
+	Issue(kind, size, std::make_shared<Frame>(this, nullptr));
+}
+
+
+void DmaEngine::Drain(comm::Context *context)
+{
+	// Nothing to wait for
+	if (!num_in_flight)
+		return;
+
+	// Suspend until the last transfer completes
+	context->Suspend();
+	draining_contexts.push_back(context);
+}
+
+
+void DmaEngine::DumpReport(std::ostream &os) const
+{
+	os << misc::fmt("[ DMA ]\n\n");
+	os << misc::fmt("HostToDeviceTransfers = %lld\n",
+			num_transfers[TransferHostToDevice]);
+	os << misc::fmt("HostToDeviceBytes = %lld\n",
+			num_bytes[TransferHostToDevice]);
+	os << misc::fmt("DeviceToHostTransfers = %lld\n",
+			num_transfers[TransferDeviceToHost]);
+	os << misc::fmt("DeviceToHostBytes = %lld\n",
+			num_bytes[TransferDeviceToHost]);
+	os << misc::fmt("DeviceToDeviceTransfers = %lld\n",
+			num_transfers[TransferDeviceToDevice]);
+	os << misc::fmt("DeviceToDeviceBytes = %lld\n",
+			num_bytes[TransferDeviceToDevice]);
+	os << misc::fmt("QueuedTransfers = %lld\n", num_queued_transfers);
+	os << misc::fmt("BusyCycles = %lld\n", num_busy_cycles);
+	os << misc::fmt("StallCycles = %lld\n", num_stall_cycles);
+	os << misc::fmt("DeviceCopyBusyCycles = %lld\n", num_copy_busy_cycles);
+	os << misc::fmt("\n\n");
+}
+
+
+}  // namespace SI
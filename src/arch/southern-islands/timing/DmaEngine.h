@@ -0,0 +1,182 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_SOUTHERN_ISLANDS_TIMING_DMA_ENGINE_H
+#define ARCH_SOUTHERN_ISLANDS_TIMING_DMA_ENGINE_H
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include <arch/common/Context.h>
+#include <lib/esim/Engine.h>
+#include <lib/esim/Frame.h>
+
+
+namespace SI
+{
+
+// Forward declarations
+class Timing;
+
+
+/// DMA engine modeling transfers between host and device memory over a
+/// PCIe-like link. Transfers are split into blocks that are serialized on
+/// the link, and the host context issuing a transfer is suspended until its
+/// last block arrives. Transfers can also be queued asynchronously, in which
+/// case the host keeps running and only waits when it explicitly drains the
+/// queue.
+///
+/// Copies within device memory do not cross the link. They are serialized
+/// on a separate copy path limited by the device memory bandwidth, with no
+/// link latency.
+class DmaEngine
+{
+public:
+
+	/// Kind of transfer
+	enum TransferKind
+	{
+		TransferHostToDevice = 0,
+		TransferDeviceToHost,
+		TransferDeviceToDevice,
+		TransferKindCount
+	};
+
+	/// Event frame for a transfer in flight
+	class Frame : public esim::Frame
+	{
+	public:
+
+		/// DMA engine serving the transfer
+		DmaEngine *dma_engine;
+
+		/// Host context waiting for the transfer, or null for a queued
+		/// transfer
+		comm::Context *context;
+
+		/// Constructor
+		Frame(DmaEngine *dma_engine, comm::Context *context) :
+				dma_engine(dma_engine),
+				context(context)
+		{
+		}
+	};
+
+	/// Fixed latency of a transfer in cycles, from the moment its first
+	/// block leaves until it reaches its destination
+	static int latency;
+
+	/// Number of bytes that the link moves per cycle
+	static int bandwidth;
+
+	/// Size of the blocks in which transfers are split
+	static int block_size;
+
+	/// Number of bytes per cycle copied within device memory
+	static int device_bandwidth;
+
+private:
+
+	// Timing simulator that the engine belongs to
+	Timing *timing;
+
+	// Event scheduled when a transfer completes
+	static esim::Event *event_transfer_done;
+
+	// Event handler for transfer completion
+	static void TransferDoneHandler(esim::Event *event,
+			esim::Frame *frame);
+
+	// Cycle when the link becomes free for the next transfer
+	long long link_free_cycle = 0;
+
+	// Cycle when the device copy path becomes free for the next copy
+	long long copy_free_cycle = 0;
+
+	// Cycle when the last transfer issued reaches its destination
+	long long queue_done_cycle = 0;
+
+	// Number of transfers in flight
+	int num_in_flight = 0;
+
+	// Host contexts waiting for all transfers in flight to complete
+	std::vector<comm::Context *> draining_contexts;
+
+	// Statistics
+	long long num_transfers[TransferKindCount] = { };
+	long long num_bytes[TransferKindCount] = { };
+	long long num_busy_cycles = 0;
+	long long num_stall_cycles = 0;
+	long long num_copy_busy_cycles = 0;
+	long long num_queued_transfers = 0;
+
+	// Occupy the link, or the device copy path for a copy within device
+	// memory, with a transfer and schedule its completion event
+	// with the given frame
+	void Issue(TransferKind kind, unsigned size,
+			std::shared_ptr<Frame> frame);
+
+public:
+
+	/// Constructor
+	DmaEngine(Timing *timing);
+
+	/// Return the number of cycles that a transfer of \a size bytes keeps
+	/// the link busy.
+	static long long getTransferCycles(unsigned size);
+
+	/// Return the number of cycles that a copy of \a size bytes within
+	/// device memory keeps the device copy path busy.
+	static long long getCopyCycles(unsigned size);
+
+	/// Start a transfer of \a size bytes on behalf of \a context. The
+	/// context is suspended and woken up when the transfer completes.
+	/// Transfers are served in issue order, so a transfer waits until
+	/// the link is released by earlier ones. Copies within device memory
+	/// only wait for earlier copies.
+	void Transfer(comm::Context *context, TransferKind kind,
+			unsigned size);
+
+	/// Queue a transfer of \a size bytes without suspending any host
+	/// context. The transfer is served in issue order together with
+	/// blocking transfers.
+	void Enqueue(TransferKind kind, unsigned size);
+
+	/// Suspend \a context until all transfers in flight complete. The
+	/// context is not suspended if the link is idle.
+	void Drain(comm::Context *context);
+
+	/// Return the cycle when the last transfer issued reaches its
+	/// destination. Work that depends on queued transfers cannot start
+	/// before this cycle.
+	long long getQueueDoneCycle() const { return queue_done_cycle; }
+
+	/// Return whether there are transfers in flight. The timing simulator
+	/// must keep simulation time running until they complete.
+	bool isBusy() const { return num_in_flight > 0; }
+
+	/// Dump statistics
+	void DumpReport(std::ostream &os) const;
+};
+
+
+}  // namespace SI
+
+#endif
@@ -218,6 +218,9 @@ const std::string Timing::help_message =
 	"      Latency of register file writes in number of cycles.\n"
 	"  WriteBufferSize = <num> (Default = 1)\n"
 	"      Size of the buffer holding register write instructions.\n"
+	"  Coalesce = {t|f} (Default = t)\n"
+	"      Merge the accesses of the work-items of a wavefront to the same\n"
+	"      cache block into one vector cache access.\n"
 	"\n"
 	"Section '[ LDS ]': defines the parameters of the Local Data Share\n"
 	"on each compute unit.\n"
@@ -235,6 +238,22 @@ const std::string Timing::help_message =
 	"      Latency for an access in number of cycles.\n"
 	"  Ports = <num> (Default = 4)\n"
 	"      Number of ports.\n"
+	"\n"
+	"Section '[ DMA ]': parameters of the link used for transfers between\n"
+	"host and device memory. The host context issuing a transfer is\n"
+	"suspended until the transfer completes, unless transfers are queued\n"
+	"asynchronously with option '--si-async-queue'.\n"
+	"\n"
+	"  Latency = <cycles> (Default = 500)\n"
+	"      Latency of a transfer in number of GPU cycles, in addition to\n"
+	"      the time its blocks occupy the link.\n"
+	"  Bandwidth = <bytes> (Default = 16)\n"
+	"      Number of bytes transferred per GPU cycle.\n"
+	"  BlockSize = <bytes> (Default = 64)\n"
+	"      Size of the blocks in which transfers are split.\n"
+	"  DeviceBandwidth = <bytes> (Default = 64)\n"
+	"      Number of bytes per GPU cycle for copies within device memory.\n"
+	"      These copies do not use the link.\n"
 	"\n";
 
 bool Timing::help = false;
@@ -250,6 +269,9 @@ Timing::Timing() : comm::Timing("SouthernIslands")
 	// Create GPU
 	gpu = misc::new_unique<Gpu>();
 
+	// Create DMA engine
+	dma_engine = misc::new_unique<DmaEngine>(this);
+
 	/// Adding the SI related header to the trace
 	trace.Header(misc::fmt("si.init version=\"%d.%d\" "
 			"num_compute_units=%d\n",
@@ -838,6 +860,7 @@ void Timing::ParseConfiguration(misc::IniFile *ini_file)
 					LdsUnit::write_buffer_size);
 
 	// Section [VectorMemUnit]
+	section = "VectorMemUnit";
 	VectorMemoryUnit::width = ini_file->ReadInt(section, "Width",
 					VectorMemoryUnit::width);
 	VectorMemoryUnit::issue_buffer_size = ini_file->ReadInt(section,
@@ -862,8 +885,36 @@ void Timing::ParseConfiguration(misc::IniFile *ini_file)
 	VectorMemoryUnit::write_buffer_size = ini_file->ReadInt(section,
 					"WriteBufferSize",
 					VectorMemoryUnit::write_buffer_size);
+	VectorMemoryUnit::coalesce = ini_file->ReadBool(section,
+					"Coalesce",
+					VectorMemoryUnit::coalesce);
 
 	// TODO Section [LDS]
+
+	// Section [DMA]
+	section = "DMA";
+	DmaEngine::latency = ini_file->ReadInt(section, "Latency",
+					DmaEngine::latency);
+	DmaEngine::bandwidth = ini_file->ReadInt(section, "Bandwidth",
+					DmaEngine::bandwidth);
+	DmaEngine::block_size = ini_file->ReadInt(section, "BlockSize",
+					DmaEngine::block_size);
+	DmaEngine::device_bandwidth = ini_file->ReadInt(section,
+			"DeviceBandwidth", DmaEngine::device_bandwidth);
+	if (DmaEngine::latency < 0)
+		throw Error(misc::fmt("%s: The value for 'Latency' in section "
+				"[DMA] cannot be negative.\n",
+				ini_file->getPath().c_str()));
+	if (DmaEngine::bandwidth < 1 || DmaEngine::block_size < 1)
+		throw Error(misc::fmt("%s: The values for 'Bandwidth' and "
+				"'BlockSize' in section [DMA] must be at "
+				"least 1.\n",
+				ini_file->getPath().c_str()));
+	if (DmaEngine::device_bandwidth < 1)
+		throw Error(misc::fmt("%s: The value for 'DeviceBandwidth' in "
+				"section [DMA] must be at least 1.\n",
+				ini_file->getPath().c_str()));
+
 	// Enforce only the allowed variables
 	ini_file->Check();
 }
@@ -978,6 +1029,8 @@ void Timing::DumpConfiguration(std::ofstream &os) const
 	os << misc::fmt("WriteLatency = %d\n", VectorMemoryUnit::write_latency);
 	os << misc::fmt("WriteBufferSize = %d\n",
 			VectorMemoryUnit::write_buffer_size);
+	os << misc::fmt("Coalesce = %s\n",
+			VectorMemoryUnit::coalesce ? "True" : "False");
 	os << misc::fmt("\n");
 
 	// LDS
@@ -989,6 +1042,14 @@ void Timing::DumpConfiguration(std::ofstream &os) const
 	os << misc::fmt("Ports = %d\n", ComputeUnit::lds_num_ports);
 	os << misc::fmt("\n");
 
+	// DMA
+	os << misc::fmt("[ Config.DMA ]\n");
+	os << misc::fmt("Latency = %d\n", DmaEngine::latency);
+	os << misc::fmt("Bandwidth = %d\n", DmaEngine::bandwidth);
+	os << misc::fmt("BlockSize = %d\n", DmaEngine::block_size);
+	os << misc::fmt("DeviceBandwidth = %d\n", DmaEngine::device_bandwidth);
+	os << misc::fmt("\n");
+
 	// End of configuration
 	os << misc::fmt("\n");
 	
@@ -1054,6 +1115,9 @@ void Timing::DumpReport() const
 	report << misc::fmt("InstructionsPerCycle = %.4g\n", instructions_per_cycle);             
 	report << misc::fmt("\n\n");                                                      
 
+	// Report for DMA engine
+	dma_engine->DumpReport(report);
+
 	// Report for compute units  
 	for (auto it = gpu->getComputeUnitsBegin(), 
 			e = gpu->getComputeUnitsEnd(); 
@@ -1106,6 +1170,17 @@ void Timing::DumpReport() const
 		report << misc::fmt("LDS.Writes = %lld\n", compute_unit->getLdsModule()->num_writes);              
 		report << misc::fmt("LDS.CoalescedWrites = %lld\n",                       
 				coalesced_writes); 
+		report << misc::fmt("\n");
+		report << misc::fmt("VectorMem.WorkItemAccesses = %lld\n",
+				compute_unit->num_vector_memory_work_item_accesses);
+		report << misc::fmt("VectorMem.CacheAccesses = %lld\n",
+				compute_unit->num_vector_memory_cache_accesses);
+		report << misc::fmt("VectorMem.AccessesPerCacheAccess = %.4g\n",
+				compute_unit->num_vector_memory_cache_accesses ?
+				(double) compute_unit->
+				num_vector_memory_work_item_accesses /
+				compute_unit->num_vector_memory_cache_accesses :
+				0.0);
 		report << misc::fmt("\n\n");                                              
 	}         
 
@@ -1120,9 +1195,10 @@ bool Timing::Run()
 	Emulator *emulator = Emulator::getInstance();
 
 	// For efficiency when no Southern Islands emulation is selected, 
-	// exit here if the list of existing ND-Ranges is empty. 
+	// exit here if the list of existing ND-Ranges is empty. Simulation
+	// time must keep advancing while DMA transfers are in flight.
 	if (!emulator->getNumNDRanges())
-		return false;
+		return dma_engine->isBusy();
 
 	// TODO instead of statically allocating the whole GPU to one NDRange
 	// which wastes the resources, dynamically add the workgroups of
@@ -1136,10 +1212,19 @@ bool Timing::Run()
 		// Get pointer to NDRange
 		NDRange *ndrange = it->get();
 
+		// An ND-Range queued behind one that is still running is not
+		// mapped to the GPU yet
+		if (!emulator->isNDRangeReady(ndrange))
+			continue;
+
 		// Setup WorkGroup pointer
 		WorkGroup *work_group = nullptr;
 
-		if (ndrange->address_space == nullptr)
+		// Map the ND-Range once the host has sent work-groups for it.
+		// With an asynchronous queue, the host may create an ND-Range
+		// while an earlier one is still mapped.
+		if (ndrange->address_space == nullptr &&
+				!ndrange->isWaitingWorkGroupsEmpty())
 		{
 			// TODO the problem is that the NDRange keeps getting
 			// mapped and unmapped since the waitingworkgroups list
@@ -1150,8 +1235,10 @@ bool Timing::Run()
 			gpu->MapNDRange(ndrange);
 		}
 
-		// If the waiting list is not empty
-		if (!ndrange->isWaitingWorkGroupsEmpty())
+		// If the waiting list is not empty and the transfers the
+		// ND-Range depends on have completed
+		if (!ndrange->isWaitingWorkGroupsEmpty() &&
+				getCycle() >= ndrange->getReadyCycle())
 		{
 			// Save the number of waiting work groups
 			unsigned num_waiting_work_groups = ndrange->
@@ -1188,10 +1275,13 @@ bool Timing::Run()
 			}
 		}
 
+		// A completed ND-Range stays in the list until the host frees
+		// it, while ND-Ranges queued after it may already be mapped
 		if (ndrange->isRunningWorkGroupsEmpty() &&
 				ndrange->LastWorkGroupSent())
 		{
-			gpu->UnmapNDRange(ndrange);
+			if (gpu->getNDRange() == ndrange)
+				gpu->UnmapNDRange(ndrange);
 			ndrange->WakeupContext();
 		}
 
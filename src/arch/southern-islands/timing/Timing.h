@@ -26,6 +26,7 @@
 #include <arch/common/Timing.h>
 #include <lib/esim/Trace.h>
 
+#include "DmaEngine.h"
 #include "Gpu.h"
 
 
@@ -75,6 +76,9 @@ class Timing : public comm::Timing
 	// Unique pointer to the gpu object
 	std::unique_ptr<Gpu> gpu;
 
+	// DMA engine for transfers between host and device memory
+	std::unique_ptr<DmaEngine> dma_engine;
+
 	// List of entry modules to the memory hierarchy
 	std::vector<mem::Module *> entry_modules;
 
@@ -185,6 +189,9 @@ public:
 
 	/// Get the pointer to the gpu object
 	Gpu *getGpu() const { return gpu.get(); }
+
+	/// Return the DMA engine
+	DmaEngine *getDmaEngine() const { return dma_engine.get(); }
 };
 
 
@@ -116,9 +116,6 @@ public:
 		// Active after instruction emulation
 		bool active = true;
 
-		// Mark a work item that has successfully made a cache access
-		bool accessed_cache = false;
-
 		// Number of lds_accesses
 		int lds_access_count;
 
@@ -194,6 +191,18 @@ public:
 
 	/// Witness memory access
 	int global_memory_witness = 0;
+
+	/// Physical addresses of the vector cache accesses of a vector memory
+	/// instruction, one per unique cache block accessed by its active
+	/// work-items.
+	std::vector<unsigned> vector_memory_addresses;
+
+	/// Number of entries in \a vector_memory_addresses already submitted
+	/// to the vector cache
+	int num_vector_memory_accesses_issued = 0;
+
+	/// Whether \a vector_memory_addresses has been populated
+	bool vector_memory_coalesced = false;
 	
 	/// Last scalar memory access address
 	unsigned int global_memory_access_address = 0;
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <arch/southern-islands/emulator/Wavefront.h>
 #include <arch/southern-islands/emulator/WorkGroup.h>
 #include <arch/southern-islands/emulator/NDRange.h>
@@ -40,6 +42,7 @@ int VectorMemoryUnit::read_buffer_size = 1;
 int VectorMemoryUnit::max_inflight_mem_accesses = 32;
 int VectorMemoryUnit::write_latency = 1;
 int VectorMemoryUnit::write_buffer_size = 1;
+bool VectorMemoryUnit::coalesce = true;
 
 
 void VectorMemoryUnit::Run()
@@ -80,6 +83,88 @@ void VectorMemoryUnit::Issue(std::unique_ptr<Uop> uop)
 	ExecutionUnit::Issue(std::move(uop));
 }
 
+void VectorMemoryUnit::Coalesce(Uop *uop)
+{
+	// Get compute unit and address space
+	ComputeUnit *compute_unit = getComputeUnit();
+	mem::Mmu *mmu = compute_unit->getGpu()->getMmu();
+	mem::Mmu::Space *address_space = uop->getWorkGroup()->
+			getNDRange()->address_space;
+	Wavefront *wavefront = uop->getWavefront();
+
+	// Mask selecting the cache block of an address. If coalescing is
+	// disabled, every work-item gets its own access.
+	unsigned block_mask = coalesce ?
+			~(compute_unit->vector_cache->getBlockSize() - 1) :
+			~0u;
+
+	// Last translated page
+	unsigned virtual_page = 0;
+	unsigned physical_page = 0;
+	bool page_valid = false;
+
+	// Collect unique block addresses of active work-items
+	assert(!uop->global_memory_witness);
+	assert(uop->vector_memory_addresses.empty());
+	int num_work_item_accesses = 0;
+	for (auto wi_it = wavefront->getWorkItemsBegin(),
+			wi_e = wavefront->getWorkItemsEnd();
+			wi_it != wi_e;
+			++wi_it)
+	{
+		// Skip inactive work-items
+		WorkItem *work_item = wi_it->get();
+		int id_in_wavefront = work_item->getIdInWavefront();
+		if (!wavefront->isWorkItemActive(id_in_wavefront))
+			continue;
+
+		// Translate virtual address, only once per page
+		Uop::WorkItemInfo *work_item_info =
+				&uop->work_item_info_list[id_in_wavefront];
+		unsigned virtual_address =
+				work_item_info->global_memory_access_address;
+		if (!page_valid || (virtual_address & mem::Mmu::PageMask) !=
+				virtual_page)
+		{
+			virtual_page = virtual_address & mem::Mmu::PageMask;
+			physical_page = mmu->TranslateVirtualAddress(
+					address_space,
+					virtual_page);
+			page_valid = true;
+		}
+		unsigned physical_address = physical_page |
+				(virtual_address & ~mem::Mmu::PageMask);
+		unsigned block_address = physical_address & block_mask;
+		num_work_item_accesses++;
+
+		// Add block if not present yet. Consecutive work-items
+		// usually fall in the same block as the last one added.
+		auto &addresses = uop->vector_memory_addresses;
+		if (coalesce && !addresses.empty() &&
+				(addresses.back() & block_mask) == block_address)
+			continue;
+		if (coalesce && std::any_of(addresses.begin(), addresses.end(),
+				[&](unsigned address)
+				{
+					return (address & block_mask) ==
+							block_address;
+				}))
+			continue;
+
+		// Access the block through the address of the first work-item
+		// that touches it.
+		addresses.push_back(physical_address);
+	}
+
+	// Statistics
+	uop->vector_memory_coalesced = true;
+	compute_unit->num_vector_memory_work_item_accesses +=
+			num_work_item_accesses;
+	compute_unit->num_vector_memory_cache_accesses +=
+			uop->vector_memory_addresses.size();
+}
+
+
 void VectorMemoryUnit::Complete()
 {
 	// Get compute unit and GPU objects
@@ -300,12 +385,7 @@ void VectorMemoryUnit::Memory()
 					__FUNCTION__));
 		}
 
-		// This variable keeps track if any work items are unsuccessful
-		// in making an access to the vector cache.
-		bool all_work_items_accessed = true;
-
 		// Access global memory
-		assert(!uop->global_memory_witness);
 		Timing::pipeline_debug << misc::fmt(
 				"\t\t@%lld inst=%lld "
 				"id_in_wf=%lld wg=%d/wf=%d (VecMem)\n",
@@ -314,63 +394,33 @@ void VectorMemoryUnit::Memory()
 				uop->getIdInWavefront(),
 				uop->getWorkGroup()->getId(),
 				uop->getWavefront()->getId());
-		for (auto wi_it = uop->getWavefront()->getWorkItemsBegin(),
-				wi_e = uop->getWavefront()->getWorkItemsEnd();
-				wi_it != wi_e;
-				++wi_it)
-		{
-			// Get work item
-			WorkItem *work_item = wi_it->get();
 
-			// Access memory for each active work-item
-			if (uop->getWavefront()->isWorkItemActive(
-					work_item->getIdInWavefront()))
-			{
-				// Get the work item uop
-				Uop::WorkItemInfo *work_item_info = 
-						&uop->work_item_info_list[
-						work_item->getIdInWavefront()];
-
-				// Check if the work item info struct has
-				// already made a successful vector cache
-				// access. If so, move on to the next work item.
-				if (work_item_info->accessed_cache)	
-					continue;
-
-				// Translate virtual address to a physical 
-				// address
-				unsigned physical_address = compute_unit->
-						getGpu()->
-						getMmu()->
-						TranslateVirtualAddress(
-						uop->getWorkGroup()->
-						getNDRange()->
-						address_space,
-						work_item_info->
-						global_memory_access_address);
-		
+		// Merge the work-item addresses into cache block accesses the
+		// first time the uop is processed
+		if (!uop->vector_memory_coalesced)
+			Coalesce(uop);
 
-				// Make sure we can access the vector cache. If 
-				// so, submit the access. If we can access the
-				// cache, mark the accessed flag of the work 
-				// item info struct.
-				if (compute_unit->vector_cache->
-						canAccess(physical_address))
-				{
-					compute_unit->vector_cache->Access(
-							module_access_type,
-							physical_address, 
-							&uop->global_memory_witness);
-					work_item_info->accessed_cache = true;
-
-					// Access global memory
-					uop->global_memory_witness--;
-				}
-				else
-				{
-					all_work_items_accessed = false;
-				}
+		// Submit pending block accesses to the vector cache, in order,
+		// as long as the cache can take them. Accesses that could not
+		// be submitted are retried next cycle.
+		bool all_work_items_accessed = true;
+		while (uop->num_vector_memory_accesses_issued <
+				(int) uop->vector_memory_addresses.size())
+		{
+			unsigned physical_address = uop->vector_memory_addresses[
+					uop->num_vector_memory_accesses_issued];
+			if (!compute_unit->vector_cache->canAccess(
+					physical_address))
+			{
+				all_work_items_accessed = false;
+				break;
 			}
+			compute_unit->vector_cache->Access(
+					module_access_type,
+					physical_address,
+					&uop->global_memory_witness);
+			uop->global_memory_witness--;
+			uop->num_vector_memory_accesses_issued++;
 		}
 
 		// Make sure that all the work items in the wavefront have 
@@ -44,6 +44,15 @@ class VectorMemoryUnit : public ExecutionUnit
 	// Variable number of register instructions
 	std::deque<std::unique_ptr<Uop>> write_buffer;
 
+	// Translate the addresses of all active work-items of the given uop
+	// and merge them into the list of unique cache block accesses in
+	// Uop::vector_memory_addresses. Virtual addresses are translated
+	// once per page.
+	void Coalesce(Uop *uop);
+
+	// Unit test fixture calling Coalesce() directly
+	friend class CoalesceTest;
+
 public:
 
 	//
@@ -77,6 +86,10 @@ public:
 	/// Size of the write buffer in number of entries
 	static int write_buffer_size;
 
+	/// Whether accesses of work-items in the same wavefront to the same
+	/// cache block are merged into a single vector cache access
+	static bool coalesce;
+
 
 
 
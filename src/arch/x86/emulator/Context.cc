@@ -545,118 +545,61 @@ void Context::DebugCallInst()
 }
 
 
-void Context::HostThreadSuspend()
+void Context::HostWatch()
 {
-	// Get current time
-	esim::Engine *esim = esim::Engine::getInstance();
-	long long now = esim->getRealTime();
-
-	// Detach this thread - we don't want the parent to have to join it to
-	// release its resources. The thread termination can be observed by
-	// atomically checking the 'host_thread_suspend_active' field of the
-	// context.
-	pthread_detach(pthread_self());
+	Reactor *reactor = emulator->getReactor();
 
 	// Suspended in system call 'nanosleep'
 	if (getState(StateNanosleep))
-	{
-		// Calculate remaining sleep time in microseconds
-		long long timeout = syscall_nanosleep_wakeup_time > now ?
-				syscall_nanosleep_wakeup_time - now : 0;
-		usleep(timeout);
-
-	}
+		reactor->Watch(this, -1, 0, syscall_nanosleep_wakeup_time);
 
 	// Suspended in system call 'read'
 	if (getState(StateRead))
 	{
-		// Get file descriptor
 		comm::FileDescriptor *desc = file_table->getFileDescriptor(syscall_read_fd);
 		if (!desc)
 			throw misc::Panic(misc::fmt("Invalid file descriptor "
 					"(%d)", syscall_read_fd));
-
-		// Perform blocking host 'poll'
-		struct pollfd host_fds;
-		host_fds.fd = desc->getHostIndex();
-		host_fds.events = POLLIN;
-		int err = poll(&host_fds, 1, -1);
-		if (err < 0)
-			throw misc::Panic("Unexpected error in host 'poll'");
+		reactor->Watch(this, desc->getHostIndex(), POLLIN, 0);
 	}
 
 	// Suspended in system call 'write'
 	if (getState(StateWrite))
 	{
-		// Get file descriptor
 		comm::FileDescriptor *desc = file_table->getFileDescriptor(syscall_write_fd);
 		if (!desc)
 			throw misc::Panic(misc::fmt("Invalid file descriptor "
 					"(%d)", syscall_write_fd));
-
-		// Perform blocking host 'poll'
-		struct pollfd host_fds;
-		host_fds.fd = desc->getHostIndex();
-		host_fds.events = POLLOUT;
-		int err = poll(&host_fds, 1, -1);
-		if (err < 0)
-			throw misc::Panic("Unexpected error in host 'poll'");
+		reactor->Watch(this, desc->getHostIndex(), POLLOUT, 0);
 	}
 
 	// Suspended in system call 'poll'
 	if (getState(StatePoll))
 	{
-		// Get file descriptor
 		comm::FileDescriptor *desc = file_table->getFileDescriptor(syscall_poll_fd);
 		if (!desc)
 			throw misc::Panic(misc::fmt("Invalid file descriptor "
 					"(%d)", syscall_poll_fd));
-
-		// Calculate timeout for host call in milliseconds from now
-		int timeout;
-		if (!syscall_poll_time)
-			timeout = -1;
-		else if (syscall_poll_time < now)
-			timeout = 0;
-		else
-			timeout = (syscall_poll_time - now) / 1000;
-
-		// Perform blocking host 'poll'
-		struct pollfd host_fds;
-		host_fds.fd = desc->getHostIndex();
-		host_fds.events = ((syscall_poll_events & 4) ? POLLOUT : 0) |
+		int events = ((syscall_poll_events & 4) ? POLLOUT : 0) |
 				((syscall_poll_events & 1) ? POLLIN : 0);
-		int err = poll(&host_fds, 1, timeout);
-		if (err < 0)
-			throw misc::Panic("Unexpected error in host 'poll'");
+		reactor->Watch(this, desc->getHostIndex(), events,
+				syscall_poll_time);
 	}
-
-	// Event occurred - thread finishes
-	emulator->LockMutex();
-	emulator->ProcessEventsScheduleUnsafe();
-	host_thread_suspend_active = false;
-	emulator->UnlockMutex();
 }
 
 
-void Context::HostThreadSuspendCancelUnsafe()
+void Context::HostWatchCancelUnsafe()
 {
-	if (host_thread_suspend_active)
-	{
-		if (pthread_cancel(host_thread_suspend))
-			throw misc::Panic(misc::fmt("[%s] Error "
-					"canceling host thread",
-					getName().c_str()));
-		host_thread_suspend_active = false;
-	}
+	if (emulator->hasReactor())
+		emulator->getReactor()->Cancel(this);
 	emulator->ProcessEventsScheduleUnsafe();
 }
 	
 
-void Context::HostThreadSuspendCancel()
+void Context::HostWatchCancel()
 {
 	emulator->LockMutex();
-	HostThreadSuspendCancelUnsafe();
+	HostWatchCancelUnsafe();
 	emulator->UnlockMutex();
 }
 
@@ -804,6 +747,11 @@ void Context::Execute()
 	// Reset effective address of last emulated instruction
 	last_effective_address = 0;
 
+	// Micro-instructions generated by previous executions of the
+	// instruction can be reused
+	if (uinst_active)
+		LookupUinstTemplates();
+
 	// Debug
 	if (emulator->isa_debug)
 		emulator->isa_debug << misc::fmt("%d %8lld %x: ", getId(),
@@ -891,7 +839,7 @@ void Context::FinishGroup(int exit_code)
 			context->setState(StateFinished);
 		if (context->getState(StateHandler))
 			context->ReturnFromSignalHandler();
-		context->HostThreadSuspendCancel();
+		context->HostWatchCancel();
 		context->HostThreadTimerCancel();
 
 		// Child context of 'context' goes to state 'finished'.
@@ -914,8 +862,8 @@ void Context::Finish(int exit_code)
 	if (getState(StateFinished) || getState(StateZombie))
 		return;
 
-	// If context is waiting for host events, cancel spawned host threads
-	HostThreadSuspendCancel();
+	// If context is waiting for host events, stop watching for them
+	HostWatchCancel();
 	HostThreadTimerCancel();
 
 	// From now on, all children have lost their parent. If a child is
@@ -22,6 +22,8 @@
 
 #include <deque>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <arch/common/CallStack.h>
 #include <arch/common/Context.h>
@@ -232,14 +234,6 @@ private:
 	// Segment size for glibc
 	unsigned glibc_segment_limit = 0;
 
-	// Host thread that suspends and then schedules call to ProcessEvents()
-	// The 'host_thread_suspend_active' flag is set when a 'host_thread_suspend' thread
-	// is launched for this context (by caller).
-	// It is clear when the context finished (by the host thread).
-	// It should be accessed safely by locking the emulator mutex
-	pthread_t host_thread_suspend;  // Thread
-	bool host_thread_suspend_active = false;  // Thread-spawned flag
-
 	// Host thread that lets time elapse and schedules call to
 	// ProcessEvents()
 	pthread_t host_thread_timer;
@@ -273,17 +267,14 @@ private:
 	// Dump debug information about a call instruction
 	void DebugCallInst();
 
-	// Host thread function
-	void HostThreadSuspend();
-	static void *HostThreadSuspend(void *data)
-	{
-		((Context *) data)->HostThreadSuspend();
-		return nullptr;
-	}
-	
-	// Cancel host thread
-	void HostThreadSuspendCancel();
-	void HostThreadSuspendCancelUnsafe();
+	// Ask the emulator reactor to watch for the host event that the
+	// context is suspended on, based on its current state. The reactor
+	// schedules a call to Emulator::ProcessEvents() when it occurs.
+	void HostWatch();
+
+	// Stop watching for host events for the context
+	void HostWatchCancel();
+	void HostWatchCancelUnsafe();
 
 	// Cancel timer thread
 	void HostThreadTimerCancel();
@@ -432,6 +423,51 @@ private:
 	// x86 macro-instruction.
 	std::deque<std::shared_ptr<Uinst>> uinsts;
 
+	// Source of the memory address of a micro-instruction replayed from
+	// a template
+	enum UinstAddress
+	{
+		UinstAddressNone = 0,
+		UinstAddressExplicit,	// Argument of newMemoryUinst()
+		UinstAddressEffective	// Field 'last_effective_address'
+	};
+
+	// Micro-instructions produced by one call to newMemoryUinst(). Since
+	// the expansion only depends on the arguments of the call, the
+	// decoded instruction, and flag 'uinst_effaddr_emitted', it can be
+	// replayed when the same instruction calls the function again with
+	// the same arguments, patching only the memory addresses.
+	struct UinstTemplate
+	{
+		// Arguments of the call
+		Uinst::Opcode opcode;
+		int deps[Uinst::MaxDeps];
+		bool effaddr_emitted;
+
+		// Micro-instructions produced, and source of their addresses
+		std::vector<Uinst> uinsts;
+		std::vector<UinstAddress> addresses;
+
+		// Value of 'uinst_effaddr_emitted' after the call
+		bool effaddr_emitted_after;
+	};
+
+	// Templates recorded for the calls to newMemoryUinst() performed by
+	// the instruction at each address, in order. The cache is flushed
+	// when the code version of the memory changes.
+	std::unordered_map<unsigned, std::vector<UinstTemplate>>
+			uinst_template_cache;
+	unsigned long long uinst_template_cache_version = 0;
+
+	// Templates of the instruction being emulated, and index of the next
+	// call to newMemoryUinst() within them
+	std::vector<UinstTemplate> *uinst_templates = nullptr;
+	int uinst_template_index = 0;
+
+	// Select the micro-instruction templates for the instruction at
+	// 'current_eip' in 'inst'
+	void LookupUinstTemplates();
+
 	// Clear the list of micro-instructions
 	void ClearUinsts()
 	{
@@ -847,6 +883,9 @@ public:
 		return memory.get();
 	}
 
+	/// Return the file descriptor table
+	comm::FileTable *getFileTable() const { return file_table.get(); }
+
 	/// Force a new 'eip' value for the context. The forced value should be
 	/// the same as the current 'eip' under normal circumstances. If it is
 	/// not, speculative execution starts, which will end on the next call
@@ -344,8 +344,8 @@ void Context::SyscallReadWakeup()
 
 bool Context::SyscallReadCanWakeup()
 {
-	// If the host thread is still running for this context, do nothing.
-	if (host_thread_suspend_active)
+	// If the reactor is still watching for this context, do nothing.
+	if (emulator->getReactor()->isWatching(this))
 		return false;
 
 	// Context received a signal
@@ -394,11 +394,8 @@ bool Context::SyscallReadCanWakeup()
 		return true;
 	}
 
-	// Data is not ready. Launch host thread again
-	host_thread_suspend_active = true;
-	if (pthread_create(&host_thread_suspend, nullptr,
-			&Context::HostThreadSuspend, this))
-		throw misc::Panic("Could not launch host thread");
+	// Data is not ready. Watch for it again
+	HostWatch();
 	return false;
 }
 
@@ -473,8 +470,8 @@ void Context::SyscallWriteWakeup()
 
 bool Context::SyscallWriteCanWakeup()
 {
-	// If host thread is still running for this context, do nothing.
-	if (host_thread_suspend_active)
+	// If the reactor is still watching for this context, do nothing.
+	if (emulator->getReactor()->isWatching(this))
 		return false;
 
 	// Context received a signal
@@ -522,11 +519,8 @@ bool Context::SyscallWriteCanWakeup()
 		return true;
 	}
 
-	// Data is not ready to be written - launch host thread again
-	host_thread_suspend_active = true;
-	if (pthread_create(&host_thread_suspend, nullptr,
-			&Context::HostThreadSuspend, this))
-		throw misc::Panic("Could not create child thread");
+	// Data is not ready to be written - watch for it again
+	HostWatch();
 	
 	// Done
 	return false;
@@ -1487,7 +1481,7 @@ int Context::ExecuteSyscall_kill()
 
 	// Send signal
 	context->signal_mask_table.getPending().Add(sig);
-	context->HostThreadSuspendCancel();
+	context->HostWatchCancel();
 	emulator->ProcessEventsSchedule();
 	emulator->ProcessEvents();
 
@@ -2588,8 +2582,10 @@ int Context::SyscallMmapAux(unsigned addr, unsigned len,
 	// Allocation of memory
 	memory->Map(addr, len_aligned, perm);
 
-	// Host mapping
-	if (host_fd >= 0)
+	// Host mapping. Regular files are backed by a host mapping of the
+	// file, populating guest pages on demand.
+	if (host_fd >= 0 && !memory->MapFile(addr, len_aligned, host_fd,
+			offset, (flags & MAP_SHARED) && (prot & PROT_WRITE)))
 	{
 		// Save previous position
 		unsigned last_pos = lseek(host_fd, 0, SEEK_CUR);
@@ -2610,18 +2606,18 @@ int Context::SyscallMmapAux(unsigned addr, unsigned len,
 			curr_addr += mem::Memory::PageSize;
 		}
 
-		// Record map in call stack
-		if (call_stack != nullptr && !desc->getPath().empty())
-			call_stack->Map(desc->getPath(),
-					offset,
-					addr,
-					len,
-					true);
-
 		// Return file to last position
 		lseek(host_fd, last_pos, SEEK_SET);
 	}
 
+	// Record map in call stack
+	if (host_fd >= 0 && call_stack != nullptr && !desc->getPath().empty())
+		call_stack->Map(desc->getPath(),
+				offset,
+				addr,
+				len,
+				true);
+
 	// Return mapped address
 	return addr;
 }
@@ -4044,8 +4040,8 @@ int Context::ExecuteSyscall_sched_rr_get_interval()
 
 bool Context::SyscallNanosleepCanWakeup()
 {
-	// If suspension thread is still running for this context, do nothing.
-	if (host_thread_suspend_active)
+	// If the reactor is still watching for this context, do nothing.
+	if (emulator->getReactor()->isWatching(this))
 		return false;
 
 	// Get current time
@@ -4088,11 +4084,8 @@ bool Context::SyscallNanosleepCanWakeup()
 		return true;
 	}
 
-	// No event available, launch host thread again
-	host_thread_suspend_active = true;
-	if (pthread_create(&host_thread_suspend, nullptr,
-			&Context::HostThreadSuspend, this))
-		throw misc::Panic("Could not create child thread");
+	// No event available, watch for it again
+	HostWatch();
 	
 	// Done
 	return false;
@@ -4275,8 +4268,8 @@ void Context::SyscallPollWakeup()
 
 bool Context::SyscallPollCanWakeup()
 {
-	// If host thread is still running for this context, do nothing.
-	if (host_thread_suspend_active)
+	// If the reactor is still watching for this context, do nothing.
+	if (emulator->getReactor()->isWatching(this))
 		return false;
 
 	// Current time
@@ -4355,11 +4348,8 @@ bool Context::SyscallPollCanWakeup()
 		return true;
 	}
 
-	// No event available, launch host thread again
-	host_thread_suspend_active = true;
-	if (pthread_create(&host_thread_suspend, nullptr,
-			&Context::HostThreadSuspend, this))
-		throw misc::Panic("Could not launch host thread");
+	// No event available, watch for it again
+	HostWatch();
 	
 	// Done
 	return false;
@@ -6719,7 +6709,7 @@ int Context::ExecuteSyscall_tgkill()
 
 	// Send signal
 	context->signal_mask_table.getPending().Add(sig);
-	context->HostThreadSuspendCancel();
+	context->HostWatchCancel();
 	emulator->ProcessEventsSchedule();
 	emulator->ProcessEvents();
 	return 0;
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <lib/cpp/Misc.h>
 
 #include "Context.h"
@@ -92,7 +94,7 @@ void Context::EmitUinstEffectiveAddress(Uinst *uinst, int index)
 	uinst_effaddr_emitted = true;
 
 	// Create micro-instruction
-	uinsts.emplace_back(misc::new_unique<Uinst>(Uinst::OpcodeEffaddr));
+	uinsts.emplace_back(Uinst::newShared(Uinst::OpcodeEffaddr));
 	Uinst *new_uinst = uinsts.back().get();
 	
 	// Emit micro-instruction
@@ -246,7 +248,7 @@ void Context::ParseUinstIDep(Uinst *uinst, int index)
 		}
 
 		// Load
-		uinsts.emplace_back(misc::new_unique<Uinst>(Uinst::OpcodeLoad));
+		uinsts.emplace_back(Uinst::newShared(Uinst::OpcodeLoad));
 		Uinst *new_uinst = uinsts.back().get();
 		new_uinst->setIDep(0, Uinst::DepEa);
 		new_uinst->setODep(0, mem_std_dep);
@@ -292,7 +294,7 @@ void Context::ParseUinstODep(Uinst *uinst, int index)
 		}
 
 		// Store
-		uinsts.emplace_back(misc::new_unique<Uinst>(Uinst::OpcodeStore));
+		uinsts.emplace_back(Uinst::newShared(Uinst::OpcodeStore));
 		Uinst *new_uinst = uinsts.back().get();
 		new_uinst->setIDep(0, Uinst::DepEa);
 		new_uinst->setIDep(1, mem_std_dep);
@@ -325,8 +327,38 @@ void Context::newMemoryUinst(
 	if (!uinst_active)
 		return;
 
+	// Replay the expansion recorded in a previous execution of the
+	// instruction, if this call has the same arguments
+	int deps[Uinst::MaxDeps] = { idep0, idep1, idep2,
+			odep0, odep1, odep2, odep3 };
+	if (uinst_templates && uinst_template_index <
+			(int) uinst_templates->size())
+	{
+		UinstTemplate &entry = (*uinst_templates)[uinst_template_index];
+		if (entry.opcode == opcode &&
+				entry.effaddr_emitted == uinst_effaddr_emitted &&
+				std::equal(deps, deps + Uinst::MaxDeps, entry.deps))
+		{
+			for (unsigned i = 0; i < entry.uinsts.size(); i++)
+			{
+				auto uinst = Uinst::newShared(entry.uinsts[i]);
+				if (entry.addresses[i] == UinstAddressExplicit)
+					uinst->setMemoryAccess(address, size);
+				else if (entry.addresses[i] == UinstAddressEffective)
+					uinst->setMemoryAccess(last_effective_address,
+							uinst->getSize());
+				uinsts.emplace_back(uinst);
+			}
+			uinst_effaddr_emitted = entry.effaddr_emitted_after;
+			uinst_template_index++;
+			return;
+		}
+	}
+
 	// Create micro-instruction
-	auto uinst = misc::new_shared<Uinst>(opcode);
+	bool effaddr_emitted = uinst_effaddr_emitted;
+	unsigned first = uinsts.size();
+	auto uinst = Uinst::newShared(opcode);
 
 	// Initialize
 	uinst->setMemoryAccess(address, size);
@@ -352,6 +384,61 @@ void Context::newMemoryUinst(
 	// Parse output dependences
 	for (int i = 0; i < Uinst::MaxODeps; i++)
 		ParseUinstODep(uinst.get(), i);
+
+	// Record the expansion, replacing the templates of later calls, which
+	// followed a different path in the previous execution
+	if (!uinst_templates)
+		return;
+	uinst_templates->resize(uinst_template_index);
+	uinst_templates->emplace_back();
+	UinstTemplate &entry = uinst_templates->back();
+	entry.opcode = opcode;
+	std::copy(deps, deps + Uinst::MaxDeps, entry.deps);
+	entry.effaddr_emitted = effaddr_emitted;
+	entry.effaddr_emitted_after = uinst_effaddr_emitted;
+	for (unsigned i = first; i < uinsts.size(); i++)
+	{
+		// The main micro-instruction keeps its explicit address unless
+		// it was converted into a load or a store from a 'move'. The
+		// rest are effective address computations, with no address,
+		// or loads and stores of the effective address.
+		Uinst *new_uinst = uinsts[i].get();
+		UinstAddress source;
+		if (new_uinst == uinst.get())
+			source = new_uinst->getOpcode() == opcode ?
+					UinstAddressExplicit :
+					UinstAddressEffective;
+		else
+			source = new_uinst->getOpcode() == Uinst::OpcodeEffaddr ?
+					UinstAddressNone :
+					UinstAddressEffective;
+		entry.uinsts.push_back(*new_uinst);
+		entry.addresses.push_back(source);
+	}
+	uinst_template_index++;
+}
+
+
+void Context::LookupUinstTemplates()
+{
+	// Discard templates if the code in memory changed
+	if (uinst_template_cache_version != memory->getCodeVersion())
+	{
+		uinst_template_cache.clear();
+		uinst_template_cache_version = memory->getCodeVersion();
+	}
+
+	// Find or create the templates for the instruction. On creation,
+	// make sure that modifications of the code flush the cache.
+	auto result = uinst_template_cache.emplace(current_eip,
+			std::vector<UinstTemplate>());
+	if (result.second)
+	{
+		memory->MarkCode(current_eip);
+		memory->MarkCode(current_eip + inst.getSize() - 1);
+	}
+	uinst_templates = &result.first->second;
+	uinst_template_index = 0;
 }
 
 }
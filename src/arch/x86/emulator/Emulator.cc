@@ -233,6 +233,37 @@ Emulator *Emulator::getInstance()
 }
 
 
+Reactor *Emulator::getReactor()
+{
+	if (!reactor)
+		reactor = misc::new_unique<Reactor>(this);
+	return reactor.get();
+}
+
+
+void Emulator::ResumeAfterFork()
+{
+	// Destroy the reactor inherited from the parent, closing its file
+	// descriptors without waiting for its host thread, which only exists
+	// in the parent. Contexts that were waiting for host events watch them
+	// again next time they check their wakeup conditions.
+	if (reactor)
+	{
+		reactor->DetachAfterFork();
+		reactor.reset();
+	}
+
+	// Stop sharing host file offsets with the parent process
+	for (auto &context : contexts)
+		context->getFileTable()->ReopenHostFiles();
+
+	// Check wakeup conditions of suspended contexts, and let a timing
+	// simulator created in this process map the running contexts
+	ProcessEventsScheduleUnsafe();
+	schedule_signal = true;
+}
+
+
 Context *Emulator::newContext()
 {
 	// Create context and add to context list
@@ -29,6 +29,7 @@
 #include <lib/cpp/Error.h>
 
 #include "Context.h"
+#include "Reactor.h"
 
 
 namespace x86
@@ -106,6 +107,11 @@ class Emulator : public comm::Emulator
 	// and child host threads.
 	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
+	// Host thread waiting for the host events of suspended contexts,
+	// created the first time a context needs it. Declared after the
+	// contexts and the mutex, so that it is destroyed before them.
+	std::unique_ptr<Reactor> reactor;
+
 	// Counter of times that a context has been suspended in a futex. Used
 	// for FIFO wakeups.
 	long long futex_sleep_count = 0;
@@ -188,6 +194,22 @@ public:
 	/// Unlock the emulator mutex
 	void UnlockMutex() { pthread_mutex_unlock(&mutex); }
 
+	/// Return the host reactor, launching its host thread the first time
+	/// this function is called.
+	Reactor *getReactor();
+
+	/// Return whether the host reactor has been created
+	bool hasReactor() const { return reactor.get(); }
+
+	/// Prepare the emulator state to continue in a process created with
+	/// fork(). The host reactor is destroyed without stopping its thread,
+	/// which does not exist in the new process, and is created again when
+	/// a context needs it. Host files opened by contexts are opened again
+	/// so that file offsets are not shared with the parent process. The
+	/// emulator mutex must be locked around the call to fork() and this
+	/// function.
+	void ResumeAfterFork();
+
 	// Check for events detected in spawned host threads, such as waking up
 	// contexts or sending signals. The list is only effectively processed
 	// if events have been scheduled to get processed with a previous call
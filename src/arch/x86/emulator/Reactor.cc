@@ -0,0 +1,327 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2013  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cerrno>
+#include <ctime>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <vector>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/esim/Engine.h>
+
+#include "Emulator.h"
+#include "Reactor.h"
+
+
+namespace x86
+{
+
+// Values of the 'epoll' user data for the stop event and the timer. Watch
+// identifiers start after them.
+static const unsigned long long reactor_stop_id = 0;
+static const unsigned long long reactor_timer_id = 1;
+
+
+// Lock on a mutex held until the end of the enclosing scope, so that the
+// mutex is also released when a panic is thrown while it is locked
+class ReactorLock
+{
+	pthread_mutex_t *mutex;
+
+public:
+
+	ReactorLock(pthread_mutex_t *mutex) : mutex(mutex)
+	{
+		pthread_mutex_lock(mutex);
+	}
+
+	~ReactorLock()
+	{
+		pthread_mutex_unlock(mutex);
+	}
+};
+
+
+Reactor::Reactor(Emulator *emulator) :
+		emulator(emulator)
+{
+	// Create file descriptors
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epoll_fd < 0 || timer_fd < 0 || stop_fd < 0)
+		throw misc::Panic("Cannot create host reactor file descriptors");
+
+	// Watch the stop event and the timer
+	struct epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.u64 = reactor_stop_id;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &event))
+		throw misc::Panic("Cannot watch reactor stop event");
+	event.data.u64 = reactor_timer_id;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &event))
+		throw misc::Panic("Cannot watch reactor timer");
+	next_id = reactor_timer_id + 1;
+
+	// Launch host thread
+	if (pthread_create(&thread, nullptr, &Reactor::Loop, this))
+		throw misc::Panic("Could not launch host reactor thread");
+}
+
+
+Reactor::~Reactor()
+{
+	// Stop host thread
+	unsigned long long value = 1;
+	if (thread_running)
+	{
+		if (write(stop_fd, &value, sizeof value) != sizeof value)
+			misc::Warning("Cannot stop host reactor thread");
+		else
+			pthread_join(thread, nullptr);
+	}
+
+	// Release file descriptors
+	for (auto &it : watches)
+		if (it.second->host_fd >= 0)
+			close(it.second->host_fd);
+	close(epoll_fd);
+	close(timer_fd);
+	close(stop_fd);
+}
+
+
+long long Reactor::getMonotonicTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+void Reactor::RemoveWatchUnsafe(Entry *entry)
+{
+	// Stop watching the host file
+	if (entry->host_fd >= 0)
+	{
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, entry->host_fd, nullptr);
+		close(entry->host_fd);
+	}
+
+	// Remove from tables. The entry is freed last.
+	watches_by_id.erase(entry->id);
+	watches.erase(entry->context);
+}
+
+
+void Reactor::ArmTimerUnsafe()
+{
+	// Earliest deadline
+	long long deadline = 0;
+	for (auto &it : watches)
+	{
+		Entry *entry = it.second.get();
+		if (entry->deadline && (!deadline || entry->deadline < deadline))
+			deadline = entry->deadline;
+	}
+
+	// Nothing to do if the timer is already armed for it
+	if (deadline == timer_deadline)
+		return;
+	timer_deadline = deadline;
+
+	// Arm the timer with an absolute time, or disarm it. A deadline in
+	// the past makes the timer expire right away.
+	struct itimerspec spec = {};
+	spec.it_value.tv_sec = deadline / 1000000;
+	spec.it_value.tv_nsec = deadline % 1000000 * 1000;
+	if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr))
+		throw misc::Panic("Cannot arm host reactor timer");
+}
+
+
+void Reactor::Loop()
+{
+	const int max_events = 32;
+	struct epoll_event events[max_events];
+	bool stop = false;
+	while (!stop)
+	{
+		// Wait for events
+		int count = epoll_wait(epoll_fd, events, max_events, -1);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw misc::Panic("Unexpected error in host 'epoll_wait'");
+		}
+
+		// Lock in the same order as the emulator does
+		emulator->LockMutex();
+		pthread_mutex_lock(&mutex);
+
+		// Finish the watches whose file is ready
+		bool ready = false;
+		bool timer = false;
+		for (int i = 0; i < count; i++)
+		{
+			unsigned long long id = events[i].data.u64;
+			if (id == reactor_stop_id)
+			{
+				stop = true;
+			}
+			else if (id == reactor_timer_id)
+			{
+				unsigned long long expirations;
+				if (read(timer_fd, &expirations, sizeof expirations) < 0
+						&& errno != EAGAIN)
+					throw misc::Panic("Unexpected error "
+							"reading reactor timer");
+				timer = true;
+			}
+			else
+			{
+				// The watch may have been canceled or replaced
+				// while waiting for the lock
+				auto it = watches_by_id.find(id);
+				if (it == watches_by_id.end())
+					continue;
+				RemoveWatchUnsafe(it->second);
+				ready = true;
+			}
+		}
+
+		// Finish the watches whose deadline expired
+		if (timer)
+		{
+			long long now = getMonotonicTime();
+			std::vector<Entry *> expired;
+			for (auto &it : watches)
+				if (it.second->deadline && it.second->deadline <= now)
+					expired.push_back(it.second.get());
+			for (Entry *entry : expired)
+				RemoveWatchUnsafe(entry);
+			ready = ready || !expired.empty();
+			timer_deadline = -1;
+			ArmTimerUnsafe();
+		}
+
+		// Let the emulator check the wakeup conditions of contexts
+		if (ready)
+			emulator->ProcessEventsScheduleUnsafe();
+
+		// Unlock
+		pthread_mutex_unlock(&mutex);
+		emulator->UnlockMutex();
+	}
+}
+
+
+void Reactor::Watch(Context *context, int host_fd, int events,
+		long long deadline)
+{
+	// Convert deadline into host monotonic time
+	long long host_deadline = 0;
+	if (deadline)
+	{
+		esim::Engine *esim = esim::Engine::getInstance();
+		host_deadline = getMonotonicTime() + deadline -
+				esim->getRealTime();
+		if (host_deadline <= 0)
+			host_deadline = 1;
+	}
+
+	// Replace previous watch
+	ReactorLock lock(&mutex);
+	auto it = watches.find(context);
+	if (it != watches.end())
+		RemoveWatchUnsafe(it->second.get());
+
+	// Create new watch
+	Entry *entry = new Entry();
+	entry->context = context;
+	entry->id = next_id++;
+	entry->host_fd = -1;
+	entry->deadline = host_deadline;
+	watches[context].reset(entry);
+	watches_by_id[entry->id] = entry;
+
+	// Watch a duplicate of the host file, so that several contexts can
+	// wait on it. Files not supported by 'epoll', such as regular files,
+	// are always ready, so the watch finishes right away. If the file
+	// cannot be watched, the new watch is dropped, so that the context
+	// does not wait for an event that never comes.
+	if (host_fd >= 0)
+	{
+		entry->host_fd = dup(host_fd);
+		if (entry->host_fd < 0)
+		{
+			RemoveWatchUnsafe(entry);
+			throw misc::Panic("Cannot duplicate host file descriptor");
+		}
+		struct epoll_event event = {};
+		event.events = ((events & POLLIN) ? EPOLLIN : 0) |
+				((events & POLLOUT) ? EPOLLOUT : 0) |
+				EPOLLONESHOT;
+		event.data.u64 = entry->id;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, entry->host_fd, &event))
+		{
+			if (errno != EPERM)
+			{
+				RemoveWatchUnsafe(entry);
+				throw misc::Panic("Cannot watch host file "
+						"descriptor");
+			}
+			close(entry->host_fd);
+			entry->host_fd = -1;
+			entry->deadline = 1;
+		}
+	}
+
+	// Update timer
+	ArmTimerUnsafe();
+}
+
+
+void Reactor::Cancel(Context *context)
+{
+	ReactorLock lock(&mutex);
+	auto it = watches.find(context);
+	if (it != watches.end())
+	{
+		RemoveWatchUnsafe(it->second.get());
+		ArmTimerUnsafe();
+	}
+}
+
+
+bool Reactor::isWatching(Context *context)
+{
+	ReactorLock lock(&mutex);
+	return watches.count(context);
+}
+
+
+}  // namespace x86
+
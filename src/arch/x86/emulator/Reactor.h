@@ -0,0 +1,163 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2013  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_X86_EMULATOR_REACTOR_H
+#define ARCH_X86_EMULATOR_REACTOR_H
+
+#include <pthread.h>
+
+#include <memory>
+#include <unordered_map>
+
+
+namespace x86
+{
+
+class Context;
+class Emulator;
+
+
+/// Single host thread waiting for the host events that suspended contexts
+/// depend on, such as a host file descriptor becoming readable or writable,
+/// or a deadline expiring. When the event of a context occurs, the reactor
+/// stops watching for it and schedules a call to
+/// Emulator::ProcessEvents(), where the context checks its wakeup
+/// condition again.
+///
+/// The reactor thread is based on 'epoll'. Every watched file descriptor is
+/// duplicated, so that several contexts can wait for the same host file,
+/// and deadlines are handled with one 'timerfd' armed for the earliest of
+/// them.
+class Reactor
+{
+	// A watch requested for a context
+	struct Entry
+	{
+		// Context waiting
+		Context *context;
+
+		// Identifier of the watch, used as the 'epoll' user data
+		unsigned long long id;
+
+		// Duplicated host file descriptor, or -1 if none
+		int host_fd;
+
+		// Absolute deadline in the host monotonic clock, in
+		// microseconds, or 0 if none
+		long long deadline;
+	};
+
+	// Emulator whose events are scheduled
+	Emulator *emulator;
+
+	// Host thread
+	pthread_t thread;
+
+	// Whether the host thread runs in this process. It does not after
+	// a call to fork().
+	bool thread_running = true;
+
+	// File descriptors for 'epoll', the deadline timer, and the event
+	// used to stop the thread
+	int epoll_fd = -1;
+	int timer_fd = -1;
+	int stop_fd = -1;
+
+	// Mutex protecting the watch tables. If both mutexes are needed, the
+	// emulator mutex is always locked first.
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+	// Watches indexed by context and by identifier
+	std::unordered_map<Context *, std::unique_ptr<Entry>> watches;
+	std::unordered_map<unsigned long long, Entry *> watches_by_id;
+
+	// Identifier for the next watch
+	unsigned long long next_id = 1;
+
+	// Deadline the timer is currently armed for, or 0 if disarmed
+	long long timer_deadline = 0;
+
+	// Return the current time in the host monotonic clock in
+	// microseconds
+	static long long getMonotonicTime();
+
+	// Remove a watch. The mutex must be locked.
+	void RemoveWatchUnsafe(Entry *entry);
+
+	// Arm the timer for the earliest deadline. The mutex must be locked.
+	void ArmTimerUnsafe();
+
+	// Main loop of the host thread
+	void Loop();
+	static void *Loop(void *data)
+	{
+		((Reactor *) data)->Loop();
+		return nullptr;
+	}
+
+public:
+
+	/// Constructor. The host thread is launched right away.
+	Reactor(Emulator *emulator);
+
+	/// Destructor. Stops the host thread and waits for it to finish,
+	/// unless DetachAfterFork() was called, and closes all host file
+	/// descriptors of the reactor.
+	~Reactor();
+
+	/// Forget about the host thread in a process created with fork(),
+	/// where the thread does not exist. The reactor is not usable after
+	/// this call, and should only be destroyed.
+	void DetachAfterFork() { thread_running = false; }
+
+	/// Start watching for an event for \a context, replacing any previous
+	/// watch for it.
+	///
+	/// \param host_fd
+	///	Host file descriptor to watch, or -1 to only wait for the
+	///	deadline.
+	///
+	/// \param events
+	///	Bitmap of 'POLLIN' and 'POLLOUT' flags for \a host_fd.
+	///
+	/// \param deadline
+	///	Time in microseconds, relative to the real time of the
+	///	event-driven simulator (esim::Engine::getRealTime()), when the
+	///	watch finishes even if no event occurred on \a host_fd, or 0 for
+	///	no deadline.
+	///
+	/// \throw
+	///	A panic occurs if \a host_fd cannot be watched. No watch is left
+	///	for \a context in that case.
+	void Watch(Context *context, int host_fd, int events,
+			long long deadline);
+
+	/// Stop watching for events for \a context, if any
+	void Cancel(Context *context);
+
+	/// Return whether the reactor is still waiting for an event for
+	/// \a context
+	bool isWatching(Context *context);
+};
+
+
+}  // namespace x86
+
+#endif
+
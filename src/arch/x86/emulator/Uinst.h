@@ -20,9 +20,12 @@
 #ifndef ARCH_X86_EMULATOR_UINST_H
 #define ARCH_X86_EMULATOR_UINST_H
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/String.h>
@@ -367,10 +370,110 @@ public:
 	// Member functions
 	//
 
+	/// Allocator recycling the memory of freed micro-instructions, used
+	/// by newShared(). std::allocate_shared() rebinds it to the internal
+	/// type holding both the micro-instruction and its reference
+	/// counters, and each rebound type keeps its own list of free blocks.
+	/// A list keeps at most MaxFreeBlocks blocks, enough for the
+	/// micro-instructions in flight in the pipelines, so that a burst of
+	/// allocations does not keep its memory forever. The lists are never
+	/// destroyed, so that micro-instructions can still be released during
+	/// program termination.
+	template<typename T> class Allocator
+	{
+		static std::vector<T *> &getFreeBlocks()
+		{
+			static std::vector<T *> *free_blocks =
+					new std::vector<T *>();
+			return *free_blocks;
+		}
+
+	public:
+
+		/// Maximum number of free blocks kept for reuse
+		static const int MaxFreeBlocks = 4096;
+
+		typedef T value_type;
+
+		Allocator() = default;
+
+		template<typename U> Allocator(const Allocator<U> &)
+		{
+		}
+
+		T *allocate(std::size_t n)
+		{
+			std::vector<T *> &free_blocks = getFreeBlocks();
+			if (n == 1 && !free_blocks.empty())
+			{
+				T *block = free_blocks.back();
+				free_blocks.pop_back();
+				return block;
+			}
+			return static_cast<T *>(::operator new(n * sizeof(T)));
+		}
+
+		void deallocate(T *block, std::size_t n)
+		{
+			std::vector<T *> &free_blocks = getFreeBlocks();
+			if (n == 1 && (int) free_blocks.size() < MaxFreeBlocks)
+				free_blocks.push_back(block);
+			else
+				::operator delete(block);
+		}
+
+		/// Return the number of free blocks kept for reuse
+		static int getNumFreeBlocks()
+		{
+			return getFreeBlocks().size();
+		}
+
+		template<typename U> bool operator==(const Allocator<U> &) const
+		{
+			return true;
+		}
+
+		template<typename U> bool operator!=(const Allocator<U> &) const
+		{
+			return false;
+		}
+	};
+
+	/// Create a micro-instruction in memory recycled from previously
+	/// freed micro-instructions. The arguments are passed to the
+	/// constructor.
+	template<typename... Args> static std::shared_ptr<Uinst>
+			newShared(Args&&... args)
+	{
+		return std::allocate_shared<Uinst>(Allocator<Uinst>(),
+				std::forward<Args>(args)...);
+	}
+
 	/// Create a micro-instruction with a given \a opcode
 	Uinst(Opcode opcode) : opcode(opcode)
 	{
 	}
+
+	/// Copy constructor. Pointers 'idep' and 'odep' keep pointing to the
+	/// dependences of the new object.
+	Uinst(const Uinst &other) :
+			opcode(other.opcode),
+			address(other.address),
+			size(other.size)
+	{
+		std::copy(other.dep, other.dep + MaxDeps, dep);
+	}
+
+	/// Assignment operator, with the same semantics as the copy
+	/// constructor
+	Uinst &operator=(const Uinst &other)
+	{
+		opcode = other.opcode;
+		std::copy(other.dep, other.dep + MaxDeps, dep);
+		address = other.address;
+		size = other.size;
+		return *this;
+	}
 	
 	/// Return the micro-instruction opcode
 	Opcode getOpcode() const { return opcode; }
@@ -25,6 +25,14 @@
 namespace x86
 {
 
+esim::ProfileRegion *Core::profile_fetch;
+esim::ProfileRegion *Core::profile_decode;
+esim::ProfileRegion *Core::profile_dispatch;
+esim::ProfileRegion *Core::profile_issue;
+esim::ProfileRegion *Core::profile_writeback;
+esim::ProfileRegion *Core::profile_commit;
+
+
 Core::Core(Cpu *cpu,
 		int id) :
 		cpu(cpu),
@@ -33,6 +41,17 @@ Core::Core(Cpu *cpu,
 	// Assign name
 	name = misc::fmt("Core %d", id);
 
+	// Profile regions
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	profile_fetch = esim_engine->RegisterProfileRegion("x86::Core::Fetch");
+	profile_decode = esim_engine->RegisterProfileRegion("x86::Core::Decode");
+	profile_dispatch = esim_engine->RegisterProfileRegion(
+			"x86::Core::Dispatch");
+	profile_issue = esim_engine->RegisterProfileRegion("x86::Core::Issue");
+	profile_writeback = esim_engine->RegisterProfileRegion(
+			"x86::Core::Writeback");
+	profile_commit = esim_engine->RegisterProfileRegion("x86::Core::Commit");
+
 	// Create threads
 	threads.reserve(Cpu::getNumThreads());
 	for (int i = 0; i < Cpu::getNumThreads(); i++)
@@ -452,13 +471,32 @@ void Core::Commit()
 
 void Core::Run()
 {
-	// Run stages in reverse order
-	Commit();
-	Writeback();
-	Issue();
-	Dispatch();
-	Decode();
-	Fetch();
+	// Run stages in reverse order, timing them if the simulator profile
+	// is active
+	{
+		esim::ProfileScope profile(profile_commit);
+		Commit();
+	}
+	{
+		esim::ProfileScope profile(profile_writeback);
+		Writeback();
+	}
+	{
+		esim::ProfileScope profile(profile_issue);
+		Issue();
+	}
+	{
+		esim::ProfileScope profile(profile_dispatch);
+		Dispatch();
+	}
+	{
+		esim::ProfileScope profile(profile_decode);
+		Decode();
+	}
+	{
+		esim::ProfileScope profile(profile_fetch);
+		Fetch();
+	}
 }
 
 }
@@ -25,6 +25,7 @@
 #include <string>
 
 #include <arch/x86/emulator/Uinst.h>
+#include <lib/esim/Profile.h>
 
 #include "Alu.h"
 #include "Thread.h"
@@ -42,6 +43,14 @@ class Core
 {
 private:
 
+	// Profile regions for the pipeline stages of all cores
+	static esim::ProfileRegion *profile_fetch;
+	static esim::ProfileRegion *profile_decode;
+	static esim::ProfileRegion *profile_dispatch;
+	static esim::ProfileRegion *profile_issue;
+	static esim::ProfileRegion *profile_writeback;
+	static esim::ProfileRegion *profile_commit;
+
 	// Name of this core
 	std::string name;
 
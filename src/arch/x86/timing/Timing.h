@@ -169,6 +169,12 @@ public:
 	/// Dump the statistics summary for the timing simulator.
 	void DumpSummary(std::ostream &os) const override;
 
+	/// Return the number of instructions committed by the CPU
+	long long getNumCommittedInstructions() const override
+	{
+		return cpu->getNumCommittedInstructions();
+	}
+
 	/// Dump a report of statistics collected during x86 simulation
 	void DumpReport() const override;
 
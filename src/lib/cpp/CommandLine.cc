@@ -19,6 +19,7 @@
 
 #include <cstring>
 #include <string>
+#include <unordered_set>
 
 #include "CommandLine.h"
 #include "Misc.h"
@@ -443,5 +444,69 @@ void CommandLine::Process(int argc, char **argv, bool options_anywhere)
 	}
 }
 
+
+void CommandLine::ProcessOverrides(const std::vector<std::string> &options,
+		const std::unordered_set<std::string> *allowed)
+{
+	// Command line must have been processed before
+	assert(processed);
+
+	// Copy into a deque
+	std::deque<std::string> arguments(options.begin(), options.end());
+
+	// Process command-line options
+	std::unordered_set<std::string> names;
+	while (arguments.size() > 0)
+	{
+		// Extract argument
+		std::string argument = arguments.front();
+		arguments.pop_front();
+
+		// Only options are accepted
+		if (!StringPrefix(argument, "-") || argument == "--help")
+			throw Error(misc::fmt("Invalid option override: %s",
+					argument.c_str()));
+
+		// Split attached argument
+		bool attached_argument = !StringPrefix(argument, "--") &&
+				argument.length() > 2;
+		if (attached_argument)
+		{
+			arguments.push_front(argument.substr(2));
+			argument = argument.substr(0, 2);
+		}
+
+		// Find command-line option
+		auto it = option_table.find(argument);
+		if (it == option_table.end())
+			throw Error(misc::fmt("Invalid option: %s\n%s",
+					argument.c_str(),
+					error_message.c_str()));
+		CommandLineOption *option = it->second;
+
+		// Check if option can be overridden
+		if (allowed && !allowed->count(argument))
+			throw Error(misc::fmt("Option '%s' cannot be overridden",
+					option->getName().c_str()));
+
+		// Check number of option arguments
+		if ((attached_argument && option->getNumArguments() != 1) ||
+				(int) arguments.size() < option->getNumArguments())
+			throw Error(misc::fmt("Option '%s' expects %d "
+					"argument(s)",
+					option->getName().c_str(),
+					option->getNumArguments()));
+
+		// Check if option was already overridden
+		if (!names.insert(argument).second)
+			throw Error(misc::fmt("Multiple occurrences of "
+					"option '%s'",
+					option->getName().c_str()));
+
+		// Process command-line option
+		option->Read(arguments);
+	}
+}
+
 }  // namespace misc
 
@@ -26,6 +26,7 @@
 #include <memory>
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <list>
 #include <vector>
 
@@ -562,6 +563,31 @@ public:
 	///	An exception will occur if any of the options passed in the
 	///	command line are invalid or does not have enough arguments.
 	void Process(int argc, char **argv, bool options_anywhere = true);
+
+	/// Return the number of registered command-line options
+	int getNumOptions() const { return options.size(); }
+
+	/// Return the name of the command-line option registered in position
+	/// \a index, counting in order of registration.
+	const std::string &getOptionName(int index) const
+	{
+		assert(index >= 0 && index < (int) options.size());
+		return options[index]->getName();
+	}
+
+	/// Process additional command-line options after the command line
+	/// was processed with Process(), overriding the values given to the
+	/// same options before. Only options can be given in \a options, and
+	/// option '--help' is not accepted. If \a allowed is given, only the
+	/// options whose names it contains can be overridden.
+	///
+	/// \throw
+	///	An exception will occur if any of the options is invalid, is not
+	///	allowed, does not have enough arguments, or appears more than
+	///	once.
+	void ProcessOverrides(const std::vector<std::string> &options,
+			const std::unordered_set<std::string> *allowed =
+			nullptr);
 };
 
 
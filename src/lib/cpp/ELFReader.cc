@@ -19,9 +19,13 @@
 
 #include <algorithm>
 #include <cstring>
-#include <fstream>
+#include <fcntl.h>
 #include <istream>
 #include <iomanip>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
 
 #include "ELFReader.h"
 #include "Misc.h"
@@ -33,21 +37,146 @@ namespace ELFReader
 
 
 
+//
+// Class 'Mapping'
+//
+
+/// Read-only mapping of a file in the host address space, shared by all ELF
+/// files loaded from the same path.
+class Mapping
+{
+	// Mappings currently alive, indexed by path. Entries are removed
+	// when their mapping is destroyed.
+	static std::unordered_map<std::string, std::weak_ptr<Mapping>> mappings;
+
+	// Path of the mapped file
+	std::string path;
+
+	// Mapped content
+	void *buffer = MAP_FAILED;
+
+	// Size of the file
+	unsigned size = 0;
+
+	// Identity of the host file, used to detect that it was replaced or
+	// modified since it was mapped
+	dev_t device = 0;
+	ino_t inode = 0;
+	time_t modification_time = 0;
+
+public:
+
+	/// Map the file in \a path
+	Mapping(const std::string &path);
+
+	/// Unmap the file
+	~Mapping();
+
+	/// Return a mapping for \a path, reusing a current one if the file
+	/// did not change since it was created.
+	static std::shared_ptr<Mapping> get(const std::string &path);
+
+	/// Return the mapped content
+	const char *getBuffer() const { return (const char *) buffer; }
+
+	/// Return the size of the file
+	unsigned getSize() const { return size; }
+
+	/// Return the number of paths with a mapping currently alive
+	static int getNumMappings() { return mappings.size(); }
+};
+
+
+std::unordered_map<std::string, std::weak_ptr<Mapping>> Mapping::mappings;
+
+
+Mapping::Mapping(const std::string &path) :
+		path(path)
+{
+	// Open file
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw Error(path, "Cannot open file");
+
+	// Get file size and identity
+	struct stat st;
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode))
+	{
+		close(fd);
+		throw Error(path, "Cannot open file");
+	}
+	device = st.st_dev;
+	inode = st.st_ino;
+	modification_time = st.st_mtime;
+	size = st.st_size;
+
+	// Check that size is at least equal to header size
+	if (size < sizeof(Elf32_Ehdr))
+	{
+		close(fd);
+		throw Error(path, "Invalid ELF file");
+	}
+
+	// Map the file. The mapping stays valid after closing it.
+	buffer = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (buffer == MAP_FAILED)
+		throw Error(path, "Cannot map file in memory");
+}
+
+
+Mapping::~Mapping()
+{
+	// Remove entry from the table, unless it was replaced by a newer
+	// mapping of the same path
+	auto it = mappings.find(path);
+	if (it != mappings.end() && it->second.expired())
+		mappings.erase(it);
+
+	// Unmap
+	if (buffer != MAP_FAILED)
+		munmap(buffer, size);
+}
+
+
+std::shared_ptr<Mapping> Mapping::get(const std::string &path)
+{
+	// Reuse current mapping if the file is the same
+	std::shared_ptr<Mapping> mapping;
+	auto it = mappings.find(path);
+	if (it != mappings.end())
+		mapping = it->second.lock();
+	struct stat st;
+	if (mapping && !stat(path.c_str(), &st) &&
+			st.st_dev == mapping->device &&
+			st.st_ino == mapping->inode &&
+			st.st_mtime == mapping->modification_time &&
+			(unsigned) st.st_size == mapping->size)
+		return mapping;
+
+	// Create new mapping
+	mapping = std::make_shared<Mapping>(path);
+	mappings[path] = mapping;
+	return mapping;
+}
+
+
+
+
 //
 // Class 'Section'
 //
 
 
-Section::Section(File *file, int index, unsigned info_offset) :
+Section::Section(const File *file, int index, unsigned info_offset) :
 		file(file),
 		index(index)
 {
 	// Read section header
-	info = (Elf32_Shdr *) (file->getBuffer() + info_offset);
-	if (info_offset < 0 || info_offset + sizeof(Elf32_Shdr)
-			> file->getSize())
+	if (info_offset + sizeof(Elf32_Shdr) > file->getSize())
 		throw Error(file->getPath(), "Invalid position for "
 				"section header");
+	info = (const Elf32_Shdr *) (file->getBuffer() + info_offset);
 
 	// Initialize
 	size = info->sh_size;
@@ -60,19 +189,32 @@ Section::Section(File *file, int index, unsigned info_offset) :
 		if (info->sh_offset + info->sh_size > file->getSize())
 			throw Error(file->getPath(), "Section out of range");
 
-		// Set up buffer and stream
+		// Set up buffer
 		buffer = file->getBuffer() + info->sh_offset;
 	}
 }
 
 
+void Section::getStream(std::istringstream &stream, unsigned offset,
+		unsigned size) const
+{
+	// Check valid offset/size
+	if (!buffer || offset + size > this->size)
+		throw Error(file->getPath(), "Invalid offset/size");
+
+	// Copy content
+	stream.str(std::string(buffer + offset, size));
+}
+
+
 
 //
 // Class 'ProgramHeader'
 //
 
 
-ProgramHeader::ProgramHeader(File *file, int index, unsigned info_offset) :
+ProgramHeader::ProgramHeader(const File *file, int index,
+		unsigned info_offset) :
 		file(file),
 		index(index)
 {
@@ -81,11 +223,10 @@ ProgramHeader::ProgramHeader(File *file, int index, unsigned info_offset) :
 	this->index = index;
 
 	// Read program header
-	info = (Elf32_Phdr *) (file->getBuffer() + info_offset);
-	if (info_offset < 0 || info_offset + sizeof(Elf32_Phdr) >
-			file->getSize())
+	if (info_offset + sizeof(Elf32_Phdr) > file->getSize())
 		throw Error(file->getPath(), "Invalid position for program "
 				"header");
+	info = (const Elf32_Phdr *) (file->getBuffer() + info_offset);
 
 	// File content
 	size = info->p_filesz;
@@ -100,9 +241,8 @@ void ProgramHeader::getStream(std::istringstream &stream, unsigned int offset,
 	if (offset + size > this->size)
 		throw Error(file->getPath(), "Invalid offset/size");
 
-	// Set substream
-	std::stringbuf *buf = stream.rdbuf();
-	buf->pubsetbuf(const_cast<char *>(buffer) + offset, size);
+	// Copy content
+	stream.str(std::string(buffer + offset, size));
 }
 
 
@@ -112,15 +252,15 @@ void ProgramHeader::getStream(std::istringstream &stream, unsigned int offset,
 // Class 'Symbol'
 //
 
-Symbol::Symbol(File *file, Section *section, unsigned int pos)
+Symbol::Symbol(const File *file, Section *section, unsigned int pos)
 {
 	// Initialize
 	this->file = file;
 
 	// Read symbol
-	info = (Elf32_Sym *) (section->getBuffer() + pos);
-	if (pos < 0 || pos + sizeof(Elf32_Sym) > section->getSize())
+	if (pos + sizeof(Elf32_Sym) > section->getSize())
 		throw Error(file->getPath(), "Invalid position for symbol");
+	info = (const Elf32_Sym *) (section->getBuffer() + pos);
 
 	// Get section with symbol name
 	unsigned name_section_index = section->getLink();
@@ -187,9 +327,8 @@ void Symbol::getStream(std::istringstream &stream, unsigned int offset,
 				misc::fmt("symbol '%s': invalid size",
 				name.c_str()));
 
-	// Set substream
-	std::stringbuf *buf = stream.rdbuf();
-	buf->pubsetbuf(const_cast<char *>(buffer) + offset, size);
+	// Copy content
+	stream.str(std::string(buffer + offset, size));
 }
 
 
@@ -210,7 +349,7 @@ static const char *err_64bit =
 void File::ReadHeader()
 {
 	// Read ELF header
-	info = (Elf32_Ehdr *) buffer.get();
+	info = (const Elf32_Ehdr *) buffer;
 	if (size < sizeof(Elf32_Ehdr))
 		throw Error(path, "Invalid ELF file");
 
@@ -226,8 +365,13 @@ void File::ReadHeader()
 }
 
 
-void File::ReadSections()
+void File::ReadSections() const
 {
+	// Already read, or not requested
+	if (sections_read || !read_content)
+		return;
+	sections.clear();
+
 	// Check section size and number
 	if (!info->e_shnum || info->e_shentsize != sizeof(Elf32_Shdr))
 		throw Error(path, misc::fmt("Number of sections is 0 or "
@@ -254,15 +398,24 @@ void File::ReadSections()
 	for (auto &section : sections)
 		section->setName(string_table->getBuffer() +
 				section->getNameOffset());
+	sections_read = true;
 }
 
 
-void File::ReadProgramHeaders()
+void File::ReadProgramHeaders() const
 {
+	// Already read, or not requested
+	if (program_headers_read || !read_content)
+		return;
+	program_headers.clear();
+
 	// Nothing if there are no program headers. Don't even check if the
 	// program header size is the right one, it could be 0 in this case.
 	if (!info->e_phnum)
+	{
+		program_headers_read = true;
 		return;
+	}
 	
 	// Check program header size
 	if (info->e_phentsize != sizeof(Elf32_Phdr))
@@ -276,11 +429,20 @@ void File::ReadProgramHeaders()
 				this,
 				i,
 				info->e_phoff + i * info->e_phentsize));
+	program_headers_read = true;
 }
 
 
-void File::ReadSymbols()
+void File::ReadSymbols() const
 {
+	// Already read, or not requested
+	if (symbols_read || !read_content)
+		return;
+	symbols.clear();
+
+	// Symbols refer to sections
+	ReadSections();
+
 	// Load symbols from sections
 	for (auto &section : sections)
 	{
@@ -307,49 +469,32 @@ void File::ReadSymbols()
 
 	// Sort
 	sort(symbols.begin(), symbols.end(), Symbol::Compare);
+	symbols_read = true;
 }
 
 
 File::File(const std::string &path, bool read_content) :
-		path(path)
+		path(path),
+		read_content(read_content)
 {
-	// Open file
-	std::ifstream f(path);
-	if (!f)
-		throw Error(path, "Cannot open file");
+	// Map file
+	mapping = Mapping::get(path);
+	buffer = mapping->getBuffer();
+	size = mapping->getSize();
 
-	// Get file size
-	f.seekg(0, std::ios_base::end);
-	size = f.tellg();
-	f.seekg(0, std::ios_base::beg);
-
-	// Check that size is at least equal to header size
-	if (size < sizeof(Elf32_Ehdr))
-		throw Error(path, "Invalid ELF file");
-
-	// Load entire file into buffer and close
-	buffer = misc::new_unique_array<char>(size);
-	f.read(buffer.get(), size);
-	f.close();
-
-	// Make string stream point to buffer
-	std::stringbuf *buf = stream.rdbuf();
-	buf->pubsetbuf(buffer.get(), size);
-
-	// Read ELF header
+	// Read ELF header. The rest of the content is read on demand.
 	ReadHeader();
+}
 
-	// Read content
-	if (read_content)
-	{
-		ReadSections();
-		ReadProgramHeaders();
-		ReadSymbols();
-	}
+
+int File::getNumMappings()
+{
+	return Mapping::getNumMappings();
 }
 
 
-File::File(const char *buffer, unsigned size, bool read_content)
+File::File(const char *buffer, unsigned size, bool read_content) :
+		read_content(read_content)
 {
 	// Initialize
 	path = "<anonymous>";
@@ -360,28 +505,22 @@ File::File(const char *buffer, unsigned size, bool read_content)
 
 	// Copy buffer
 	this->size = size;
-	this->buffer = misc::new_unique_array<char>(size);
-	memcpy(this->buffer.get(), buffer, size);
+	copy = misc::new_unique_array<char>(size);
+	memcpy(copy.get(), buffer, size);
+	this->buffer = copy.get();
 
-	// Make string stream point to buffer
-	std::stringbuf *buf = stream.rdbuf();
-	buf->pubsetbuf(this->buffer.get(), size);
-
-	// Read ELF header
+	// Read ELF header. The rest of the content is read on demand.
 	ReadHeader();
-
-	// Read content
-	if (read_content)
-	{
-		ReadSections();
-		ReadProgramHeaders();
-		ReadSymbols();
-	}
 }
 
 
 std::ostream &operator<<(std::ostream &os, const File &file)
 {
+	// Read content
+	file.ReadSections();
+	file.ReadProgramHeaders();
+	file.ReadSymbols();
+
 	// Header
 	os << "ELF header:\n";
 	os << "  ehdr.e_ident: EI_CLASS=" << (int) file.info->e_ident[5] <<
@@ -471,6 +610,7 @@ std::ostream &operator<<(std::ostream &os, const File &file)
 Section *File::getSection(const std::string &name) const
 {
 	// Search
+	ReadSections();
 	for (auto &section : sections)
 		if (section->getName() == name)
 			return section.get();
@@ -483,6 +623,7 @@ Section *File::getSection(const std::string &name) const
 Symbol *File::getSymbol(const std::string &name) const
 {
 	// Search
+	ReadSymbols();
 	for (auto &symbol : symbols)
 		if (symbol->getName() == name)
 			return symbol.get();
@@ -499,9 +640,8 @@ void File::getStream(std::istringstream &stream, unsigned int offset,
 	if (offset + size > this->size)
 		throw Error(path, "Invalid offset and/or size");
 
-	// Set substream
-	std::stringbuf *buf = stream.rdbuf();
-	buf->pubsetbuf(buffer.get() + offset, size);
+	// Copy content
+	stream.str(std::string(buffer + offset, size));
 }
 
 
@@ -516,6 +656,7 @@ Symbol *File::getSymbolByAddress(unsigned int address,
 		unsigned int &offset) const
 {
 	// Empty symbol table
+	ReadSymbols();
 	if (!symbols.size())
 		return nullptr;
 
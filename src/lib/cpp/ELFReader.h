@@ -34,6 +34,7 @@ namespace ELFReader
 {
 
 class File;
+class Mapping;
 
 
 /// Exception class thrown by the class functions in the ELFReader name space.
@@ -64,7 +65,7 @@ public:
 class Section
 {
 	// File that it belongs to
-	File *file;
+	const File *file;
 
 	// Name of the section
 	std::string name;
@@ -79,7 +80,7 @@ class Section
 	int index;
 
 	// Raw section header
-	Elf32_Shdr *info;
+	const Elf32_Shdr *info;
 
 public:
 
@@ -95,7 +96,7 @@ public:
 	/// \param info_offset
 	///	Offset within the ELF file where the section header can be
 	///	found.
-	Section(File *file, int index, unsigned info_offset);
+	Section(const File *file, int index, unsigned info_offset);
 
 	/// Set the section name. This function is used internally by the ELF
 	/// reader, and should not be called.
@@ -108,7 +109,7 @@ public:
 	/// Return a pointer to the Elf32_Shdr structure representing the
 	/// section header. Each field of this structure can be queried with
 	/// dedicated getters instead.
-	Elf32_Shdr *getRawInfo() const { return info; }
+	const Elf32_Shdr *getRawInfo() const { return info; }
 
 	/// Return the section name
 	const std::string &getName() const { return name; }
@@ -149,12 +150,11 @@ public:
 	/// the internal buffer representing the entire ELF file.
 	const char *getBuffer() const { return buffer; }
 
-	/// Return a stream pointing to part of the content of the section,
-	/// without involving any copy operations.
+	/// Fill a stream with part of the content of the section. The
+	/// content is copied, since the file content is read-only.
 	///
 	/// \param stream
-	///	Input stream whose internal pointers will be modified to point
-	///	to the content of the section.
+	///	Input stream whose content will be replaced.
 	///
 	/// \param offset
 	///	Offset in the section that the stream points to.
@@ -183,13 +183,13 @@ public:
 class ProgramHeader
 {
 	// File that it belongs to
-	File *file;
+	const File *file;
 
 	// Index of the program header inf the ELF file
 	int index;
 
 	// Program header information
-	Elf32_Phdr *info;
+	const Elf32_Phdr *info;
 
 	// Content pointed to by the program header
 	const char *buffer = nullptr;
@@ -210,7 +210,7 @@ public:
 	///
 	/// \param info_offset
 	///	Offset in ELF file content where the program header is found.
-	ProgramHeader(File *file, int index, unsigned info_offset);
+	ProgramHeader(const File *file, int index, unsigned info_offset);
 
 	/// Return the index of the program header in the program header
 	/// list of the File object where it belongs.
@@ -219,7 +219,7 @@ public:
 	/// Return a pointer to the Elf32_Phdr structure representing the
 	/// program header. Each field of this structure can be queried with
 	/// dedicated getters instead.
-	Elf32_Phdr *getRawInfo() const { return info; }
+	const Elf32_Phdr *getRawInfo() const { return info; }
 
 	/// Return the \a p_type field of the ELF program header
 	Elf32_Word getType() const { return info->p_type; }
@@ -252,11 +252,12 @@ public:
 	/// Return a pointer to the segment content
 	const char *getBuffer() const { return buffer; }
 
-	/// Modify an input stream to hold the content pointed to by the program
-	/// header, without involving any copy operations.
+	/// Fill an input stream with the content pointed to by the program
+	/// header. The content is copied, since the file content is
+	/// read-only.
 	///
 	/// \param stream
-	///	Input stream whose internal pointers will be modified.
+	///	Input stream whose content will be replaced.
 	///
 	/// \param offset
 	///	Offset in the program header content that the stream points to.
@@ -285,7 +286,7 @@ public:
 class Symbol
 {
 	// File that it belongs to
-	File *file;
+	const File *file;
 
 	// Section that the symbol points to. This section is not the section
 	// passed as an argument to the constructor (i.e., the symbol table
@@ -302,7 +303,7 @@ class Symbol
 
 	// Symbol information, pointing to an internal position of the ELF
 	// file's buffer.
-	Elf32_Sym *info;
+	const Elf32_Sym *info;
 
 public:
 
@@ -323,12 +324,12 @@ public:
 	///
 	/// \param info_offset
 	///	Offset in ELF file content where the symbol is found.
-	Symbol(File *file, Section *section, unsigned info_offset);
+	Symbol(const File *file, Section *section, unsigned info_offset);
 
 	/// Return a pointer to the Elf32_Sym structure representing the
 	/// symbol. Each field of this structure can be queried with dedicated
 	/// getters instead.
-	Elf32_Sym *getRawInfo() const { return info; }
+	const Elf32_Sym *getRawInfo() const { return info; }
 
 	/// Return the section associated with the symbol
 	Section *getSection() const { return section; }
@@ -355,11 +356,11 @@ public:
 	/// symbol, if any.
 	const char *getBuffer() const { return buffer; }
 
-	/// Modify an input stream to hold the content pointed to by the symbol,
-	/// without involving any copy operations.
+	/// Fill an input stream with the content pointed to by the symbol.
+	/// The content is copied, since the file content is read-only.
 	///
 	/// \param stream
-	///	Input stream whose internal pointers will be modified.
+	///	Input stream whose content will be replaced.
 	///
 	/// \param offset
 	///	Offset in the symbol content that the stream will point to.
@@ -383,53 +384,73 @@ public:
 /// Class representing an input ELF file. The class contains constructors to
 /// load an ELF file from a file system or from a buffer in memory. It also
 /// contains functions to traverse its sections, segments, or symbols.
+///
+/// A file loaded from the file system is mapped in memory instead of copied,
+/// and all File objects loaded from the same path share one mapping while any
+/// of them exists. Only the ELF header is interpreted when the file is
+/// loaded. The section, program header, and symbol lists are populated the
+/// first time they are accessed, so errors in them are reported at that
+/// point.
 class File
 {
 	// Read the ELF header
 	void ReadHeader();
 
-	// Populate the section list
-	void ReadSections();
+	// Populate the section list, if not done yet
+	void ReadSections() const;
 
-	// Populate the program header list
-	void ReadProgramHeaders();
+	// Populate the program header list, if not done yet
+	void ReadProgramHeaders() const;
 
-	// Populate the symbol list
-	void ReadSymbols();
+	// Populate the symbol list, if not done yet
+	void ReadSymbols() const;
 
 	// Path if loaded from a file
 	std::string path;
 
-	// Content of the ELF file
-	std::unique_ptr<char[]> buffer;
+	// Mapping of the file content, if loaded from the file system
+	std::shared_ptr<Mapping> mapping;
+
+	// Copy of the file content, if loaded from a buffer
+	std::unique_ptr<char[]> copy;
+
+	// Content of the ELF file, pointing to the mapping or the copy
+	const char *buffer = nullptr;
 
 	// Total size of the ELF file
 	unsigned size;
 
-	// Stream pointing to the file content
-	std::istringstream stream;
-
 	// ELF header
-	Elf32_Ehdr *info;
+	const Elf32_Ehdr *info;
+
+	// Whether the content beyond the ELF header should be interpreted
+	bool read_content;
+
+	// Whether each list was already populated
+	mutable bool sections_read = false;
+	mutable bool program_headers_read = false;
+	mutable bool symbols_read = false;
 
 	// String table section
-	Section *string_table;
+	mutable Section *string_table = nullptr;
 
 	// List of sections
-	std::vector<std::unique_ptr<Section>> sections;
+	mutable std::vector<std::unique_ptr<Section>> sections;
 
 	// List of program headers
-	std::vector<std::unique_ptr<ProgramHeader>> program_headers;
+	mutable std::vector<std::unique_ptr<ProgramHeader>> program_headers;
 
 	// List of symbols
-	std::vector<std::unique_ptr<Symbol>> symbols;
+	mutable std::vector<std::unique_ptr<Symbol>> symbols;
 
 public:
 
 	/// Load an ELF file from the file system.
 	///
 	/// \param path
-	///	Path to load the ELF file from.
+	///	Path to load the ELF file from. The file is mapped in memory,
+	///	sharing the mapping with other ELF files loaded from the same
+	///	path, as long as the file was not modified in between.
 	///
 	/// \param read_content
 	///	If true (or omitted), interpret the entire content of the ELF
@@ -462,12 +483,17 @@ public:
 	const std::string &getPath() const { return path; }
 
 	/// Return the number of sections
-	int getNumSections() const { return sections.size(); }
+	int getNumSections() const
+	{
+		ReadSections();
+		return sections.size();
+	}
 
 	/// Return the section at position \a index, or \a null if the
 	/// value given in \a index is out of range.
 	Section *getSection(int index) const
 	{
+		ReadSections();
 		return index >= 0 && index < (int) sections.size() ?
 				sections[index].get() :
 				nullptr;
@@ -485,16 +511,22 @@ public:
 	/// \endcode
 	const std::vector<std::unique_ptr<Section>> &getSections() const
 	{
+		ReadSections();
 		return sections;
 	}
 
 	/// Return the number of program headers
-	int getNumProgramHeaders() const { return program_headers.size(); }
+	int getNumProgramHeaders() const
+	{
+		ReadProgramHeaders();
+		return program_headers.size();
+	}
 
 	/// Return the program header at position \a index, or \a null if
 	/// the value given in \a index is out of range.
 	ProgramHeader *getProgramHeader(int index) const
 	{
+		ReadProgramHeaders();
 		return index >= 0 && index < (int) program_headers.size() ?
 				program_headers[index].get() :
 				nullptr;
@@ -505,16 +537,22 @@ public:
 	const std::vector<std::unique_ptr<ProgramHeader>>
 			&getProgramHeaders() const
 	{
+		ReadProgramHeaders();
 		return program_headers;
 	}
 
 	/// Return the number of symbols
-	int getNumSymbols() const { return symbols.size(); }
+	int getNumSymbols() const
+	{
+		ReadSymbols();
+		return symbols.size();
+	}
 
 	/// Return the symbol at position \a index, or \a null if the
 	/// value given in \a index is out of range.
 	Symbol *getSymbol(int index) const
 	{
+		ReadSymbols();
 		return index >= 0 && index < (int) symbols.size() ?
 				symbols[index].get() :
 				nullptr;
@@ -529,18 +567,28 @@ public:
 	/// iteration.
 	const std::vector<std::unique_ptr<Symbol>> &getSymbols() const
 	{
+		ReadSymbols();
 		return symbols;
 	}
 
 	/// Return the section corresponding to the string table, or \a null if
 	/// the ELF file doesn't contain one.
-	Section *getStringTable() const { return string_table; }
+	Section *getStringTable() const
+	{
+		ReadSections();
+		return string_table;
+	}
 
 	/// Return the total size of the file
 	unsigned int getSize() const { return size; }
 
 	/// Return a buffer to the content of the file
-	const char *getBuffer() const { return buffer.get(); }
+	const char *getBuffer() const { return buffer; }
+
+	/// Return the number of host files currently mapped in memory. ELF
+	/// files loaded from the same path share one mapping while any of
+	/// them is alive.
+	static int getNumMappings();
 
 	/// Obtain a subset (\a size bytes starting at position \a
 	/// offset) of the ELF file into the input string stream given in \a
@@ -566,7 +614,7 @@ public:
 			unsigned int &offset) const;
 
 	/// Return \a e_ident field of ELF header
-	unsigned char *getIdent() const { return info->e_ident; }
+	const unsigned char *getIdent() const { return info->e_ident; }
 	
 	/// Return \a e_type field of ELF header
 	Elf32_Half getType() const { return info->e_type; }
@@ -17,7 +17,10 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <csignal>
+#include <fstream>
+#include <sys/resource.h>
 
 #include <lib/cpp/IniFile.h>
 
@@ -30,6 +33,8 @@ namespace esim
 
 misc::Debug Engine::debug;
 
+std::string Engine::profile_path;
+
 std::unique_ptr<Engine> Engine::instance;
 
 const char *engine_err_finalization =
@@ -55,6 +60,7 @@ Engine::Engine() : timer("esim::Timer")
 {
 	// Initialize timer
 	timer.Start();
+	profile_start_ticks = ProfileRegion::getCurrentTicks();
 
 	// Create null event
 	null_event = RegisterEvent("Null event", nullptr, nullptr);
@@ -85,6 +91,29 @@ void Engine::SignalHandler(int signum)
 }
 
 
+void Engine::RunEventHandler(Event *event)
+{
+	// Run without profile
+	num_executed_events++;
+	EventHandler event_handler = event->getEventHandler();
+	if (!ProfileRegion::isActive())
+	{
+		event_handler(event, current_frame.get());
+		return;
+	}
+
+	// Time the handler, excluding the handlers executed synchronously
+	// within it, which record their own time
+	unsigned long long outer_nested_ticks = profile_nested_ticks;
+	profile_nested_ticks = 0;
+	unsigned long long start = ProfileRegion::getCurrentTicks();
+	event_handler(event, current_frame.get());
+	unsigned long long ticks = ProfileRegion::getCurrentTicks() - start;
+	event->addExecution(ticks - profile_nested_ticks);
+	profile_nested_ticks = outer_nested_ticks + ticks;
+}
+
+
 bool Engine::Drain(int max_events)
 {
 	// Keep track of the number of extracted events
@@ -121,8 +150,7 @@ bool Engine::Drain(int max_events)
 		num_events++;
 
 		// Run event handler
-		EventHandler event_handler = event->getEventHandler();
-		event_handler(event, current_frame.get());
+		RunEventHandler(event);
 
 		// Free frame
 		current_frame = nullptr;
@@ -156,8 +184,7 @@ void Engine::ProcessEndEvents()
 				event->getName().c_str());
 
 		// Run event handler with null frame
-		EventHandler event_handler = event->getEventHandler();
-		event_handler(event, current_frame.get());
+		RunEventHandler(event);
 
 		// Free frame
 		current_frame = nullptr;
@@ -238,8 +265,7 @@ void Engine::ProcessEvents()
 		event->decInFlight();
 
 		// Run event handler
-		EventHandler event_handler = event->getEventHandler();
-		event_handler(event, current_frame.get());
+		RunEventHandler(event);
 
 		// Reschedule if it is periodic
 		int period = current_frame->period;
@@ -412,8 +438,7 @@ void Engine::Execute(Event *event, std::shared_ptr<Frame> frame,
 	current_frame = frame;
 
 	// Execute event handler
-	EventHandler event_handler = event->getEventHandler();
-	event_handler(event, current_frame.get());
+	RunEventHandler(event);
 
 	// Restore previous current frame
 	current_frame = old_current_frame;
@@ -493,6 +518,176 @@ void Engine::ProcessAllEvents()
 }
 
 
+ProfileRegion *Engine::RegisterProfileRegion(const std::string &name)
+{
+	// Find existing region
+	for (auto &region : profile_regions)
+		if (region.getName() == name)
+			return &region;
+
+	// Create region
+	profile_regions.emplace_back(name);
+	return &profile_regions.back();
+}
+
+
+void Engine::DumpProfile()
+{
+	// No profile
+	if (profile_path.empty())
+		return;
+
+	// Open file
+	std::ofstream f(profile_path);
+	if (!f)
+		throw Error(misc::fmt("%s: Cannot open profile file",
+				profile_path.c_str()));
+	DumpProfile(f);
+}
+
+
+void Engine::DumpProfile(std::ostream &os)
+{
+	// Host ticks per millisecond, calibrated with the real time since the
+	// engine was created
+	long long real_time = std::max(getRealTime(), 1LL);
+	double ticks_per_ms = (double) (ProfileRegion::getCurrentTicks() -
+			profile_start_ticks) / real_time * 1000.0;
+	if (ticks_per_ms <= 0)
+		ticks_per_ms = 1.0;
+
+	// Peak resident memory of the host process
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	// Totals of a frequency domain
+	struct DomainProfile
+	{
+		std::string name;
+		long long count;
+		unsigned long long ticks;
+	};
+
+	// Executed events, and totals per frequency domain
+	std::vector<const Event *> executed_events;
+	std::vector<DomainProfile> domains;
+	long long total_count = 0;
+	unsigned long long total_ticks = 0;
+	for (auto &event : events)
+	{
+		// Skip events never executed
+		if (!event.getNumExecuted())
+			continue;
+		executed_events.push_back(&event);
+		total_count += event.getNumExecuted();
+		total_ticks += event.getHostTicks();
+
+		// Add to frequency domain
+		std::string domain_name = event.getFrequencyDomain() ?
+				event.getFrequencyDomain()->getName() : "End";
+		auto it = std::find_if(domains.begin(), domains.end(),
+				[&](const DomainProfile &domain)
+				{
+					return domain.name == domain_name;
+				});
+		if (it == domains.end())
+		{
+			domains.push_back({ domain_name, 0, 0 });
+			it = domains.end() - 1;
+		}
+		it->count += event.getNumExecuted();
+		it->ticks += event.getHostTicks();
+	}
+
+	// Sort by host time
+	std::stable_sort(executed_events.begin(), executed_events.end(),
+			[](const Event *a, const Event *b)
+			{
+				return a->getHostTicks() > b->getHostTicks();
+			});
+	std::stable_sort(domains.begin(), domains.end(),
+			[](const DomainProfile &a, const DomainProfile &b)
+			{
+				return a.ticks > b.ticks;
+			});
+	std::vector<const ProfileRegion *> regions;
+	for (auto &region : profile_regions)
+		if (region.getCount())
+			regions.push_back(&region);
+	std::stable_sort(regions.begin(), regions.end(),
+			[](const ProfileRegion *a, const ProfileRegion *b)
+			{
+				return a->getTicks() > b->getTicks();
+			});
+
+	// Header
+	os << "; Host profile of the simulator\n";
+	os << ";    Count - Number of executed event handlers, or number of "
+			"times a region ran\n";
+	os << ";    HostTime - Host time in milliseconds. The time of an "
+			"event handler excludes\n";
+	os << ";        the handlers executed synchronously within it. The "
+			"time of a region\n";
+	os << ";        includes the event handlers executed within it.\n";
+	os << ";    Percent - Fraction of the real time of the simulation\n";
+	os << '\n';
+
+	// General
+	os << "[ General ]\n";
+	os << misc::fmt("RealTime = %.2f [s]\n", real_time / 1.0e6);
+	os << misc::fmt("Events = %lld\n", total_count);
+	os << misc::fmt("EventHostTime = %.3f [ms]\n",
+			total_ticks / ticks_per_ms);
+	os << misc::fmt("PeakMemory = %ld [KB]\n", usage.ru_maxrss);
+	os << '\n';
+
+	// Frequency domains
+	os << "[ FrequencyDomains ]\n";
+	os << misc::fmt("; %-28s %12s %14s %8s\n", "Name", "Count",
+			"HostTime", "Percent");
+	for (auto &domain : domains)
+	{
+		double time = domain.ticks / ticks_per_ms;
+		os << misc::fmt("%-30s %12lld %14.3f %7.2f%%\n",
+				domain.name.c_str(),
+				domain.count, time,
+				time * 1.0e5 / real_time);
+	}
+	os << '\n';
+
+	// Events
+	os << "[ Events ]\n";
+	os << misc::fmt("; %-28s %-12s %12s %14s %8s\n", "Name", "Domain",
+			"Count", "HostTime", "Percent");
+	for (const Event *event : executed_events)
+	{
+		double time = event->getHostTicks() / ticks_per_ms;
+		os << misc::fmt("%-30s %-12s %12lld %14.3f %7.2f%%\n",
+				event->getName().c_str(),
+				event->getFrequencyDomain() ?
+				event->getFrequencyDomain()->getName().c_str() :
+				"End",
+				event->getNumExecuted(), time,
+				time * 1.0e5 / real_time);
+	}
+	os << '\n';
+
+	// Regions
+	os << "[ Regions ]\n";
+	os << misc::fmt("; %-28s %12s %14s %8s\n", "Name", "Count",
+			"HostTime", "Percent");
+	for (const ProfileRegion *region : regions)
+	{
+		double time = region->getTicks() / ticks_per_ms;
+		os << misc::fmt("%-30s %12lld %14.3f %7.2f%%\n",
+				region->getName().c_str(),
+				region->getCount(), time,
+				time * 1.0e5 / real_time);
+	}
+	os << '\n';
+}
+
+
 
 }  // namespace esim
 
@@ -36,6 +36,7 @@
 #include "Event.h"
 #include "Frame.h"
 #include "FrequencyDomain.h"
+#include "Profile.h"
 
 
 namespace esim
@@ -69,6 +70,9 @@ class Engine
 	/// Debugger
 	static misc::Debug debug;
 
+	// File for the simulator profile
+	static std::string profile_path;
+
 	// Flag set when simulation should finish
 	bool finish = false;
 
@@ -87,6 +91,17 @@ class Engine
 	// Registered frequency domains
 	std::list<FrequencyDomain> frequency_domains;
 
+	// Registered profile regions
+	std::list<ProfileRegion> profile_regions;
+
+	// Host ticks when the engine was created, used to convert ticks into
+	// time in the simulator profile
+	unsigned long long profile_start_ticks = 0;
+
+	// Host ticks spent in event handlers executed synchronously within the
+	// event handler currently running, excluded from its profile
+	unsigned long long profile_nested_ticks = 0;
+
 	// Heap of pending events
 	std::priority_queue<std::shared_ptr<Frame>,
 			std::vector<std::shared_ptr<Frame>>,
@@ -118,6 +133,9 @@ class Engine
 	// of Frame instances
 	long long schedule_sequence_counter = 0;
 
+	// Number of event handlers executed
+	long long num_executed_events = 0;
+
 	// Number of in-flight events before a warning is shown (10k events)
 	const int max_inflight_events = 10000;
 
@@ -144,6 +162,10 @@ class Engine
 	// Process all events scheduled with a previous call to EndEvent()
 	void ProcessEndEvents();
 
+	// Run the handler of an event with the current frame, recording its
+	// host time if the simulator profile is active
+	void RunEventHandler(Event *event);
+
 public:
 
 	// Constructor
@@ -195,6 +217,12 @@ public:
 	/// Return the current simulated time in picoseconds.
 	long long getTime() const { return current_time; }
 
+	/// Return the number of event handlers executed so far
+	long long getNumExecutedEvents() const { return num_executed_events; }
+
+	/// Return the number of events currently scheduled in the event heap
+	int getNumInFlightEvents() const { return heap.size(); }
+
 	/// Return the current cycle in the fastest registered frequency domain.
 	/// At least one frequency domain must have been registered.
 	long long getCycle() const
@@ -415,6 +443,33 @@ public:
 		debug.setPath(path);
 		debug.setPrefix("[esim]");
 	}
+
+	/// Activate the simulator profile, which records the number of
+	/// executed events and the host time spent in their handlers and in
+	/// the registered profile regions. The report is dumped into \a path
+	/// with a call to DumpProfile().
+	static void setProfilePath(const std::string &path)
+	{
+		profile_path = path;
+		ProfileRegion::Activate();
+	}
+
+	/// Register a new profile region, timed with objects of class
+	/// ProfileScope. Regions with the same name are registered only once.
+	///
+	/// \param name
+	///	Name of the region, such as 'x86::Core::Fetch'
+	///
+	/// \return
+	///	The profile region
+	ProfileRegion *RegisterProfileRegion(const std::string &name);
+
+	/// Dump the simulator profile into the file given in
+	/// setProfilePath(), if any.
+	void DumpProfile();
+
+	/// Dump the simulator profile into an output stream
+	void DumpProfile(std::ostream &os);
 };
 
 
@@ -54,6 +54,11 @@ class Event
 	// Current number of scheduled events of this type
 	int num_in_flight = 0;
 
+	// Number of executed handlers and host ticks spent in them, only
+	// recorded when the simulator profile is active
+	long long num_executed = 0;
+	unsigned long long host_ticks = 0;
+
 public:
 
 	/// Constructor
@@ -89,6 +94,21 @@ public:
 
 	/// Decrease the number of in-flight events of this type by one.
 	void decInFlight() { num_in_flight--; }
+
+	/// Record one execution of the event handler taking \a ticks host
+	/// ticks. Only used when the simulator profile is active.
+	void addExecution(unsigned long long ticks)
+	{
+		num_executed++;
+		host_ticks += ticks;
+	}
+
+	/// Return the number of executed event handlers recorded with
+	/// addExecution()
+	long long getNumExecuted() const { return num_executed; }
+
+	/// Return the host ticks recorded with addExecution()
+	unsigned long long getHostTicks() const { return host_ticks; }
 };
 
 }  // namespace esim
@@ -0,0 +1,131 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_CPP_ESIM_PROFILE_H
+#define LIB_CPP_ESIM_PROFILE_H
+
+#include <string>
+
+#include <ctime>
+
+
+namespace esim
+{
+
+/// Region of the simulator code whose host time is measured when the
+/// simulator profile is active, such as a stage of a processor pipeline.
+/// Regions should be instantiated with calls to
+/// Engine::RegisterProfileRegion(), and timed with objects of class
+/// ProfileScope.
+class ProfileRegion
+{
+	// Whether the simulator profile is active
+	static bool active;
+
+	// Name of the region
+	std::string name;
+
+	// Number of times the region was timed
+	long long count = 0;
+
+	// Host ticks spent in the region
+	unsigned long long ticks = 0;
+
+public:
+
+	/// Constructor
+	ProfileRegion(const std::string &name) : name(name)
+	{
+	}
+
+	/// Return whether the simulator profile is active
+	static bool isActive() { return active; }
+
+	/// Activate the simulator profile
+	static void Activate() { active = true; }
+
+	/// Deactivate the simulator profile
+	static void Deactivate() { active = false; }
+
+	/// Return the current value of the host tick counter. This is the
+	/// time stamp counter on x86 hosts, and the monotonic clock in
+	/// nanoseconds otherwise.
+	static unsigned long long getCurrentTicks()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		return __builtin_ia32_rdtsc();
+#else
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (unsigned long long) ts.tv_sec * 1000000000 +
+				ts.tv_nsec;
+#endif
+	}
+
+	/// Return the name of the region
+	const std::string &getName() const { return name; }
+
+	/// Return the number of times the region was timed
+	long long getCount() const { return count; }
+
+	/// Return the host ticks spent in the region
+	unsigned long long getTicks() const { return ticks; }
+
+	/// Record one execution of the region taking \a ticks host ticks
+	void Add(unsigned long long ticks)
+	{
+		count++;
+		this->ticks += ticks;
+	}
+};
+
+
+/// Object measuring the host time between its construction and destruction
+/// into a profile region, only if the simulator profile is active.
+class ProfileScope
+{
+	// Region, or null if the profile is not active
+	ProfileRegion *region;
+
+	// Host ticks when the object was constructed
+	unsigned long long start = 0;
+
+public:
+
+	/// Constructor
+	ProfileScope(ProfileRegion *region) :
+			region(ProfileRegion::isActive() ? region : nullptr)
+	{
+		if (this->region)
+			start = ProfileRegion::getCurrentTicks();
+	}
+
+	/// Destructor
+	~ProfileScope()
+	{
+		if (region)
+			region->Add(ProfileRegion::getCurrentTicks() - start);
+	}
+};
+
+
+}  // namespace esim
+
+#endif
+
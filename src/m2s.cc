@@ -17,9 +17,19 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <arch/common/CallStack.h>
 #include <arch/common/Driver.h>
@@ -64,6 +74,15 @@ extern "C"
 // Configuration options
 //
 
+// File with the option variants of a batch simulation
+std::string m2s_batch_file;
+
+// Number of x86 instructions emulated before forking batch variants
+long long m2s_batch_fork_at = 0;
+
+// Maximum number of batch variants running at a time, or 0 for no limit
+int m2s_batch_jobs = 0;
+
 // Context configuration file
 std::string m2s_context_config;
 
@@ -73,6 +92,15 @@ std::string m2s_cuda_debug;
 // Event-driven simulator debugger
 std::string m2s_debug_esim;
 
+// Simulator profile file
+std::string m2s_esim_profile;
+
+// Interval in seconds between heartbeats, or 0 for no heartbeat
+long long m2s_heartbeat = 0;
+
+// File where heartbeat statistics are dumped
+std::string m2s_heartbeat_file;
+
 // Inifile debugger
 std::string m2s_debug_inifile;
 
@@ -107,6 +135,39 @@ std::string m2s_visual_file;
 // Number of iterations in the main simulation loop
 long long m2s_loop_iterations = 0;
 
+// Options of each batch variant, read from the batch file
+std::vector<std::vector<std::string>> m2s_batch_variants;
+
+// Names of the options that batch variants can override. These are the
+// options of the modules whose options are processed again in each variant.
+std::unordered_set<std::string> m2s_batch_options;
+
+// Whether batch variants were forked from this process
+bool m2s_batch_forked = false;
+
+// Index of the batch variant simulated by this process, or -1 if this is not
+// a batch variant
+int m2s_batch_variant = -1;
+
+// Exit code of each batch variant, collected in the parent process
+std::vector<int> m2s_batch_exit_codes;
+
+// Output stream for the heartbeat statistics file
+std::ofstream m2s_heartbeat_stream;
+
+// Number of heartbeats
+int m2s_heartbeat_count = 0;
+
+// Real time, cycle, and number of executed events at the last heartbeat
+long long m2s_heartbeat_last_time = 0;
+long long m2s_heartbeat_last_cycle = 0;
+long long m2s_heartbeat_last_events = 0;
+
+// Emulated and committed instructions of each architecture at the last
+// heartbeat
+std::unordered_map<comm::Arch *, std::pair<long long, long long>>
+		m2s_heartbeat_last_instructions;
+
 
 
 
@@ -154,7 +215,9 @@ void LoadProgram(const std::vector<std::string> &arguments,
 	if (arguments.size() == 0)
 		return;
 	
-	// Choose emulator based on ELF header
+	// Choose emulator based on ELF header. The file is kept alive until
+	// the program is loaded below, so that the emulator's loader reuses
+	// its mapping instead of mapping the executable again.
 	std::string exe = misc::getFullPath(arguments[0], current_directory);
 	ELFReader::File elf_file(exe, false);
 	comm::Emulator *emulator;
@@ -264,6 +327,39 @@ void RegisterOptions()
 	// Set category for following options
 	command_line->setCategory("default", "General Multi2Sim Options");
 
+	// Batch simulation
+	command_line->RegisterString("--batch <file>",
+			m2s_batch_file,
+			"Run a batch of simulations sharing the loading and "
+			"functional emulation of the guest programs. Each line "
+			"of <file> contains the command-line options of one "
+			"variant, such as '--x86-sim detailed --x86-config "
+			"cpu.ini --mem-config mem.ini --x86-report x86.txt'. "
+			"Empty lines and lines starting with '#' or ';' are "
+			"ignored. Multi2Sim emulates the guest programs "
+			"functionally up to the instruction given in "
+			"'--batch-fork-at', and then forks one process per "
+			"variant, which continues the simulation with its own "
+			"options and dumps its own reports. Guest memory is "
+			"shared among processes with copy-on-write. Variants "
+			"can only override options of the x86 and Southern "
+			"Islands timing simulators, the memory system, and the "
+			"network, and any other option is rejected.");
+
+	// Batch fork point
+	command_line->RegisterInt64("--batch-fork-at <num_inst> "
+			"(default = 0)",
+			m2s_batch_fork_at,
+			"Number of x86 instructions emulated before forking the "
+			"variants of option '--batch'.");
+
+	// Batch jobs
+	command_line->RegisterInt32("--batch-jobs <num> (default = 0)",
+			m2s_batch_jobs,
+			"Maximum number of variants of option '--batch' running "
+			"at the same time. A value of 0 (default) runs all "
+			"variants at once.");
+
 	// Debugger for call stack
 	command_line->RegisterString("--call-debug <file>",
 			m2s_debug_callstack,
@@ -285,7 +381,37 @@ void RegisterOptions()
 			m2s_debug_esim,
 			"Dump debug information related with the event-driven "
 			"simulation engine.");
+
+	// Simulator profile
+	command_line->RegisterString("--esim-profile <file>",
+			m2s_esim_profile,
+			"Profile the host execution of the simulator, and dump "
+			"a report into <file> at the end of the simulation. "
+			"The report shows the number of executed events and "
+			"the host time spent in their handlers, per event and "
+			"per frequency domain, the host time spent in each "
+			"stage of the modeled pipelines, and the peak memory "
+			"used by the simulator, sorted by host time.");
 	
+	// Heartbeat
+	command_line->RegisterInt64("--heartbeat <time> (default = 0)",
+			m2s_heartbeat,
+			"Print a heartbeat every <time> seconds of real time "
+			"with the throughput of the simulation since the "
+			"previous heartbeat: simulated cycles per second, "
+			"executed events per second, events in flight, "
+			"resident memory of the simulator, and emulated and "
+			"committed instructions per second of each "
+			"architecture. A value of 0 (default) disables the "
+			"heartbeat.");
+
+	// Heartbeat file
+	command_line->RegisterString("--heartbeat-file <file>",
+			m2s_heartbeat_file,
+			"Dump the statistics of each heartbeat into <file> in "
+			"INI format, with one section per heartbeat. This "
+			"option requires option '--heartbeat'.");
+
 	// Debugger for Inifile parser
 	command_line->RegisterString("--inifile-debug <file>",
 			m2s_debug_inifile,
@@ -388,6 +514,10 @@ void ProcessOptions()
 	if (!m2s_debug_esim.empty())
 		esim::Engine::setDebugPath(m2s_debug_esim);
 
+	// Simulator profile
+	if (!m2s_esim_profile.empty())
+		esim::Engine::setProfilePath(m2s_esim_profile);
+
 	// Inifile debugger
 	if (!m2s_debug_inifile.empty())
 		misc::IniFile::setDebugPath(m2s_debug_inifile);
@@ -414,7 +544,47 @@ void ProcessOptions()
 	// Visualization
 	if (!m2s_visual_file.empty())
 		visual_run(m2s_visual_file.c_str());
-		
+
+	// Batch file
+	if (!m2s_batch_file.empty())
+	{
+		std::ifstream f(m2s_batch_file);
+		if (!f)
+			throw misc::Error(misc::fmt("%s: Cannot open batch file",
+					m2s_batch_file.c_str()));
+		std::string line;
+		while (std::getline(f, line))
+		{
+			misc::StringTrim(line);
+			if (line.empty() || line[0] == '#' || line[0] == ';')
+				continue;
+			m2s_batch_variants.emplace_back();
+			misc::StringTokenize(line, m2s_batch_variants.back());
+		}
+		if (m2s_batch_variants.empty())
+			throw misc::Error(misc::fmt("%s: No variants in batch "
+					"file", m2s_batch_file.c_str()));
+	}
+
+	// Heartbeat
+	if (m2s_heartbeat < 0)
+		throw misc::Error("Invalid value for '--heartbeat'");
+	if (!m2s_heartbeat_file.empty())
+	{
+		if (!m2s_heartbeat)
+			throw misc::Error("Option '--heartbeat-file' requires "
+					"option '--heartbeat'");
+		m2s_heartbeat_stream.open(m2s_heartbeat_file);
+		if (!m2s_heartbeat_stream)
+			throw misc::Error(misc::fmt("%s: Cannot open heartbeat "
+					"file", m2s_heartbeat_file.c_str()));
+	}
+
+	// Batch options
+	if (m2s_batch_fork_at < 0)
+		throw misc::Error("Invalid value for '--batch-fork-at'");
+	if (m2s_batch_jobs < 0)
+		throw misc::Error("Invalid value for '--batch-jobs'");
 }
 
 
@@ -453,6 +623,234 @@ void RegisterDrivers()
 }
 
 
+// Return the resident memory of the simulator process in KB, or 0 if it is
+// not available in the host
+long long GetResidentMemory()
+{
+	std::ifstream f("/proc/self/statm");
+	long long size;
+	long long resident;
+	if (!(f >> size >> resident))
+		return 0;
+	return resident * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+
+// Print a heartbeat with the throughput of the simulation since the previous
+// one, and dump its statistics into the heartbeat file, if any
+void Heartbeat()
+{
+	// Interval since the last heartbeat
+	esim::Engine *esim = esim::Engine::getInstance();
+	long long time = esim->getRealTime();
+	double interval = (double) std::max(time - m2s_heartbeat_last_time,
+			1LL) / 1.0e6;
+
+	// Event-driven simulation. The cycle is only valid after events were
+	// processed with some frequency domain registered.
+	long long cycle = esim->getTime() ? esim->getCycle() : 0;
+	long long events = esim->getNumExecutedEvents();
+	double cycles_per_second = (cycle - m2s_heartbeat_last_cycle) /
+			interval;
+	double events_per_second = (events - m2s_heartbeat_last_events) /
+			interval;
+	long long resident_memory = GetResidentMemory();
+	std::string line = misc::fmt("[Heartbeat] %.0f s: %.0f cycles/s, "
+			"%.0f events/s, %d events in flight, %lld KB",
+			time / 1.0e6,
+			cycles_per_second,
+			events_per_second,
+			esim->getNumInFlightEvents(),
+			resident_memory);
+	std::ostringstream stats;
+	stats << misc::fmt("[ Heartbeat %d ]\n", m2s_heartbeat_count);
+	stats << misc::fmt("RealTime = %.2f\n", time / 1.0e6);
+	stats << misc::fmt("Cycles = %lld\n", cycle);
+	stats << misc::fmt("CyclesPerSecond = %.0f\n", cycles_per_second);
+	stats << misc::fmt("Events = %lld\n", events);
+	stats << misc::fmt("EventsPerSecond = %.0f\n", events_per_second);
+	stats << misc::fmt("InFlightEvents = %d\n",
+			esim->getNumInFlightEvents());
+	stats << misc::fmt("ResidentMemory = %lld\n", resident_memory);
+
+	// Architectures with an active emulator
+	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	for (auto &arch : *arch_pool)
+	{
+		// Skip architectures not running
+		comm::Emulator *emulator = arch->getEmulator();
+		if (!emulator || !emulator->getNumInstructions())
+			continue;
+
+		// Instructions
+		comm::Timing *timing = arch->getTiming();
+		long long instructions = emulator->getNumInstructions();
+		long long committed_instructions = timing ?
+				timing->getNumCommittedInstructions() : 0;
+		auto &last = m2s_heartbeat_last_instructions[arch.get()];
+		double instructions_per_second = (instructions - last.first) /
+				interval;
+		double committed_instructions_per_second =
+				(committed_instructions - last.second) /
+				interval;
+		last.first = instructions;
+		last.second = committed_instructions;
+
+		// Dump
+		const std::string &name = arch->getName();
+		line += misc::fmt("; %s: %.0f inst/s", name.c_str(),
+				instructions_per_second);
+		if (timing)
+			line += misc::fmt(", %.0f committed/s",
+					committed_instructions_per_second);
+		stats << misc::fmt("%s.Instructions = %lld\n", name.c_str(),
+				instructions);
+		stats << misc::fmt("%s.InstructionsPerSecond = %.0f\n",
+				name.c_str(), instructions_per_second);
+		stats << misc::fmt("%s.CommittedInstructions = %lld\n",
+				name.c_str(), committed_instructions);
+		stats << misc::fmt("%s.CommittedInstructionsPerSecond = %.0f\n",
+				name.c_str(),
+				committed_instructions_per_second);
+	}
+
+	// Print heartbeat
+	std::cerr << line << '\n';
+	if (m2s_heartbeat_stream.is_open())
+	{
+		m2s_heartbeat_stream << stats.str() << '\n';
+		m2s_heartbeat_stream.flush();
+	}
+
+	// Save values for next heartbeat
+	m2s_heartbeat_count++;
+	m2s_heartbeat_last_time = time;
+	m2s_heartbeat_last_cycle = cycle;
+	m2s_heartbeat_last_events = events;
+}
+
+
+// Register the command-line options of a module with the given function,
+// recording them as options that batch variants can override
+void RegisterBatchOptions(void (*register_options)())
+{
+	misc::CommandLine *command_line = misc::CommandLine::getInstance();
+	int first_option = command_line->getNumOptions();
+	register_options();
+	for (int i = first_option; i < command_line->getNumOptions(); i++)
+		m2s_batch_options.insert(command_line->getOptionName(i));
+}
+
+
+// Apply the option overrides of the batch variant simulated by this process.
+// Only options of detailed simulation, memory, and network can be
+// overridden, since only their options are processed again after forking.
+void ApplyBatchVariant()
+{
+	// Override command-line options
+	assert(m2s_batch_variant >= 0);
+	misc::CommandLine *command_line = misc::CommandLine::getInstance();
+	command_line->ProcessOverrides(m2s_batch_variants[m2s_batch_variant],
+			&m2s_batch_options);
+
+	// Process options of detailed simulation
+	x86::Timing::ProcessOptions();
+	SI::Timing::ProcessOptions();
+	mem::System::ProcessOptions();
+	net::System::ProcessOptions();
+	if (net::System::isStandAlone() || dram::System::isStandAlone() ||
+			mem::System::isTraceDriven())
+		throw misc::Error(misc::fmt("Batch variant %d: Stand-alone "
+				"and trace-driven simulations are not "
+				"supported", m2s_batch_variant));
+
+	// Existing x86 contexts emit micro-instructions if the variant runs a
+	// detailed simulation
+	x86::Emulator *emulator = x86::Emulator::getInstance();
+	bool uinst_active = x86::Timing::getSimKind() ==
+			comm::Arch::SimDetailed;
+	for (auto it = emulator->getContextsBegin(),
+			e = emulator->getContextsEnd(); it != e; ++it)
+		(*it)->setUinstActive(uinst_active);
+
+	// Read network and memory configuration
+	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	if (arch_pool->getNumTiming())
+	{
+		net::System *net_system = net::System::getInstance();
+		net_system->ReadConfiguration();
+		mem::System *memory_system = mem::System::getInstance();
+		memory_system->ReadConfiguration();
+	}
+}
+
+
+// Fork one process per batch variant and wait for them. Returns in the child
+// processes, after applying the options of their variant, and in the parent
+// process, after all children finished.
+void RunBatch()
+{
+	// Flush output streams, so that buffered output is not duplicated in
+	// child processes
+	std::cout.flush();
+	std::cerr.flush();
+	fflush(nullptr);
+
+	// Launch variants
+	x86::Emulator *emulator = x86::Emulator::getInstance();
+	int num_variants = m2s_batch_variants.size();
+	int max_jobs = m2s_batch_jobs ? m2s_batch_jobs : num_variants;
+	std::unordered_map<pid_t, int> children;
+	m2s_batch_exit_codes.assign(num_variants, -1);
+	m2s_batch_forked = true;
+	int next_variant = 0;
+	while (next_variant < num_variants || children.size())
+	{
+		// Fork next variant
+		if (next_variant < num_variants &&
+				(int) children.size() < max_jobs)
+		{
+			emulator->LockMutex();
+			pid_t pid = fork();
+			if (!pid)
+			{
+				emulator->ResumeAfterFork();
+				emulator->UnlockMutex();
+				m2s_batch_variant = next_variant;
+				ApplyBatchVariant();
+				return;
+			}
+			emulator->UnlockMutex();
+			if (pid < 0)
+				throw misc::Error("Cannot create process for "
+						"batch variant");
+			children[pid] = next_variant++;
+			continue;
+		}
+
+		// Wait for a variant to finish
+		int status;
+		pid_t pid = wait(&status);
+		if (pid < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw misc::Error("Unexpected error waiting for batch "
+					"variants");
+		}
+		auto it = children.find(pid);
+		if (it == children.end())
+			continue;
+		m2s_batch_exit_codes[it->second] = WIFEXITED(status) ?
+				WEXITSTATUS(status) : 128 + WTERMSIG(status);
+		children.erase(it);
+	}
+
+	// The parent process finishes simulation
+	esim::Engine::getInstance()->Finish("BatchFinished");
+}
+
+
 void MainLoop()
 {
 	// Activate signal handler
@@ -465,6 +863,16 @@ void MainLoop()
 	// Simulation loop
 	while (!esim->hasFinished())
 	{
+		// Fork batch variants once the functional emulation reaches the
+		// fork point
+		if (!m2s_batch_variants.empty() && !m2s_batch_forked &&
+				x86::Emulator::getInstance()->getNumInstructions()
+				>= m2s_batch_fork_at)
+		{
+			RunBatch();
+			continue;
+		}
+
 		// Run iteration for all architectures. This function returns
 		// the number of architectures actively running emulation, as
 		// well as the number of architectures running an active timing
@@ -494,6 +902,13 @@ void MainLoop()
 				&& !(m2s_loop_iterations & ((1 << 17) - 1))
 				&& esim->getRealTime() > m2s_max_time * 1000000)
 			esim->Finish("MaxTime");
+
+		// Heartbeat, checking the real time only every 4k iterations
+		if (m2s_heartbeat > 0
+				&& !(m2s_loop_iterations & ((1 << 12) - 1))
+				&& esim->getRealTime() >= m2s_heartbeat_last_time
+				+ m2s_heartbeat * 1000000)
+			Heartbeat();
 	}
 
 	// Process all remaining events
@@ -527,6 +942,8 @@ void DumpStatisticsSummary(std::ostream &os = std::cerr)
 	os << "[ General ]\n";
 	os << misc::fmt("RealTime = %.2f [s]\n", time_in_seconds);
 	os << "SimEnd = " << esim_engine->getFinishReason() << '\n';
+	if (m2s_batch_variant >= 0)
+		os << "BatchVariant = " << m2s_batch_variant << '\n';
 
 	// General detailed simulation statistics
 	if (esim_engine->getTime())
@@ -548,6 +965,45 @@ void DumpStatisticsSummary(std::ostream &os = std::cerr)
 	misc::Terminal::Reset(os);
 }
 
+void DumpBatchSummary(std::ostream &os = std::cerr)
+{
+	// Print in blue
+	misc::Terminal::Blue(os);
+
+	// Header
+	os << '\n' << ";\n"
+			<< "; Batch Summary\n"
+			<< ";\n"
+			<< "\n";
+
+	// General statistics
+	int num_failed = 0;
+	for (int exit_code : m2s_batch_exit_codes)
+		if (exit_code)
+			num_failed++;
+	os << "[ Batch ]\n";
+	os << misc::fmt("ForkAt = %lld\n", m2s_batch_fork_at);
+	os << misc::fmt("Variants = %d\n", (int) m2s_batch_variants.size());
+	os << misc::fmt("Failed = %d\n", num_failed);
+	os << '\n';
+
+	// Variants
+	for (unsigned i = 0; i < m2s_batch_variants.size(); i++)
+	{
+		os << misc::fmt("[ Variant %d ]\n", i);
+		os << "Options =";
+		for (auto &option : m2s_batch_variants[i])
+			os << ' ' << option;
+		os << '\n';
+		os << misc::fmt("ExitCode = %d\n", m2s_batch_exit_codes[i]);
+		os << '\n';
+	}
+
+	// Reset terminal color
+	misc::Terminal::Reset(os);
+}
+
+
 void DumpReports()
 {
 	// Reports for all architectures
@@ -576,6 +1032,10 @@ void DumpReports()
 		// Dump the network routing table
 		net_system->DumpRoutes();
 	}
+
+	// Simulator profile
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	esim_engine->DumpProfile();
 }
 
 
@@ -599,13 +1059,13 @@ int MainProgram(int argc, char **argv)
 	SI::Driver::RegisterOptions();
 	SI::Disassembler::RegisterOptions();
 	SI::Emulator::RegisterOptions();
-	SI::Timing::RegisterOptions();
+	RegisterBatchOptions(SI::Timing::RegisterOptions);
 	x86::Disassembler::RegisterOptions();
 	x86::Emulator::RegisterOptions();
-	x86::Timing::RegisterOptions();
-	mem::System::RegisterOptions();
+	RegisterBatchOptions(x86::Timing::RegisterOptions);
+	RegisterBatchOptions(mem::System::RegisterOptions);
 	dram::System::RegisterOptions();
-	net::System::RegisterOptions();
+	RegisterBatchOptions(net::System::RegisterOptions);
 	ARM::Disassembler::RegisterOptions();
 	ARM::Emulator::RegisterOptions();
 
@@ -678,6 +1138,33 @@ int MainProgram(int argc, char **argv)
 		memory_system->ReadConfiguration();
 	}
 
+	// Trace-driven simulation of the memory system, only if the option
+	// --mem-trace is used
+	if (mem::System::isTraceDriven())
+	{
+		if (arch_pool->getNumTiming() || net::System::isStandAlone() ||
+				dram::System::isStandAlone())
+			throw misc::Error("Option '--mem-trace' cannot be used "
+					"together with other detailed or "
+					"stand-alone simulations");
+		net::System *net_system = net::System::getInstance();
+		net_system->ReadConfiguration();
+		mem::System *memory_system = mem::System::getInstance();
+		memory_system->ReadConfiguration();
+		memory_system->TraceSimulation();
+	}
+
+	// Batch simulation forks detailed simulations from a functional
+	// emulation
+	if (!m2s_batch_variants.empty() && (arch_pool->getNumTiming() ||
+			net::System::isStandAlone() ||
+			dram::System::isStandAlone() ||
+			mem::System::isTraceDriven()))
+		throw misc::Error("Option '--batch' requires functional "
+				"emulation before the fork point. Give "
+				"detailed simulation options in the batch "
+				"variants.");
+
 	// Initialize network system, only if the option --net-sim is used
 	if (net::System::isStandAlone())
 	{
@@ -704,6 +1191,24 @@ int MainProgram(int argc, char **argv)
 	// Main simulation loop
 	MainLoop();
 
+	// The parent process of a batch simulation only reports its variants
+	if (m2s_batch_forked && m2s_batch_variant < 0)
+	{
+		DumpBatchSummary();
+		for (int exit_code : m2s_batch_exit_codes)
+			if (exit_code)
+				return 1;
+		return 0;
+	}
+	else if (!m2s_batch_variants.empty() && !m2s_batch_forked)
+	{
+		throw misc::Error(misc::fmt("Guest programs finished after "
+				"%lld x86 instructions, before the fork point "
+				"given in '--batch-fork-at'",
+				x86::Emulator::getInstance()->
+				getNumInstructions()));
+	}
+
 	// Statistics summary
 	DumpStatisticsSummary();
 
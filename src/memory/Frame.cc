@@ -36,10 +36,7 @@ Frame::Frame(long long id, Module *module, unsigned address) :
 		module(module),
 		address(address)
 {
-	// Initialize iterators to past-the-end iterators
 	assert(module);
-	accesses_iterator = module->getAccessListEnd();
-	write_accesses_iterator = module->getWriteAccessListEnd();
 }
 
 
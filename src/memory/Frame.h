@@ -20,7 +20,6 @@
 #ifndef MEMORY_FRAME_H
 #define MEMORY_FRAME_H
 
-#include <list>
 #include <memory>
 
 #include <lib/esim/Event.h>
@@ -92,6 +91,17 @@ public:
 		MessageClearOwner
 	};
 
+	/// Class of the messages sent through interconnects. Each class is
+	/// mapped to a different virtual channel on links that have enough
+	/// of them, so that replies and evictions are not blocked behind
+	/// requests.
+	enum NetworkClass
+	{
+		NetworkClassRequest = 0,
+		NetworkClassReply,
+		NetworkClassEviction
+	};
+
 
 
 	
@@ -103,13 +113,28 @@ public:
 	/// over.
 	int *witness = nullptr;
 
-	/// Iterator to the current position of this frame in
-	/// Module::accesses.
-	std::list<Frame *>::iterator accesses_iterator;
-	
-	/// Iterator to the current position of this frame in
-	/// Module::write_accesses
-	std::list<Frame *>::iterator write_accesses_iterator;
+	/// Older and younger neighbors of this frame in the module's list of
+	/// in-flight accesses, or `nullptr` at the list ends.
+	Frame *access_prev = nullptr;
+	Frame *access_next = nullptr;
+
+	/// Older and younger neighbors of this frame in the module's list of
+	/// in-flight write accesses.
+	Frame *write_access_prev = nullptr;
+	Frame *write_access_next = nullptr;
+
+	/// Neighbors of this frame in its bucket of the module's hash table
+	/// of in-flight block addresses.
+	Frame *bucket_prev = nullptr;
+	Frame *bucket_next = nullptr;
+
+	/// Position of this access in the order in which in-flight accesses
+	/// were started in the module. Only valid while in flight.
+	long long access_sequence = 0;
+
+	/// Number of in-flight accesses coalesced with this one, that is,
+	/// whose \a master_frame field points to this frame.
+	int num_coalesced_frames = 0;
 
 	/// Type of memory access
 	Module::AccessType access_type = Module::AccessInvalid;
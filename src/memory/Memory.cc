@@ -20,7 +20,10 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <fcntl.h>
 #include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/String.h>
@@ -38,6 +41,12 @@ const unsigned Memory::PageMask;
 bool Memory::safe_mode = true;
 
 
+Memory::FileMapping::~FileMapping()
+{
+	munmap(base, size);
+}
+
+
 Memory::Page *Memory::getPage(unsigned address)
 {
 	unsigned tag = address & ~(PageSize - 1);
@@ -92,6 +101,11 @@ Memory::Page *Memory::newPage(unsigned address, unsigned perm)
 	auto it = ret.first;
 	Page *page = it->second.get();
 
+	// Instructions fetched from an unallocated address in unsafe mode may
+	// have been cached as zeros
+	if (!safe)
+		code_version++;
+
 	// Return it
 	return page;
 }
@@ -114,6 +128,7 @@ void Memory::Copy(unsigned dest, unsigned src, unsigned size)
 		Page *page_dest = getPage(dest);
 		Page *page_src = getPage(src);
 		assert(page_src && page_dest);
+		InvalidateCode(page_dest);
 		
 		// Different actions depending on whether source and
 		// destination page data are allocated.
@@ -123,10 +138,10 @@ void Memory::Copy(unsigned dest, unsigned src, unsigned size)
 			memcpy(page_dest->getData(), page_src->getData(),
 					PageSize);
 		}
-		else
+		else if (page_dest->getData())
 		{
-			if (page_dest->getData())
-				memset(page_dest->getData(), 0, PageSize);
+			page_dest->AllocateData();
+			memset(page_dest->getData(), 0, PageSize);
 		}
 
 		// Advance pointers
@@ -137,6 +152,56 @@ void Memory::Copy(unsigned dest, unsigned src, unsigned size)
 }
 
 
+void Memory::CopyFrom(Memory &src, unsigned src_address,
+		unsigned dest_address, unsigned size)
+{
+	// Overlapping regions in the same memory object need the semantics
+	// of an intermediate buffer.
+	if (&src == this && src_address < dest_address + size &&
+			dest_address < src_address + size)
+	{
+		auto buffer = misc::new_unique_array<char>(size);
+		Read(src_address, size, buffer.get());
+		Write(dest_address, size, buffer.get());
+		return;
+	}
+
+	// Copy chunks contained in one source and one destination page
+	static const char zero_page[PageSize] = { };
+	src.last_address = src_address;
+	last_address = dest_address;
+	while (size)
+	{
+		unsigned src_offset = src_address & (PageSize - 1);
+		unsigned dest_offset = dest_address & (PageSize - 1);
+		unsigned chunk_size = std::min(size, PageSize -
+				std::max(src_offset, dest_offset));
+
+		// Locate source data, reading zeros from pages that were not
+		// allocated or never written.
+		const char *data = zero_page;
+		Page *src_page = src.getPage(src_address);
+		if (!src_page && src.safe)
+			throw Error(misc::fmt("[0x%x] Segmentation fault in "
+					"guest program", src_address));
+		if (src_page && src.safe && !(src_page->getPerm() & AccessRead))
+			throw Error(misc::fmt("[0x%x] Permission denied",
+					src_address));
+		if (src_page && src_page->getData())
+			data = src_page->getData() + src_offset;
+
+		// Write into destination page
+		AccessAtPageBoundary(dest_address, chunk_size,
+				const_cast<char *>(data), AccessWrite);
+
+		// Next chunk
+		src_address += chunk_size;
+		dest_address += chunk_size;
+		size -= chunk_size;
+	}
+}
+
+
 char *Memory::getBuffer(unsigned address, unsigned size, AccessType access)
 {
 	// Get page offset and check page bounds
@@ -152,8 +217,15 @@ char *Memory::getBuffer(unsigned address, unsigned size, AccessType access)
 	// Check page permissions
 	if ((page->getPerm() & access) != access && safe)
 		throw Error(misc::fmt("[0x%x] Permission denied", address));
+
+	// The caller may modify the page through the returned buffer
+	if (access & (AccessWrite | AccessInit))
+		InvalidateCode(page);
 	
-	// Return pointer to page data
+	// Return pointer to page data. Pages backed by a file mapping can be
+	// read in place.
+	if (!(access & (AccessWrite | AccessInit)) && page->getData())
+		return page->getData() + offset;
 	page->AllocateData();
 	return page->getData() + offset;
 }
@@ -210,6 +282,7 @@ void Memory::AccessAtPageBoundary(unsigned address, unsigned size,
 	// Write/initialize access
 	if (access == AccessWrite || access == AccessInit)
 	{
+		InvalidateCode(page);
 		page->AllocateData();
 		memcpy(page->getData() + offset, buffer, size);
 		return;
@@ -254,10 +327,12 @@ Memory::Memory(const Memory &memory)
 		Page *src_page = it.second.get();
 
 		// Create destination page with same permissions
-		newPage(src_page->getTag(), src_page->getPerm());
+		Page *page = newPage(src_page->getTag(), src_page->getPerm());
 
-		// Copy data if any
-		if (src_page->getData())
+		// Share the file mapping, or copy data if any
+		if (src_page->isMapped())
+			page->CopyMapping(*src_page);
+		else if (src_page->getData())
 			Access(src_page->getTag(), PageSize,
 					src_page->getData(),
 					AccessInit);
@@ -362,9 +437,75 @@ void Memory::Unmap(unsigned address, unsigned size)
 	unsigned tag1 = address & ~(PageSize-1);
 	unsigned tag2 = (address + size - 1) & ~(PageSize-1);
 
-	// Deallocate pages
+	// Deallocate pages, discarding instructions cached from them
 	for (unsigned tag = tag1; tag <= tag2; tag += PageSize)
+	{
+		Page *page = getPage(tag);
+		if (!page)
+			continue;
+		InvalidateCode(page);
 		pages.erase(tag);
+	}
+}
+
+
+bool Memory::MapFile(unsigned address, unsigned size, int host_fd,
+		unsigned offset, bool shared)
+{
+	// Restrictions
+	assert(!(address & (PageSize - 1)));
+	assert(!(size & (PageSize - 1)));
+	assert(!(offset & (PageSize - 1)));
+
+	// Only regular files can be mapped
+	struct stat st;
+	if (fstat(host_fd, &st) || !S_ISREG(st.st_mode))
+		return false;
+
+	// Only the part of the region within the file is backed by it
+	unsigned mapping_size = 0;
+	if ((long long) offset < (long long) st.st_size)
+		mapping_size = std::min((long long) size,
+				(long long) st.st_size - offset);
+
+	// Writes reach the file only if it was opened for writing
+	int host_prot = PROT_READ;
+	int host_flags = MAP_PRIVATE;
+	if (shared && (fcntl(host_fd, F_GETFL) & O_ACCMODE) == O_RDWR)
+	{
+		host_prot |= PROT_WRITE;
+		host_flags = MAP_SHARED;
+	}
+
+	// Map host file
+	std::shared_ptr<FileMapping> mapping;
+	if (mapping_size)
+	{
+		void *base = mmap(nullptr, mapping_size, host_prot, host_flags,
+				host_fd, offset);
+		if (base == MAP_FAILED)
+			return false;
+		mapping = std::make_shared<FileMapping>((char *) base,
+				mapping_size);
+	}
+
+	// Back pages
+	for (unsigned page_offset = 0; page_offset < size;
+			page_offset += PageSize)
+	{
+		Page *page = getPage(address + page_offset);
+		if (!page)
+			throw misc::Panic("File mapped on unallocated memory");
+		InvalidateCode(page);
+		if (page_offset < mapping_size)
+			page->setMapping(mapping, mapping->getBase() +
+					page_offset, host_flags == MAP_SHARED);
+		else
+			page->setMapping(nullptr, nullptr, false);
+	}
+
+	// Success
+	return true;
 }
 
 
@@ -383,7 +524,9 @@ void Memory::Protect(unsigned address, unsigned size, unsigned perm)
 		if (!page)
 			continue;
 
-		// Set page new protection flags
+		// Set page new protection flags. The page may lose its
+		// execution permission, so discard instructions cached from it.
+		InvalidateCode(page);
 		page->setPerm(perm);
 	}
 }
@@ -487,10 +630,12 @@ void Memory::Clone(const Memory &memory)
 		Page *src_page = it.second.get();
 
 		// Create destination page with same permissions
-		newPage(src_page->getTag(), src_page->getPerm());
+		Page *page = newPage(src_page->getTag(), src_page->getPerm());
 
-		// Copy data if any
-		if (src_page->getData())
+		// Share the file mapping, or copy data if any
+		if (src_page->isMapped())
+			page->CopyMapping(*src_page);
+		else if (src_page->getData())
 			Access(src_page->getTag(), PageSize,
 					src_page->getData(),
 					AccessInit);
@@ -21,6 +21,7 @@
 #define MEMORY_MEMORY_H
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
@@ -70,6 +71,34 @@ public:
 		AccessModified = 1 << 4
 	};
 
+	/// A region of a host file mapped with 'mmap', shared by all pages
+	/// backed by it. The host mapping is released when the last page
+	/// referencing it is freed.
+	class FileMapping
+	{
+		// Host address and size of the mapping
+		char *base;
+		unsigned size;
+
+	public:
+
+		/// Constructor, taking ownership of a host mapping
+		FileMapping(char *base, unsigned size) :
+				base(base),
+				size(size)
+		{
+		}
+
+		/// Destructor, unmapping the host region
+		~FileMapping();
+
+		/// Return the host address of the mapping
+		char *getBase() const { return base; }
+
+		/// Return the size of the mapping in bytes
+		unsigned getSize() const { return size; }
+	};
+
 	/// A 4KB page of memory
 	class Page
 	{
@@ -82,6 +111,19 @@ public:
 
 		// The page data
 		std::unique_ptr<char[]> data;
+
+		// Host file mapping backing the page while it has no data of
+		// its own, and pointer to the page content in it
+		std::shared_ptr<FileMapping> mapping;
+		char *mapping_data = nullptr;
+
+		// Whether writes go directly into the host file mapping, as
+		// opposed to copying the page content first
+		bool mapping_shared = false;
+
+		// Whether an emulator keeps decoded instructions fetched from
+		// this page
+		bool code = false;
 	
 	public:
 
@@ -102,17 +144,59 @@ public:
 		unsigned getPerm() const { return perm; }
 
 		/// Return a pointer to the page data, or `nullptr` if the data
-		/// was not allocated.
-		char *getData() { return data.get(); }
+		/// was not allocated. For a page backed by a file mapping, the
+		/// data may point into the host mapping, which is only writable
+		/// after a call to AllocateData().
+		char *getData() { return data ? data.get() : mapping_data; }
 
 		/// Allocate the page data. If the data buffer was allocated
-		/// before, this call is ignored.
+		/// before, or writes go directly into a shared file mapping,
+		/// this call is ignored. A page backed by a private file mapping
+		/// gets a copy of its content (copy-on-write).
 		void AllocateData()
 		{
-			if (data == nullptr)
-				data = misc::new_unique_array<char>(PageSize);
+			if (data != nullptr || mapping_shared)
+				return;
+			data = misc::new_unique_array<char>(PageSize);
+			if (mapping_data)
+			{
+				memcpy(data.get(), mapping_data, PageSize);
+				mapping_data = nullptr;
+				mapping = nullptr;
+			}
 		}
 
+		/// Back the page with the content of a host file mapping,
+		/// discarding its current data.
+		///
+		/// \param mapping
+		///	Host file mapping
+		///
+		/// \param mapping_data
+		///	Content of the page within the host mapping
+		///
+		/// \param shared
+		///	Whether writes go directly into the host mapping
+		void setMapping(const std::shared_ptr<FileMapping> &mapping,
+				char *mapping_data, bool shared)
+		{
+			data = nullptr;
+			this->mapping = mapping;
+			this->mapping_data = mapping_data;
+			mapping_shared = shared;
+		}
+
+		/// Back the page with the same file mapping as \a page
+		void CopyMapping(const Page &page)
+		{
+			setMapping(page.mapping, page.mapping_data,
+					page.mapping_shared);
+		}
+
+		/// Return whether the page content still comes from a host
+		/// file mapping, rather than from data of its own.
+		bool isMapped() const { return data == nullptr && mapping_data; }
+
 		/// Set the page permissions, given as a bitmap of flags of
 		/// type AccessType.
 		void setPerm(unsigned perm) { this->perm = perm; }
@@ -120,6 +204,14 @@ public:
 		/// Add a flag to the page permissions, given as a bitmap of
 		/// flags of type AccessType.
 		void addPerm(unsigned perm) { this->perm |= perm; }
+
+		/// Return whether decoded instructions from this page are
+		/// cached by an emulator.
+		bool hasCode() const { return code; }
+
+		/// Set or clear the flag indicating that decoded instructions
+		/// from this page are cached by an emulator.
+		void setCode(bool code) { this->code = code; }
 	};
 
 private:
@@ -140,6 +232,20 @@ private:
 	/// Last accessed address
 	unsigned last_address = 0;
 
+	/// Version of the code in the memory space, increased every time
+	/// that a page with cached decoded instructions is modified.
+	unsigned long long code_version = 0;
+
+	/// Invalidate decoded instructions cached from \a page, if any
+	void InvalidateCode(Page *page)
+	{
+		if (page->hasCode())
+		{
+			page->setCode(false);
+			code_version++;
+		}
+	}
+
 	/// Create a new page and add it to the page table. The value given in
 	/// \a perm is an *or*'ed bitmap of AccessType flags.
 	Page *newPage(unsigned address, unsigned perm);
@@ -169,7 +275,25 @@ public:
 	bool getSafe() const { return safe; }
 
 	/// Clear content of memory
-	void Clear() { pages.clear(); }
+	void Clear()
+	{
+		pages.clear();
+		code_version++;
+	}
+
+	/// Return the code version of the memory space. Emulators caching
+	/// decoded instructions must discard them when this value changes.
+	unsigned long long getCodeVersion() const { return code_version; }
+
+	/// Record that an emulator caches decoded instructions fetched from
+	/// the page containing \a address. Writes to the page will increase
+	/// the code version.
+	void MarkCode(unsigned address)
+	{
+		Page *page = getPage(address);
+		if (page)
+			page->setCode(true);
+	}
 
 	/// Return the memory page corresponding to an address, or `nullptr` if
 	/// there is currently no page allocated for that address.
@@ -242,6 +366,38 @@ public:
 	///	-1` if no free space was found with \a size bytes.
 	unsigned MapSpaceDown(unsigned address, unsigned size);
 	
+	/// Back a region of allocated pages with the content of a host file,
+	/// mapped with the host 'mmap'. Host pages are only read when the
+	/// guest first accesses them, and no memory is allocated for guest
+	/// pages that are only read. Pages past the end of the file read as
+	/// zeros.
+	///
+	/// \param address
+	///	Address aligned to page boundary. The pages must have been
+	///	allocated with Map() before.
+	///
+	/// \param size
+	///	Number of bytes, multiple of page size.
+	///
+	/// \param host_fd
+	///	Host file descriptor
+	///
+	/// \param offset
+	///	Offset in the file, aligned to page boundary.
+	///
+	/// \param shared
+	///	If set, writes into the region go into the file, as long as it
+	///	was opened for reading and writing. Otherwise, pages are copied
+	///	the first time they are written (copy-on-write).
+	///
+	/// \return
+	///	The function returns `false` if the host file cannot be mapped,
+	///	such as for files other than regular files. In this case, the
+	///	memory is not modified, and the caller can fall back to reading
+	///	the file content.
+	bool MapFile(unsigned address, unsigned size, int host_fd,
+			unsigned offset, bool shared);
+
 	/// Assign protection attributes to pages. If a page in the range is not
 	/// allocated, it is silently skipped.
 	///
@@ -275,6 +431,30 @@ public:
 	///	region does not have write permissions.
 	void Copy(unsigned dest, unsigned src, unsigned size);
 
+	/// Copy a region from another memory object into this one, with no
+	/// alignment or size restrictions. Data is moved directly between
+	/// pages, without an intermediate buffer. The operation is equivalent
+	/// to reading from \a src and writing into this memory.
+	///
+	/// \param src
+	///	Source memory object. It can be this same memory object.
+	///
+	/// \param src_address
+	///	Source address in \a src
+	///
+	/// \param dest_address
+	///	Destination address in this memory
+	///
+	/// \param size
+	///	Number of bytes to copy
+	///
+	/// \throw
+	///	A Memory::Error is thrown if either memory is in safe mode and
+	///	the source pages do not have read permissions, or the destination
+	///	pages do not have write permissions.
+	void CopyFrom(Memory &src, unsigned src_address, unsigned dest_address,
+			unsigned size);
+
  	/// Access memory at any address and size, without page boundary
 	/// restrictions.
 	///
@@ -49,6 +49,10 @@ Module::Module(const std::string &name,
 	// Block size
 	assert(!(block_size & (block_size - 1)) && block_size >= 4);
 	log_block_size = misc::LogBase2(block_size);
+
+	// Hash tables of in-flight accesses
+	in_flight_buckets.resize(InFlightNumBuckets, nullptr);
+	in_flight_ids.resize(InFlightIdTableInitialSize, nullptr);
 }
 
 
@@ -153,7 +157,7 @@ bool Module::canAccess(int address) const
 
 	// Module can be accessed if number of non-coalesced in-flight accesses
 	// is smaller than the MSHR size.
-	int num_non_coalesced_accesses = accesses.size() -
+	int num_non_coalesced_accesses = num_in_flight_accesses -
 			num_coalesced_accesses;
 	return num_non_coalesced_accesses < mshr_size;
 }
@@ -238,71 +242,163 @@ long long Module::Access(AccessType access_type,
 }
 
 
+void Module::InsertInFlightId(Frame *frame)
+{
+	// Grow table when it would become more than half full
+	if ((num_in_flight_accesses + 1) * 2 > (int) in_flight_ids.size())
+	{
+		std::vector<Frame *> old_ids(in_flight_ids.size() * 2, nullptr);
+		old_ids.swap(in_flight_ids);
+		for (Frame *old_frame : old_ids)
+		{
+			if (!old_frame)
+				continue;
+			unsigned slot = getInFlightIdSlot(old_frame->getId());
+			while (in_flight_ids[slot])
+				slot = (slot + 1) & (in_flight_ids.size() - 1);
+			in_flight_ids[slot] = old_frame;
+		}
+	}
+
+	// Insert in first empty slot after home slot
+	unsigned slot = getInFlightIdSlot(frame->getId());
+	while (in_flight_ids[slot])
+		slot = (slot + 1) & (in_flight_ids.size() - 1);
+	in_flight_ids[slot] = frame;
+}
+
+
+void Module::RemoveInFlightId(Frame *frame)
+{
+	// Find frame
+	unsigned mask = in_flight_ids.size() - 1;
+	unsigned slot = getInFlightIdSlot(frame->getId());
+	while (in_flight_ids[slot] != frame)
+	{
+		if (!in_flight_ids[slot])
+			throw misc::Panic("Frame not found");
+		slot = (slot + 1) & mask;
+	}
+
+	// Shift back the following entries of the probe sequence that would
+	// become unreachable once the slot is emptied.
+	unsigned hole = slot;
+	unsigned next = (slot + 1) & mask;
+	while (in_flight_ids[next])
+	{
+		// Move entry into the hole if its home slot is not cyclically
+		// located in (hole, next].
+		unsigned home = getInFlightIdSlot(in_flight_ids[next]->getId());
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			in_flight_ids[hole] = in_flight_ids[next];
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+	in_flight_ids[hole] = nullptr;
+}
+
+
 void Module::StartAccess(Frame *frame, AccessType access_type)
 {
 	// Record access type
 	frame->access_type = access_type;
+	frame->access_sequence = access_sequence++;
 
-	// Insert in access list
-	frame->accesses_iterator = accesses.insert(accesses.end(),
-			frame);
+	// Insert at the tail of the access list
+	frame->access_prev = access_tail;
+	frame->access_next = nullptr;
+	if (access_tail)
+		access_tail->access_next = frame;
+	else
+		access_head = frame;
+	access_tail = frame;
 
-	// Insert in write access list
+	// Insert at the tail of the write access list
 	if (access_type == AccessStore)
-		frame->write_accesses_iterator = write_accesses.insert(
-				write_accesses.end(),
-				frame);
-
-	// Insert in hash table of block addresses
-	unsigned block_address = frame->getAddress() >> log_block_size;
-	in_flight_block_addresses.emplace(std::make_pair(block_address, frame));
+	{
+		frame->write_access_prev = write_access_tail;
+		frame->write_access_next = nullptr;
+		if (write_access_tail)
+			write_access_tail->write_access_next = frame;
+		else
+			write_access_head = frame;
+		write_access_tail = frame;
+	}
 
-	// Insert in set of access identifiers
-	in_flight_access_ids.emplace(frame->getId());
+	// Insert at the head of its bucket in the hash table of block
+	// addresses, so that younger accesses are found first.
+	Frame *&bucket = getInFlightBucket(frame->getAddress());
+	frame->bucket_prev = nullptr;
+	frame->bucket_next = bucket;
+	if (bucket)
+		bucket->bucket_prev = frame;
+	bucket = frame;
+
+	// Insert in table of access identifiers
+	InsertInFlightId(frame);
+	num_in_flight_accesses++;
 }
 
 
 void Module::FinishAccess(Frame *frame)
 {
 	// Remove from access list
-	accesses.erase(frame->accesses_iterator);
-	frame->accesses_iterator = accesses.end();
+	assert(num_in_flight_accesses > 0);
+	if (frame->access_prev)
+		frame->access_prev->access_next = frame->access_next;
+	else
+		access_head = frame->access_next;
+	if (frame->access_next)
+		frame->access_next->access_prev = frame->access_prev;
+	else
+		access_tail = frame->access_prev;
+	frame->access_prev = nullptr;
+	frame->access_next = nullptr;
 
 	// Remove from write access list
 	assert(frame->access_type);
 	if (frame->access_type == Module::AccessStore)
 	{
-		write_accesses.erase(frame->write_accesses_iterator);
-		frame->write_accesses_iterator = write_accesses.end();
-	}
-
-	// Remove from hash table
-	unsigned block_address = frame->getAddress() >> log_block_size;
-	auto range = in_flight_block_addresses.equal_range(block_address);
-	bool found = false;
-	for (auto it = range.first; it != range.second; ++it)
-	{
-		Frame *other_frame = it->second;
-		if (frame == other_frame)
-		{
-			found = true;
-			in_flight_block_addresses.erase(it);
-			break;
-		}
+		if (frame->write_access_prev)
+			frame->write_access_prev->write_access_next =
+					frame->write_access_next;
+		else
+			write_access_head = frame->write_access_next;
+		if (frame->write_access_next)
+			frame->write_access_next->write_access_prev =
+					frame->write_access_prev;
+		else
+			write_access_tail = frame->write_access_prev;
+		frame->write_access_prev = nullptr;
+		frame->write_access_next = nullptr;
 	}
 
-	// Must have been removed
-	if (!found)
+	// Remove from hash table of block addresses
+	Frame *&bucket = getInFlightBucket(frame->getAddress());
+	if (frame->bucket_prev)
+		frame->bucket_prev->bucket_next = frame->bucket_next;
+	else if (bucket == frame)
+		bucket = frame->bucket_next;
+	else
 		throw misc::Panic("Frame not found");
+	if (frame->bucket_next)
+		frame->bucket_next->bucket_prev = frame->bucket_prev;
+	frame->bucket_prev = nullptr;
+	frame->bucket_next = nullptr;
 
-	// Remove from set of in-flight access identifiers
-	in_flight_access_ids.erase(frame->getId());
+	// Remove from table of in-flight access identifiers
+	RemoveInFlightId(frame);
+	num_in_flight_accesses--;
 
-	// If this was a coalesced access, update counter
+	// If this was a coalesced access, update counters
 	if (frame->coalesced)
 	{
 		assert(num_coalesced_accesses > 0);
 		num_coalesced_accesses--;
+		if (frame->master_frame)
+			frame->master_frame->num_coalesced_frames--;
 	}
 
 	// When a frame finishes its access, we need to check each of the frames
@@ -310,13 +406,20 @@ void Module::FinishAccess(Frame *frame)
 	// finished frame as a master frame. If they are, their master frame
 	// pointer is resest to null. This is to prevent a situation where the
 	// finishing frame makes a later access and adopts a master frame from
-	// a frame in the access list which points to itself.
-	for (auto it = accesses.begin(); it != accesses.end(); it++)
+	// a frame in the access list which points to itself. The list only
+	// needs to be traversed if some access is still coalesced with this
+	// one.
+	for (Frame *list_frame = access_head;
+			list_frame && frame->num_coalesced_frames;
+			list_frame = list_frame->access_next)
 	{
-		Frame *list_frame = *it;
 		if (list_frame->master_frame == frame)
+		{
 			list_frame->master_frame = nullptr;
+			frame->num_coalesced_frames--;
+		}
 	}
+	frame->num_coalesced_frames = 0;
 
 	// Wake up dependent accesses
 	frame->queue.WakeupAll();
@@ -326,13 +429,15 @@ void Module::FinishAccess(Frame *frame)
 Frame *Module::getInFlightAddress(unsigned address,
 		Frame *older_than_frame)
 {
-	// Look for address
+	// Look for address in its bucket, youngest access first
 	unsigned block_address = address >> log_block_size;
-	auto range = in_flight_block_addresses.equal_range(block_address);
-	for (auto it = range.first; it != range.second; ++it)
+	for (Frame *frame = getInFlightBucket(address);
+			frame;
+			frame = frame->bucket_next)
 	{
-		// Get frame
-		Frame *frame = it->second;
+		// Bucket is shared with other block addresses
+		if (frame->getAddress() >> log_block_size != block_address)
+			continue;
 
 		// This frame is not older than 'older_than_frame'
 		if (older_than_frame && frame->getId() >=
@@ -340,8 +445,6 @@ Frame *Module::getInFlightAddress(unsigned address,
 			continue;
 
 		// Block address matches
-		assert(frame->getAddress() >> log_block_size ==
-				address >> log_block_size);
 		return frame;
 	}
 
@@ -355,22 +458,15 @@ Frame *Module::getInFlightWrite(Frame *older_than_frame)
 	// No 'older_than_frame' given, return youngest write, or nullptr if
 	// there is no in-flight write.
 	if (!older_than_frame)
-		return write_accesses.size() ?
-				write_accesses.back() :
-				nullptr;
+		return write_access_tail;
 	
-	// Search
-	auto it = older_than_frame->accesses_iterator;
-	while (it != accesses.begin())
-	{
-		// Rewind
-		--it;
-
-		// Check if it is a write
-		Frame *frame = *it;
-		if (frame->access_type == AccessStore)
+	// Search writes from youngest to oldest for the first one started
+	// before 'older_than_frame'.
+	for (Frame *frame = write_access_tail;
+			frame;
+			frame = frame->write_access_prev)
+		if (frame->access_sequence < older_than_frame->access_sequence)
 			return frame;
-	}
 
 	// Not found
 	return nullptr;
@@ -379,16 +475,20 @@ Frame *Module::getInFlightWrite(Frame *older_than_frame)
 
 bool Module::isInFlightAddress(unsigned address)
 {
-	unsigned block_address = address >> log_block_size;
-	auto it = in_flight_block_addresses.find(block_address);
-	return it != in_flight_block_addresses.end();
+	return getInFlightAddress(address) != nullptr;
 }
 
 
 bool Module::isInFlightAccess(long long id)
 {
-	auto it = in_flight_access_ids.find(id);
-	return it != in_flight_access_ids.end();
+	unsigned slot = getInFlightIdSlot(id);
+	while (in_flight_ids[slot])
+	{
+		if (in_flight_ids[slot]->getId() == id)
+			return true;
+		slot = (slot + 1) & (in_flight_ids.size() - 1);
+	}
+	return false;
 }
 
 
@@ -862,11 +962,9 @@ void Module::DumpInFlightAddresses(std::ostream &os)
 	esim::Engine *engine = esim::Engine::getInstance();
 	os << misc::fmt("[%s] In-flight blocks in cycle %lld:\n",
 			name.c_str(), engine->getCycle());
-	for (auto &pair : in_flight_block_addresses)
+	for (Frame *frame = access_head; frame; frame = frame->access_next)
 	{
-		
-		unsigned block_address = pair.first;
-		Frame *frame = pair.second;
+		unsigned block_address = frame->getAddress() >> log_block_size;
 		os << misc::fmt("\tkey (block_address) = 0x%x: "
 				"id = %lld, "
 				"address = 0x%x, "
@@ -876,7 +974,12 @@ void Module::DumpInFlightAddresses(std::ostream &os)
 				frame->getAddress(),
 				frame->getAddress() >> log_block_size);
 		frame->CheckMagic();
-		if (block_address != frame->getAddress() >> log_block_size)
+
+		// Frame must be linked in the bucket for its block address
+		Frame *bucket_frame = getInFlightBucket(frame->getAddress());
+		while (bucket_frame && bucket_frame != frame)
+			bucket_frame = bucket_frame->bucket_next;
+		if (!bucket_frame)
 			throw misc::Panic("Invalid block address");
 	}
 }
@@ -887,7 +990,7 @@ Frame *Module::canCoalesce(AccessType access_type,
 		Frame *older_than_frame)
 {
 	// Nothing if there is no in-flight access
-	if (!accesses.size())
+	if (!num_in_flight_accesses)
 		return nullptr;
 
 	// For efficiency, first check in the hash table of accesses
@@ -898,17 +1001,15 @@ Frame *Module::canCoalesce(AccessType access_type,
 
 	// Nothing if 'older_than_frame' is in the head of the in-flight
 	// access list (i.e., there is nothing older).
-	if (older_than_frame->accesses_iterator == accesses.begin())
+	if (older_than_frame && older_than_frame == access_head)
 		return nullptr;
 	
-	// Get iterator to youngest access older than 'older_than_frame', or an
-	// iterator to the overall youngest access if 'older_than_frame' is
-	// null.
-	auto tail = older_than_frame ?
-			older_than_frame->accesses_iterator :
-			accesses.end();
-	assert(tail != accesses.begin());
-	--tail;
+	// Get youngest access older than 'older_than_frame', or the overall
+	// youngest access if 'older_than_frame' is null.
+	Frame *tail = older_than_frame ?
+			older_than_frame->access_prev :
+			access_tail;
+	assert(tail);
 
 	// Coalesce depending on access type
 	switch (access_type)
@@ -916,11 +1017,9 @@ Frame *Module::canCoalesce(AccessType access_type,
 
 	case AccessLoad:
 	{
-		auto it = tail;
-		while (true)
+		for (Frame *frame = tail; frame; frame = frame->access_prev)
 		{
 			// Only coalesce with groups of reads at the tail
-			Frame *frame = *it;
 			if (frame->access_type != AccessLoad)
 				return nullptr;
 
@@ -934,13 +1033,6 @@ Frame *Module::canCoalesce(AccessType access_type,
 						frame->master_frame :
 						frame;
 			}
-			
-			// Done when head reached
-			if (it == accesses.begin())
-				break;
-
-			// Previous
-			--it;
 		}
 		break;
 	}
@@ -948,7 +1040,7 @@ Frame *Module::canCoalesce(AccessType access_type,
 	case AccessStore:
 	{
 		// Only coalesce with last access if it is a write
-		Frame *frame = *tail;
+		Frame *frame = tail;
 		if (frame->access_type != AccessStore)
 			return nullptr;
 		
@@ -972,7 +1064,7 @@ Frame *Module::canCoalesce(AccessType access_type,
 	case AccessNCStore:
 	{
 		// Only coalesce with last access if it is a non-coherent write
-		Frame *frame = *tail;
+		Frame *frame = tail;
 		if (frame->access_type != AccessNCStore)
 			return nullptr;
 
@@ -1025,7 +1117,8 @@ void Module::Coalesce(Frame *master_frame, Frame *frame)
 	// Set slave frame as a coalesced access
 	frame->coalesced = true;
 	frame->master_frame = master_frame;
-	assert(num_coalesced_accesses <= (int) accesses.size());
+	master_frame->num_coalesced_frames++;
+	assert(num_coalesced_accesses <= num_in_flight_accesses);
 
 	// Record in-flight coalesced access in module
 	num_coalesced_accesses++;
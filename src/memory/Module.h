@@ -20,10 +20,8 @@
 #ifndef MEMORY_MODULE_H
 #define MEMORY_MODULE_H
 
-#include <list>
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include <lib/cpp/Misc.h>
 #include <lib/esim/Engine.h>
@@ -214,23 +212,71 @@ private:
 	// In-flight accesses
 	//
 
-	// List of all in-flight accesses
-	std::list<Frame *> accesses;
+	// Number of buckets in the hash table of in-flight block addresses.
+	// Must be a power of 2.
+	static const int InFlightNumBuckets = 256;
 
-	// List of all in-flight write accesses
-	std::list<Frame *> write_accesses;
+	// Initial number of entries in the table of in-flight access
+	// identifiers. Must be a power of 2.
+	static const int InFlightIdTableInitialSize = 64;
+
+	// Oldest and youngest in-flight accesses. All in-flight accesses are
+	// linked through Frame::access_prev and Frame::access_next in the
+	// order in which they were started with StartAccess().
+	Frame *access_head = nullptr;
+	Frame *access_tail = nullptr;
+
+	// Oldest and youngest in-flight write accesses, linked through
+	// Frame::write_access_prev and Frame::write_access_next.
+	Frame *write_access_head = nullptr;
+	Frame *write_access_tail = nullptr;
+
+	// Number of in-flight accesses
+	int num_in_flight_accesses = 0;
+
+	// Sequence number assigned to the next access started, used to
+	// compare the relative age of in-flight accesses.
+	long long access_sequence = 0;
 	
 	// Number of in-flight coalesced accesses. This is a number
-	// between 0 and access_list.size() at all times.
+	// between 0 and num_in_flight_accesses at all times.
 	int num_coalesced_accesses = 0;
 
 	// Hash table of accesses, indexed by a block address (that is, a
-	// memory address divided by the module's block size). There can be
-	// multiple in-flight accesses for the same block.
-	std::unordered_multimap<unsigned, Frame *> in_flight_block_addresses;
+	// memory address divided by the module's block size). Each bucket
+	// points to a chain of frames linked through Frame::bucket_prev and
+	// Frame::bucket_next, youngest first. There can be multiple in-flight
+	// accesses for the same block.
+	std::vector<Frame *> in_flight_buckets;
+
+	// Open-addressed hash table with linear probing containing all
+	// in-flight accesses, indexed by access identifier. Empty slots are
+	// set to nullptr. Its size is always a power of 2, and it is grown
+	// when half full.
+	std::vector<Frame *> in_flight_ids;
+
+	// Return the bucket in the hash table of block addresses for the given
+	// memory address.
+	Frame *&getInFlightBucket(unsigned address)
+	{
+		unsigned block_address = address >> log_block_size;
+		return in_flight_buckets[block_address &
+				(InFlightNumBuckets - 1)];
+	}
+
+	// Return the home slot of an access identifier in the table of
+	// in-flight access identifiers.
+	unsigned getInFlightIdSlot(long long id) const
+	{
+		return (unsigned long long) id & (in_flight_ids.size() - 1);
+	}
+
+	// Insert a frame in the table of in-flight access identifiers,
+	// growing the table if needed.
+	void InsertInFlightId(Frame *frame);
 
-	// Set containing all in-flight access identifiers
-	std::unordered_set<long long> in_flight_access_ids;
+	// Remove a frame from the table of in-flight access identifiers.
+	void RemoveInFlightId(Frame *frame);
 
 
 
@@ -759,31 +805,17 @@ public:
 	/// This function is invoked internally by RecursiveFlush().
 	void FlushCache();
 
-	/// Return an iterator to the first element of the access list.
-	std::list<Frame *>::iterator getAccessListBegin()
-	{
-		return accesses.begin();
-	}
+	/// Return the oldest in-flight access, or `nullptr` if there is no
+	/// in-flight access. The rest of the accesses can be traversed in
+	/// order through Frame::access_next.
+	Frame *getOldestAccess() const { return access_head; }
 
-	/// Return a past-the-end iterator for the list of in-flight accesses.
-	std::list<Frame *>::iterator getAccessListEnd()
-	{
-		return accesses.end();
-	}
+	/// Return the youngest in-flight access, or `nullptr` if there is no
+	/// in-flight access.
+	Frame *getYoungestAccess() const { return access_tail; }
 
-	/// Return an iterator to the first element of the list of in-flight
-	/// write accesses.
-	std::list<Frame *>::iterator getWriteAccessListBegin()
-	{
-		return write_accesses.begin();
-	}
-
-	/// Return a past-the-end iterator to the list of in-flight write
-	/// accesses.
-	std::list<Frame *>::iterator getWriteAccessListEnd()
-	{
-		return write_accesses.end();
-	}
+	/// Return the number of in-flight accesses.
+	int getNumInFlightAccesses() const { return num_in_flight_accesses; }
 
 
 
@@ -40,6 +40,8 @@ bool System::help = false;
 int System::frequency = 1000;
 long long System::sanity_check_interval = 0;
 long long System::last_sanity_check = 0;
+std::string System::trace_file;
+int System::trace_max_in_flight = 4;
 
 esim::Trace System::trace;
 
@@ -340,6 +342,22 @@ void System::RegisterOptions()
 			"coherency protocol in constant periods equal to the interval, "
 			"to examine its consistency and correctness. The simulation "
 			"fails if the correctness is not maintained.");
+
+	// Trace-driven simulation
+	command_line->RegisterString("--mem-trace <file>", trace_file,
+			"Run a trace-driven simulation of the memory hierarchy "
+			"given in option '--mem-config', without any CPU/GPU "
+			"timing simulation. Each line of the trace, optionally "
+			"compressed with 'gzip', has the format "
+			"'<cycle> <module> load|store|nc-store <address>'. "
+			"Accesses to the same module are issued in order once "
+			"their cycle is reached, subject to the module ports "
+			"and MSHR.");
+	command_line->RegisterInt32("--mem-trace-in-flight <num>",
+			trace_max_in_flight,
+			"Maximum number of in-flight accesses for each module "
+			"accessed in the trace given in option '--mem-trace' "
+			"(default 4).");
 }
 
 
@@ -396,7 +414,22 @@ void System::DumpReport(std::ostream &os) const
 	os << ";    NonBlockingReads, NonBlockingWrites, NonBlockingNCWrites -"
 			" Coming from upper-level cache\n";
 	os << "\n\n";
-	
+
+	// Trace-driven simulation
+	if (isTraceDriven())
+	{
+		os << "[ Trace ]\n\n";
+		os << "File = " << trace_file << '\n';
+		os << misc::fmt("Streams = %d\n", (int) trace_streams.size());
+		os << misc::fmt("Accesses = %lld\n", trace_num_accesses);
+		os << misc::fmt("Cycles = %lld\n", trace_cycles);
+		os << misc::fmt("Stalls = %lld\n", trace_num_stalls);
+		os << misc::fmt("AverageLatency = %.2f\n", trace_num_accesses ?
+				(double) trace_total_latency /
+				trace_num_accesses : 0.0);
+		os << "\n\n";
+	}
+
 	// Dump report for each module
 	for (auto &module : modules)
 		module->DumpReport(os);
@@ -20,6 +20,7 @@
 #ifndef MEMORY_SYSTEM_H
 #define MEMORY_SYSTEM_H
 
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -88,6 +89,12 @@ class System
 	// Sanity check cycle
 	static long long sanity_check_interval;
 
+	// Address trace replayed with '--mem-trace'
+	static std::string trace_file;
+
+	// Maximum number of in-flight accesses per trace stream
+	static int trace_max_in_flight;
+
 	// Last time a sanity check is performed
 	static long long last_sanity_check;
 	
@@ -229,6 +236,50 @@ class System
 	void ConfigReadCommands(misc::IniFile *ini_file);
 
 
+	//
+	// Trace-driven simulation
+	//
+
+	// An access read from a trace file
+	struct TraceAccess
+	{
+		// Cycle when the access can be issued
+		long long cycle;
+
+		// Access type and address
+		Module::AccessType type;
+		unsigned address;
+	};
+
+	// Accesses of a trace issued to one module, in trace order
+	struct TraceStream
+	{
+		// Module accessed
+		Module *module = nullptr;
+
+		// Accesses read from the trace but not issued yet
+		std::deque<TraceAccess> pending;
+
+		// In-flight accesses, with the witness variable incremented by
+		// the module when they complete, and the cycle they were issued
+		std::list<std::pair<int, long long>> in_flight;
+	};
+
+	// Streams of the replayed trace, indexed by module name
+	std::map<std::string, TraceStream> trace_streams;
+
+	// Statistics of the replayed trace
+	long long trace_num_accesses = 0;
+	long long trace_num_stalls = 0;
+	long long trace_total_latency = 0;
+	long long trace_cycles = 0;
+
+	// Parse a line of a trace file into an access, returning the module
+	// name. Returns an empty string for blank and comment lines.
+	std::string TraceParseLine(const std::string &path, int line_num,
+			const std::string &line, TraceAccess &access);
+
+
 	// List of networks
 	std::list<std::unique_ptr<net::Network>> networks;
 
@@ -289,6 +340,13 @@ public:
 
 	/// Destroy the singleton if allocated.
 	static void Destroy() { instance = nullptr; }
+
+	/// Return whether a trace-driven simulation was requested with option
+	/// '--mem-trace'.
+	static bool isTraceDriven() { return !trace_file.empty(); }
+
+	/// Access types in trace files
+	static const misc::StringMap TraceAccessTypeMap;
 	
 
 
@@ -403,6 +461,47 @@ public:
 
 
 
+	//
+	// Trace-driven simulation
+	//
+
+	/// Replay the trace given in option '--mem-trace'. See the overloaded
+	/// version of this function.
+	void TraceSimulation()
+	{
+		TraceSimulation(trace_file, trace_max_in_flight);
+	}
+
+	/// Replay an address trace into the memory hierarchy until all its
+	/// accesses complete. Each line of the trace has the format
+	///
+	///	<cycle> <module> load|store|nc-store <address>
+	///
+	/// Accesses to the same module form a stream, and are issued in
+	/// order once the memory cycle reaches their cycle, as long as the
+	/// stream has less than \a max_in_flight in-flight accesses and the
+	/// module has a free port and MSHR entry. Blank lines and lines
+	/// starting with '#' are ignored. Lines cannot be longer than 4096
+	/// characters. The file can be compressed with 'gzip'.
+	///
+	/// \throw
+	///	An Error is thrown if the file cannot be read, or a line of
+	///	the trace is too long or invalid.
+	void TraceSimulation(const std::string &path, int max_in_flight);
+
+	/// Return the number of accesses issued in the trace simulation
+	long long getTraceNumAccesses() const { return trace_num_accesses; }
+
+	/// Return the number of cycles that the trace simulation took
+	long long getTraceCycles() const { return trace_cycles; }
+
+	/// Return the number of cycles that trace accesses spent ready to be
+	/// issued, but stalled by in-flight limits, ports, or MSHRs.
+	long long getTraceNumStalls() const { return trace_num_stalls; }
+
+
+
+
 	// 
 	// Memory report
 	//
@@ -1032,6 +1032,23 @@ void System::ConfigReadEntries(misc::IniFile *ini_file)
 	// Get architecture pool
 	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
 
+	// In a trace-driven simulation, the trace accesses modules directly,
+	// and entries of architectures are discarded.
+	if (isTraceDriven())
+	{
+		std::vector<std::string> entries;
+		for (auto it = ini_file->sections_begin(),
+				e = ini_file->sections_end();
+				it != e;
+				++it)
+			if (!strncasecmp(it->c_str(), "Entry ", 6))
+				entries.push_back(*it);
+		for (auto &entry : entries)
+			ini_file->Remove(entry);
+		debug << "Trace-driven simulation, entries discarded\n\n";
+		return;
+	}
+
 	// Read all [Entry <name>] sections
 	debug << "Processing entries to the memory system:\n\n";
 	for (auto it = ini_file->sections_begin(),
@@ -1180,7 +1197,7 @@ void System::ConfigCreateSwitches(misc::IniFile *ini_file)
 		// Calculate routes
 		net::RoutingTable *routing_table = network->getRoutingTable();
 		routing_table->Initialize();
-		routing_table->FloydWarshall();
+		routing_table->CalculateRoutes();
 
 		// Debug
 		debug << '\n';
@@ -1356,6 +1373,13 @@ void System::ConfigCalculateModuleLevels()
 		}
 	}
 
+	// In a trace-driven simulation, modules with no high modules are the
+	// entries to the memory hierarchy
+	if (isTraceDriven())
+		for (auto &module : modules)
+			if (!module->getNumHighModules())
+				ConfigSetModuleLevel(module.get(), 1);
+
 	// Debug
 	debug << "Calculating module levels:\n";
 	for (auto &module : modules)
@@ -1478,6 +1502,12 @@ void System::ConfigReadCommands(misc::IniFile *ini_file)
 
 void System::ReadConfiguration()
 {
+	// A trace-driven simulation has no architectures to create a default
+	// configuration for
+	if (config_file.empty() && isTraceDriven())
+		throw Error("Option '--mem-trace' requires a memory "
+				"configuration file given with '--mem-config'");
+
 	// Load memory system configuration file. If no file name has been given
 	// by the user, create a default configuration for each architecture.
 	misc::IniFile ini_file;
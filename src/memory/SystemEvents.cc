@@ -482,14 +482,9 @@ void System::EventStoreHandler(esim::Event *event,
 				module->getName().c_str());
 
 		// If there is any older access, wait for it
-		auto it = frame->accesses_iterator;
-		assert(it != module->getAccessListEnd());
-		if (it != module->getAccessListBegin())
+		Frame *older_frame = frame->access_prev;
+		if (older_frame)
 		{
-			// Get older access
-			--it;
-			Frame *older_frame = *it;
-
 			// Debug
 			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
 					frame->getId(),
@@ -1577,7 +1572,8 @@ void System::EventEvictHandler(esim::Event *event,
 				low_node,
 				message_size,
 				event_evict_receive,
-				event);
+				event,
+				Frame::NetworkClassEviction);
 		if (frame->message)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
@@ -1856,7 +1852,8 @@ void System::EventEvictHandler(esim::Event *event,
 				destination_node,
 				8,
 				event_evict_reply_receive,
-				event);
+				event,
+				Frame::NetworkClassReply);
 		if (frame->message)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
@@ -1988,7 +1985,8 @@ void System::EventWriteRequestHandler(esim::Event *event,
 				destination_node,
 				8,
 				event_write_request_receive,
-				event);
+				event,
+				Frame::NetworkClassRequest);
 		if (frame->message)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
@@ -2460,7 +2458,8 @@ void System::EventWriteRequestHandler(esim::Event *event,
 				destination_node,
 				frame->reply_size,
 				event_write_request_finish,
-				event);
+				event,
+				Frame::NetworkClassReply);
 		if (frame->message)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
@@ -2585,7 +2584,8 @@ void System::EventReadRequestHandler(esim::Event *event,
 				destination_node,
 				8,
 				event_read_request_receive,
-				event);
+				event,
+				Frame::NetworkClassRequest);
 		if (frame->message)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
@@ -3227,7 +3227,8 @@ void System::EventReadRequestHandler(esim::Event *event,
 				destination_node,
 				frame->reply_size,
 				event_read_request_finish,
-				event);
+				event,
+				Frame::NetworkClassReply);
 		if (frame->message)
 			net::System::trace << misc::fmt("net.msg_access "
 					"net=\"%s\" "
@@ -3498,7 +3499,8 @@ void System::EventMessageHandler(esim::Event *event,
 				destination_node,
 				8,
 				event_message_receive,
-				event);
+				event,
+				Frame::NetworkClassRequest);
 
 		// Trace
 		if (frame->message)
@@ -3630,7 +3632,8 @@ void System::EventMessageHandler(esim::Event *event,
 				destination_node,
 				frame->reply_size,
 				event_message_finish,
-				event);
+				event,
+				Frame::NetworkClassReply);
 
 		// Trace
 		if (frame->message)
@@ -3954,14 +3957,9 @@ void System::EventLocalStoreHandler(esim::Event *event,
 				module->getName().c_str());
 
 		// If there is any older access, wait for it
-		auto it = frame->accesses_iterator;
-		assert(it != module->getAccessListEnd());
-		if (it != module->getAccessListBegin())
+		Frame *older_frame = frame->access_prev;
+		if (older_frame)
 		{
-			// Get older access
-			--it;
-			Frame *older_frame = *it;
-
 			// Debug
 			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
 					frame->getId(),
@@ -0,0 +1,264 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <zlib.h>
+
+#include <lib/cpp/String.h>
+#include <lib/esim/Engine.h>
+
+#include "System.h"
+
+
+namespace mem
+{
+
+
+// Maximum length of a line in a trace file
+static const int trace_max_line_length = 4096;
+
+
+// Trace file opened with 'zlib', closed when the object is destroyed
+class TraceFile
+{
+	std::string path;
+
+	gzFile f;
+
+public:
+
+	TraceFile(const std::string &path) : path(path)
+	{
+		// Uncompressed files are read transparently
+		f = gzopen(path.c_str(), "rb");
+		if (!f)
+			throw Error(misc::fmt("%s: cannot open trace "
+					"file", path.c_str()));
+	}
+
+	~TraceFile()
+	{
+		gzclose(f);
+	}
+
+	// Read the next line into 'line', without the trailing newline
+	// character. Return false at the end of the file.
+	bool ReadLine(int line_num, std::string &line)
+	{
+		char buffer[1024];
+		line.clear();
+		while (true)
+		{
+			// Read a chunk of the line
+			if (!gzgets(f, buffer, sizeof buffer))
+			{
+				int error;
+				gzerror(f, &error);
+				if (error != Z_OK)
+					throw Error(misc::fmt("%s:%d: "
+							"cannot read trace "
+							"file", path.c_str(),
+							line_num));
+				return !line.empty();
+			}
+			line += buffer;
+
+			// Check length
+			if ((int) line.length() > trace_max_line_length)
+				throw Error(misc::fmt("%s:%d: trace line "
+						"too long, maximum is %d "
+						"characters", path.c_str(),
+						line_num,
+						trace_max_line_length));
+
+			// End of line
+			if (!line.empty() && line.back() == '\n')
+			{
+				line.pop_back();
+				return true;
+			}
+		}
+	}
+};
+
+
+const misc::StringMap System::TraceAccessTypeMap =
+{
+	{ "load", Module::AccessLoad },
+	{ "store", Module::AccessStore },
+	{ "nc-store", Module::AccessNCStore }
+};
+
+
+std::string System::TraceParseLine(const std::string &path, int line_num,
+		const std::string &line, TraceAccess &access)
+{
+	// Skip blank lines and comments
+	std::vector<std::string> tokens;
+	misc::StringTokenize(line, tokens);
+	if (tokens.empty() || tokens[0][0] == '#')
+		return "";
+
+	// Format
+	if (tokens.size() != 4)
+		throw Error(misc::fmt("%s:%d: invalid trace line, expected "
+				"'<cycle> <module> <type> <address>'",
+				path.c_str(), line_num));
+
+	// Cycle
+	misc::StringError error;
+	access.cycle = misc::StringToInt64(tokens[0], error);
+	if (error || access.cycle < 0)
+		throw Error(misc::fmt("%s:%d: invalid cycle '%s'",
+				path.c_str(), line_num, tokens[0].c_str()));
+
+	// Module
+	Module *module = getModule(tokens[1]);
+	if (!module)
+		throw Error(misc::fmt("%s:%d: invalid module '%s'",
+				path.c_str(), line_num, tokens[1].c_str()));
+
+	// Access type
+	bool type_error;
+	access.type = (Module::AccessType) TraceAccessTypeMap.MapString(
+			tokens[2], type_error);
+	if (type_error)
+		throw Error(misc::fmt("%s:%d: invalid access type '%s'. "
+				"Possible values are %s.",
+				path.c_str(), line_num, tokens[2].c_str(),
+				TraceAccessTypeMap.toString().c_str()));
+
+	// Address
+	long long address = misc::StringToInt64(tokens[3], error);
+	if (error || address < 0 || address > 0xffffffffll)
+		throw Error(misc::fmt("%s:%d: invalid address '%s'",
+				path.c_str(), line_num, tokens[3].c_str()));
+	access.address = address;
+
+	// Return module name
+	return tokens[1];
+}
+
+
+void System::TraceSimulation(const std::string &path, int max_in_flight)
+{
+	// Check arguments
+	if (max_in_flight < 1)
+		throw Error(misc::fmt("%s: invalid number of in-flight accesses "
+				"per trace stream (%d)",
+				path.c_str(), max_in_flight));
+
+	// Open trace
+	TraceFile trace_file(path);
+
+	// Simulation loop
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	long long start_cycle = frequency_domain->getCycle();
+	long long cycle = 0;
+	std::string next_module;
+	TraceAccess next_access;
+	bool end_of_file = false;
+	int line_num = 0;
+	std::string line;
+	while (true)
+	{
+		// Queue the accesses of the trace up to the current cycle
+		cycle = frequency_domain->getCycle() - start_cycle;
+		while (!end_of_file)
+		{
+			// Read next access
+			if (next_module.empty())
+			{
+				if (!trace_file.ReadLine(++line_num, line))
+				{
+					end_of_file = true;
+					break;
+				}
+				next_module = TraceParseLine(path, line_num,
+						line, next_access);
+				continue;
+			}
+
+			// Not its cycle yet
+			if (next_access.cycle > cycle)
+				break;
+
+			// Add to its stream
+			TraceStream &stream = trace_streams[next_module];
+			stream.module = getModule(next_module);
+			stream.pending.push_back(next_access);
+			next_module.clear();
+		}
+
+		// Traverse streams
+		bool busy = false;
+		for (auto &it : trace_streams)
+		{
+			// Retire completed accesses
+			TraceStream &stream = it.second;
+			for (auto access = stream.in_flight.begin();
+					access != stream.in_flight.end(); )
+			{
+				if (!access->first)
+				{
+					++access;
+					continue;
+				}
+				trace_total_latency += cycle - access->second;
+				access = stream.in_flight.erase(access);
+			}
+
+			// Issue accesses in order while the stream and the
+			// module have room for them
+			while (!stream.pending.empty())
+			{
+				TraceAccess &access = stream.pending.front();
+				if ((int) stream.in_flight.size() >= max_in_flight ||
+						!stream.module->canAccess(
+						access.address))
+				{
+					trace_num_stalls++;
+					break;
+				}
+				stream.in_flight.emplace_back(0, cycle);
+				stream.module->Access(access.type, access.address,
+						&stream.in_flight.back().first);
+				stream.pending.pop_front();
+				trace_num_accesses++;
+			}
+
+			// Stream still active
+			if (!stream.pending.empty() || !stream.in_flight.empty())
+				busy = true;
+		}
+
+		// Done when the trace ended and all accesses completed
+		if (end_of_file && !busy)
+			break;
+
+		// Next cycle
+		esim_engine->ProcessEvents();
+	}
+
+	// Statistics
+	trace_cycles = cycle;
+}
+
+
+}  // namespace mem
+
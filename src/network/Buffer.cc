@@ -18,6 +18,7 @@
  */
 
 #include <algorithm>
+#include <cassert>
 
 #include "Message.h"
 #include "Network.h"
@@ -33,11 +34,24 @@ Buffer::Buffer(const std::string &name,
 		name(name),
 		index(index),
 		size(size),
-		connection(connection)
+		connection(connection),
+		packets(std::min(std::max(size, 1), (int) InitialQueueCapacity))
 {
 }
 
 
+void Buffer::GrowQueue()
+{
+	// Copy the packets into a queue twice as large, starting at its
+	// first position
+	std::vector<Packet *> new_packets(packets.size() * 2);
+	for (int i = 0; i < num_packets; i++)
+		new_packets[i] = getPacketAt(i);
+	packets.swap(new_packets);
+	packets_head = 0;
+}
+
+
 void Buffer::InsertPacket(Packet *packet)
 {
 	// Check if buffer large enough to hold the packet
@@ -51,7 +65,10 @@ void Buffer::InsertPacket(Packet *packet)
 	UpdateOccupancyInformation();
 
 	// Insert the packet into buffer
-	packets.push_back(packet);
+	if (num_packets == (int) packets.size())
+		GrowQueue();
+	num_packets++;
+	getPacketAt(num_packets - 1) = packet;
 
 	// Debug
 	Message *message = packet->getMessage();
@@ -68,15 +85,20 @@ void Buffer::InsertPacket(Packet *packet)
 void Buffer::RemovePacket(Packet *packet)
 {
 	// Check if the packet is in the buffer
-	if (std::find(packets.begin(), packets.end(), packet) == packets.end())
+	int index = 0;
+	while (index < num_packets && getPacketAt(index) != packet)
+		index++;
+	if (index == num_packets)
 		throw misc::Panic("Trying to remove a packet that is not in"
 				" current buffer");
 
 	// Reduce the occupied size of the buffer
 	count -= packet->getSize();
 
-	// Remove the packet
-	packets.remove(packet);
+	// Remove the packet, shifting the following ones toward the head
+	for (int i = index; i < num_packets - 1; i++)
+		getPacketAt(i) = getPacketAt(i + 1);
+	num_packets--;
 
 	// Wake up the buffer event queue
 	if (!event_queue.isEmpty())
@@ -97,7 +119,7 @@ void Buffer::UpdateOccupancyInformation()
 
 	// Storing the new samples for next use
 	occupancy_in_bytes = count;
-	occupancy_in_packets = packets.size();
+	occupancy_in_packets = num_packets;
 	occupancy_measured_cycle = cycle;
 }
 
@@ -105,14 +127,15 @@ void Buffer::UpdateOccupancyInformation()
 void Buffer::ExtractPacket()
 {
 	// Check if there is a packet to be poped
-	if (packets.size() == 0)
+	if (num_packets == 0)
 		throw misc::Panic("No packets to pop");
 
 	// Get the reference of packet that is going to be poped
-	Packet *packet = packets.front();
+	Packet *packet = packets[packets_head];
 
 	// Remove the packet from the queue
-	packets.pop_front();
+	packets_head = (packets_head + 1) % packets.size();
+	num_packets--;
 
 	// Updating the statistics
 	UpdateOccupancyInformation();
@@ -20,6 +20,9 @@
 #ifndef NETWORK_BUFFER_H
 #define NETWORK_BUFFER_H
 
+#include <cassert>
+#include <vector>
+
 #include <lib/esim/Engine.h>
 #include <lib/esim/Event.h>
 #include <lib/esim/Queue.h>
@@ -29,6 +32,7 @@
 namespace net
 {
 class Connection;
+class Message;
 class Node;
 class Packet;
 
@@ -53,6 +57,10 @@ class Buffer
 	// A queue of events suspended due to the buffer 
 	esim::Queue event_queue;
 
+	// With wormhole flow control, message that reserved the buffer
+	// between the arrival of its first and last packets
+	Message *wormhole_owner = nullptr;
+
 	// Connection that the buffer is connected to
 	Connection *connection;
 
@@ -65,8 +73,30 @@ class Buffer
 	// or a bus.
 	Buffer *scheduled_buffer = nullptr;
 
-	// A list of packets in the buffer
-	std::list<Packet *> packets;
+	// Initial number of entries of the packet queue
+	static const int InitialQueueCapacity = 8;
+
+	// Circular queue of packets in the buffer. It starts with a few
+	// entries and doubles its capacity when full, so that it never
+	// needs more entries than the largest number of packets held at
+	// once, rather than one per byte of buffer size.
+	std::vector<Packet *> packets;
+
+	// Position of the head of the queue in 'packets'
+	int packets_head = 0;
+
+	// Number of packets in the queue
+	int num_packets = 0;
+
+	// Double the capacity of the packet queue
+	void GrowQueue();
+
+	// Return the packet at the given position of the queue, counting
+	// from its head
+	Packet *&getPacketAt(int index)
+	{
+		return packets[(packets_head + index) % packets.size()];
+	}
 
 
 
@@ -111,6 +141,14 @@ public:
 	/// Get count
 	int getCount() const { return count; }
 
+	/// Return the message holding the buffer with wormhole flow control,
+	/// or `nullptr` if the buffer is not reserved.
+	Message *getWormholeOwner() const { return wormhole_owner; }
+
+	/// Reserve the buffer for a message with wormhole flow control, or
+	/// release it if \a message is `nullptr`.
+	void setWormholeOwner(Message *message) { wormhole_owner = message; }
+
 	/// Get buffer's connection.
 	Connection *getConnection() const { return this->connection; }
 
@@ -160,15 +198,23 @@ public:
 	/// Get number of packets in the buffer
 	int getNumPacket()
 	{
-		return packets.size();
+		return num_packets;
 	}
 
 	/// Get the first packet in the buffer
 	Packet *getBufferHead() 
 	{
-		if (packets.empty())
+		if (!num_packets)
 			return nullptr;
-		return packets.front();
+		return packets[packets_head];
+	}
+
+	/// Return the packet at position \a index of the buffer, counting
+	/// from its head
+	Packet *getPacket(int index)
+	{
+		assert(index >= 0 && index < num_packets);
+		return getPacketAt(index);
 	}
 
 	/// Remove a certain packet from the buffer
@@ -36,24 +36,50 @@ Message::Message(long long id,
 		Node *source_node, 
 		Node *destination_node, 
 		int size,
+		int message_class,
 		long long cycle) :
 		id(id),
 		network(network),
 		source_node(source_node),
 		destination_node(destination_node),
 		size(size),
+		message_class(message_class),
 		send_cycle(cycle)
 {
 }
 
 
+void Message::Reset(long long id,
+		Node *source_node,
+		Node *destination_node,
+		int size,
+		int message_class,
+		long long cycle)
+{
+	this->id = id;
+	this->source_node = source_node;
+	this->destination_node = destination_node;
+	this->size = size;
+	this->message_class = message_class;
+	send_cycle = cycle;
+	num_packets = 0;
+	num_received_packets = 0;
+}
+
+
 void Message::Packetize(int packet_size)
 {
-	int packet_count = (size - 1) / packet_size + 1;
-	for (int i = 0; i < packet_count; i++)
+	// Reuse the packets left by a previous use of this message, and
+	// allocate only the missing ones
+	num_packets = (size - 1) / packet_size + 1;
+	num_received_packets = 0;
+	for (int i = 0; i < num_packets; i++)
 	{
-		auto packet = misc::new_unique<Packet>(this, packet_size);
-		this->packets.push_back(std::move(packet));
+		if (i < (int) packets.size())
+			packets[i]->Reset(packet_size);
+		else
+			packets.push_back(misc::new_unique<Packet>(this,
+					i, packet_size));
 	}
 }
 
@@ -61,28 +87,19 @@ void Message::Packetize(int packet_size)
 bool Message::Assemble(Packet *packet)
 {
 	// Check if the packet belongs to this message
-	bool is_packet_belongs_to_message = false;
-	for (auto &message_packet : packets)
-	{
-		if (message_packet.get() == packet)
-		{
-			is_packet_belongs_to_message = true;
-			break;
-		}
-	}
-	if (!is_packet_belongs_to_message)
+	if (packet->getMessage() != this ||
+			packet->getId() >= num_packets ||
+			packets[packet->getId()].get() != packet)
 		throw misc::Panic("Cannot assemble the message from a packet"
 				"that does not belongs this message.");
 
 	// Check if the packet has been assembled before
-	for (auto &received_packet : received_packets)
-	{
-		if (received_packet == packet)
-			throw misc::Panic("Packets have been assembled twice");
-	}
+	if (packet->isReceived())
+		throw misc::Panic("Packets have been assembled twice");
 
 	// Mark the packet has been received
-	received_packets.push_back(packet);
+	packet->setReceived();
+	num_received_packets++;
 
 	// Update the trace with the position of the packet, the depacketizer
 	net::System::trace << misc::fmt("net.packet net=\"%s\" "
@@ -92,7 +109,7 @@ bool Message::Assemble(Packet *packet)
 			packet->getNode()->getName().c_str());
 
 	// Check if all the packets of the message received
-	if (received_packets.size() == packets.size())
+	if (num_received_packets == num_packets)
 	{
 		return true;
 	}
@@ -32,6 +32,9 @@ class Network;
 
 class Message
 {
+	// The network links messages in flight through the intrusive list
+	// pointers below, and recycles received messages.
+	friend class Network;
 
 	// Id of the message
 	long long id;
@@ -48,21 +51,37 @@ class Message
 	// Size of the message
 	int size;
 
-	// A list of packet
+	// Message class, selecting the virtual channels used by its packets
+	int message_class = 0;
+
+	// A list of packets. Packets are kept when the message is recycled,
+	// so only the first 'num_packets' entries belong to the message.
 	std::vector<std::unique_ptr<Packet>> packets;
 
-	// A list of received packets
-	std::vector<Packet *> received_packets;
+	// Number of packets in the message
+	int num_packets = 0;
+
+	// Number of packets collected at the destination
+	int num_received_packets = 0;
 
 	// Cycle when the message was sent
 	long long send_cycle;
 
+	// Previous and next message in the network's list of messages in
+	// flight, or in its list of free messages
+	Message *list_prev = nullptr;
+	Message *list_next = nullptr;
+
+	// Reinitialize a recycled message
+	void Reset(long long id, Node *source_node, Node *destination_node,
+			int size, int message_class, long long cycle);
+
 public:
 
 	/// Constructor
 	Message(long long id, Network *network, 
 			Node *source_node, Node *destination_node,
-			int size, long long cycle);
+			int size, int message_class, long long cycle);
 
 	/// Packetize
 	void Packetize(int packet_size);
@@ -92,11 +111,14 @@ public:
 	/// Get message size
 	int getSize() const { return size; }
 
+	/// Get the message class
+	int getClass() const { return message_class; }
+
 	/// Get the cycle that message was sent
 	long long getSendCycle() const { return send_cycle; }
 
 	/// Get number of packets belongs to the message
-	int getNumPackets() const { return packets.size(); }
+	int getNumPackets() const { return num_packets; }
 
 	/// Get packet by index
 	Packet *getPacket(int index) const { return packets[index].get(); }
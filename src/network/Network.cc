@@ -17,6 +17,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <cstring>
 #include <csignal>
 #include <fstream>
@@ -60,6 +61,17 @@ void Network::ParseConfiguration(misc::IniFile *config,
 			"DefaultBandwidth",0);
 	bool ideal = config->ReadBool(section, "Ideal", false);
 	fix_latency = config->ReadInt(section, "FixLatency", 0);
+	analytic = config->ReadBool(section, "Analytic", false);
+
+	// An analytic network estimates latencies from the topology, which
+	// contradicts a fix latency
+	if (analytic && (ideal || fix_latency))
+		throw Error(misc::fmt("%s: Network %s: variable 'Analytic' "
+				"cannot be combined with 'Ideal' or "
+				"'FixLatency'.\n%s",
+				config->getPath().c_str(),
+				name.c_str(),
+				System::err_config_note));
 
 	// In case both ideal and fix latency variables are set
 	if (ideal && fix_latency)
@@ -98,6 +110,15 @@ void Network::ParseConfiguration(misc::IniFile *config,
 				"ineffective.", name.c_str());
 	}
 
+	// Print a warning in case the analytic model is used
+	if (analytic)
+	{
+		misc::Warning("Network %s: Simulator is using an analytic "
+				"model for the network. Buffers are not "
+				"modeled, and contention in links and buses "
+				"is only estimated.", name.c_str());
+	}
+
 	// Throw an error if default values are not set
 	if (!default_output_buffer_size || !default_input_buffer_size ||
 			!default_bandwidth)
@@ -110,6 +131,16 @@ void Network::ParseConfiguration(misc::IniFile *config,
 	// Packet size
 	packet_size = config->ReadInt(section, "DefaultPacketSize", 0);
 
+	// Virtual channels and flow control
+	default_virtual_channels = config->ReadInt(section, "DefaultVC", 1);
+	if (default_virtual_channels < 1)
+		throw Error(misc::fmt("%s: Network %s: DefaultVC cannot be "
+				"zero/negative.\n%s",
+				config->getPath().c_str(),
+				name.c_str(),
+				System::err_config_note));
+	wormhole = config->ReadBool(section, "Wormhole", false);
+
 	if ((default_output_buffer_size < 0) || 
 			(default_input_buffer_size < 0) ||
 			(default_bandwidth < 0) || 
@@ -136,7 +167,7 @@ void Network::ParseConfiguration(misc::IniFile *config,
 
 	// Parse the routing elements, for manual routing.
 	if (!ParseConfigurationForRoutes(config))
-		routing_table.FloydWarshall();
+		routing_table.CalculateRoutes();
 
 	// If the network with current routing contains a cycle, warn
 	if (routing_table.hasCycle())
@@ -519,7 +550,7 @@ void Network::ParseConfigurationForLinks(misc::IniFile *ini_file)
 
 			// Get number of virtual channels
 			int num_virtual_channel = ini_file->ReadInt(section,
-					"VC", 1);
+					"VC", default_virtual_channels);
 			if (num_virtual_channel < 1)
 				throw Error(misc::fmt("%s: Link '%s', virtual "
 						"channel cannot be "
@@ -820,19 +851,35 @@ void Network::DumpReport(std::ostream &os) const
 
 
 Message *Network::newMessage(EndNode *source_node, EndNode *destination_node,
-		int size)
+		int size, int message_class)
 {
 	// Get the current cycle
 	System *system = System::getInstance();
 	long long cycle = system->getCycle();
 
-	// Insert the created message into the hashtable
-	message_table.emplace(message_id_counter, misc::new_unique<Message>(
-			message_id_counter, this, source_node,
-			destination_node, size, cycle));
+	// Reuse a free message, or allocate a new one
+	Message *message = free_message_head;
+	if (message)
+	{
+		free_message_head = message->list_next;
+		message->Reset(message_id_counter, source_node,
+				destination_node, size, message_class, cycle);
+	}
+	else
+	{
+		message_pool.emplace_back(misc::new_unique<Message>(
+				message_id_counter, this, source_node,
+				destination_node, size, message_class, cycle));
+		message = message_pool.back().get();
+	}
 
-	// Get the pointer to the newly created messag
-	Message *message = message_table[message_id_counter].get();
+	// Insert it at the head of the list of messages in flight
+	message->list_prev = nullptr;
+	message->list_next = in_flight_head;
+	if (in_flight_head)
+		in_flight_head->list_prev = message;
+	in_flight_head = message;
+	num_messages_in_flight++;
 
 	// Increase message id counter
 	message_id_counter++;
@@ -842,24 +889,58 @@ Message *Network::newMessage(EndNode *source_node, EndNode *destination_node,
 }
 
 
+Buffer *Network::getRouteBuffer(Node *node, Node *destination_node,
+		int message_class)
+{
+	// Buffer selected by the route
+	RoutingTable::Entry *entry = routing_table.Lookup(node,
+			destination_node);
+	Buffer *buffer = entry->getBuffer();
+	if (!buffer || !message_class)
+		return buffer;
+
+	// Only links have virtual channels
+	Link *link = dynamic_cast<Link *>(buffer->getConnection());
+	if (!link || link->getNumVirtualChannels() == 1)
+		return buffer;
+
+	// Move to another virtual channel of the same link
+	int num_virtual_channels = link->getNumVirtualChannels();
+	for (int i = 0; i < num_virtual_channels; i++)
+		if (link->getSourceBuffer(i) == buffer)
+			return link->getSourceBuffer((i + message_class) %
+					num_virtual_channels);
+
+	// Unreachable
+	throw misc::Panic(misc::fmt("Buffer %s not found in link %s",
+			buffer->getName().c_str(),
+			link->getName().c_str()));
+}
+
+
 bool Network::CanSend(EndNode *source_node,
 		EndNode *destination_node,
 		int size,
-		esim::Event *retry_event)
+		esim::Event *retry_event,
+		int message_class)
 {
 	// If 'retry_event' was specified, we must be in an event handler
 	esim::Engine *esim_engine = esim::Engine::getInstance();
 	assert(!retry_event || esim_engine->getCurrentEvent());
 
 	// Get output buffer
-	RoutingTable::Entry *entry = routing_table.Lookup(source_node, 
-			destination_node);
-	Buffer *output_buffer = entry->getBuffer();
+	Buffer *output_buffer = getRouteBuffer(source_node, destination_node,
+			message_class);
 
 	// If there is no route, return
 	if (!output_buffer)
 		return false;
 
+	// Analytic networks do not model buffer occupancy, so a message can
+	// always be sent as long as there is a route
+	if (analytic)
+		return true;
+
 	// Get current cycle
 	System *system = System::getInstance();
 	long long cycle = system->getCycle();
@@ -900,13 +981,15 @@ bool Network::CanSend(EndNode *source_node,
 Message *Network::Send(EndNode *source_node,
 		EndNode *destination_node,
 		int size,
-		esim::Event *receive_event)
+		esim::Event *receive_event,
+		int message_class)
 {
 	// Get esim engine
 	esim::Engine *esim_engine = esim::Engine::getInstance();
 
 	// Create message
-	Message *message = newMessage(source_node, destination_node, size);
+	Message *message = newMessage(source_node, destination_node, size,
+			message_class);
 
 	// Updating trace with new message creation
 	net::System::trace << misc::fmt("net.new_msg net=\"%s\" "
@@ -914,8 +997,9 @@ Message *Network::Send(EndNode *source_node,
 			name.c_str(), message->getId(),
 			message->getSize(), source_node->getName().c_str());
 
-	// Packetize message
-	if (packet_size == 0)
+	// Packetize message. Analytic networks transfer the message as a
+	// whole, since its latency is estimated in a single step.
+	if (packet_size == 0 || analytic)
 		message->Packetize(size);
 	else 
 		message->Packetize(packet_size);
@@ -979,7 +1063,8 @@ Message *Network::TrySend(EndNode *source_node,
 		EndNode *destination_node,
 		int size,
 		esim::Event *receive_event,
-		esim::Event *retry_event)
+		esim::Event *retry_event,
+		int message_class)
 {
 	// Get output buffer
 	RoutingTable::Entry *entry = routing_table.Lookup(source_node, 
@@ -993,11 +1078,13 @@ Message *Network::TrySend(EndNode *source_node,
 				destination_node->getName().c_str()));
 
 	// Check if message can be sent
-	if (!CanSend(source_node, destination_node, size, retry_event))
+	if (!CanSend(source_node, destination_node, size, retry_event,
+			message_class))
 		return nullptr;
 
 	// Send message
-	return Send(source_node, destination_node, size, receive_event);
+	return Send(source_node, destination_node, size, receive_event,
+			message_class);
 }
 
 
@@ -1020,6 +1107,10 @@ void Network::Receive(EndNode *node, Message *message)
 	transfers++;
 	accumulated_bytes += message->getSize();
 	accumulated_latency += cycle - message->getSendCycle();
+	unsigned latency = cycle - message->getSendCycle();
+	if (latency >= latency_histogram.size())
+		latency_histogram.resize(latency + 1);
+	latency_histogram[latency]++;
 
 	// Remove packets from their buffer
 	for (int i = 0; i < message->getNumPackets(); i++)
@@ -1030,7 +1121,7 @@ void Network::Receive(EndNode *node, Message *message)
 		// In the case the network is fixed, there are no
 		// buffer insertion and extraction. Otherwise, extract
 		// from buffer and report in trace
-		if (!hasConstantLatency())
+		if (!hasConstantLatency() && !analytic)
 		{
 			// Remove the packet from buffer
 			buffer->RemovePacket(packet);
@@ -1065,8 +1156,75 @@ void Network::Receive(EndNode *node, Message *message)
 	System::trace << misc::fmt("net.end_msg net=\"%s\" name=\"M-%lld\"\n",
 			name.c_str(), message->getId());
 
-	// Destroy the message
-	message_table.erase(message->getId());
+	// Remove the message from the list of messages in flight
+	if (message->list_prev)
+		message->list_prev->list_next = message->list_next;
+	else
+		in_flight_head = message->list_next;
+	if (message->list_next)
+		message->list_next->list_prev = message->list_prev;
+	num_messages_in_flight--;
+
+	// Recycle the message
+	message->list_prev = nullptr;
+	message->list_next = free_message_head;
+	free_message_head = message;
+}
+
+
+long long Network::CalculateAnalyticLatency(Node *source_node,
+		Node *destination_node,
+		int size)
+{
+	// Insertion in the source output buffer takes one cycle
+	long long cycle = System::getInstance()->getCycle();
+	long long arrival = cycle + 1;
+
+	// Traverse the route hop by hop
+	Node *node = source_node;
+	while (node != destination_node)
+	{
+		RoutingTable::Entry *entry = routing_table.Lookup(node,
+				destination_node);
+		Buffer *buffer = entry->getBuffer();
+		if (!buffer)
+			throw Error(misc::fmt("No route from '%s' to '%s'.",
+					source_node->getName().c_str(),
+					destination_node->getName().c_str()));
+
+		// Bandwidth of the connection. A bus can use all its lanes
+		// for different messages, which is approximated here as a
+		// single connection with the aggregate bandwidth.
+		Connection *connection = buffer->getConnection();
+		int bandwidth = default_bandwidth;
+		if (Link *link = dynamic_cast<Link *>(connection))
+		{
+			bandwidth = link->getBandwidth();
+		}
+		else if (Bus *bus = dynamic_cast<Bus *>(connection))
+		{
+			bandwidth = 0;
+			for (int i = 0; i < bus->getNumberLanes(); i++)
+				bandwidth += bus->getLaneByIndex(i)->getBandwidth();
+		}
+		assert(bandwidth > 0);
+
+		// The message starts crossing the connection as soon as it
+		// arrives and the connection is released by earlier messages.
+		// Crossing it takes the serialization latency, as in
+		// Link::TransferPacket().
+		int latency = (size - 1) / bandwidth + 1;
+		long long &busy = analytic_busy[connection];
+		long long start = std::max(arrival, busy + 1);
+		busy = start + latency - 1;
+		arrival = start + latency;
+
+		// Next hop
+		node = entry->getNextNode();
+	}
+
+	// Return latency
+	return arrival - cycle;
 }
 
 
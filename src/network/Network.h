@@ -51,8 +51,20 @@ class Network
 	// Message ID counter
 	long long message_id_counter = 0;
 
-	// A hashtable of messages in flight
-	std::unordered_map<long long, std::unique_ptr<Message>> message_table;
+	// All messages ever allocated by the network. A received message is
+	// not destroyed, but moved to the free list and reused by a later
+	// call to newMessage(), together with its packets.
+	std::vector<std::unique_ptr<Message>> message_pool;
+
+	// Doubly linked list of messages in flight, threaded through the
+	// messages themselves
+	Message *in_flight_head = nullptr;
+
+	// Number of messages in flight
+	int num_messages_in_flight = 0;
+
+	// Singly linked list of free messages
+	Message *free_message_head = nullptr;
 
 	// List of nodes in the network
 	std::vector<std::unique_ptr<Node>> nodes;
@@ -106,6 +118,14 @@ class Network
 	// Defaule packet size - zero means no packeting
 	int packet_size = 0;
 
+	// Default number of virtual channels for links
+	int default_virtual_channels = 1;
+
+	// Wormhole flow control. If activated, once the first packet of a
+	// message enters an output buffer of a switch, the buffer is
+	// reserved for the message until its last packet enters it.
+	bool wormhole = false;
+
 	// fix latency of the network. If activated
 	// the network sends the messages with a fixed latency
 	// regardless of the topology.
@@ -113,6 +133,17 @@ class Network
 	// of 1.
 	int fix_latency = 0;
 
+	// Analytic network. If activated, messages are not moved through
+	// buffers and connections. Their latency is instead estimated
+	// from the hop count, the bandwidth of the connections along the
+	// route, and the cycle until which each connection is busy with
+	// previously sent messages.
+	bool analytic = false;
+
+	// Cycle until which each connection is busy with a message, used
+	// as a contention estimate in analytic networks
+	std::unordered_map<Connection *, long long> analytic_busy;
+
 
 	
 	//
@@ -128,6 +159,9 @@ class Network
 	// Accumulation of size of all messages in the network
 	long long accumulated_bytes = 0;
 
+	// Number of messages received for each latency in cycles
+	std::vector<long long> latency_histogram;
+
 
 
 
@@ -182,12 +216,61 @@ public:
 	/// Get the fix delay of the network
 	int getFixLatency() const {return fix_latency; }
 
+	/// Return whether the network uses wormhole flow control, as given
+	/// by variable 'Wormhole' in the network configuration.
+	bool isWormhole() const { return wormhole; }
+
+	/// Return the buffer where a packet located at \a node continues
+	/// its way to \a destination_node. The route in the routing table
+	/// selects a link and a virtual channel. Messages of a class other
+	/// than 0 are moved to a different virtual channel of the same
+	/// link, offset by the class number, so that message classes do not
+	/// block each other when the link has enough virtual channels.
+	///
+	/// \return
+	///	The output buffer, or `nullptr` if there is no route.
+	Buffer *getRouteBuffer(Node *node, Node *destination_node,
+			int message_class);
+
+	/// Return whether the network uses the analytic model, as given by
+	/// variable 'Analytic' in the network configuration.
+	bool isAnalytic() const { return analytic; }
+
+	/// Estimate the latency of a message of \a size bytes sent at the
+	/// current cycle from \a source_node to \a destination_node in an
+	/// analytic network. Each connection along the route is reserved
+	/// for the serialization time of the message, so that later
+	/// messages sharing the connection observe contention.
+	///
+	/// \return
+	///	Number of cycles until the message reaches its destination.
+	long long CalculateAnalyticLatency(Node *source_node,
+			Node *destination_node,
+			int size);
+
+	/// Return the number of messages received
+	long long getTransfers() const { return transfers; }
+
+	/// Return the histogram of message latencies. Element \a i is the
+	/// number of messages received \a i cycles after they were sent.
+	const std::vector<long long> &getLatencyHistogram() const
+	{
+		return latency_histogram;
+	}
+
+	/// Return the number of messages sent and not received yet.
+	int getNumMessagesInFlight() const { return num_messages_in_flight; }
+
+	/// Return the number of message objects allocated by the network,
+	/// including those in flight and those ready to be reused.
+	int getNumAllocatedMessages() const { return message_pool.size(); }
+
 	/// Create a message to be transfered in the network. The network 
-	/// keeps the ownership of the message. Message is destoried when it 
+	/// keeps the ownership of the message. Message is recycled when it 
 	/// is received by the \a destination node.
 	///
 	Message *newMessage(EndNode *source_node, EndNode *destination_node,
-			int size);
+			int size, int message_class = 0);
 
 	/// Check if a message can be sent throught from the given source to
 	/// the given destination node. A message can be sent if:
@@ -220,10 +303,15 @@ public:
 	///	away. If not, the function returns false and schedules event
 	///	`retry_event` if other than `nullptr`.
 	///
+	/// \param message_class
+	///	Class of the message, used to select its virtual channel. See
+	///	getRouteBuffer().
+	///
 	bool CanSend(EndNode *source_node,
 			EndNode *destination_node,
 			int size,
-			esim::Event *retry_event = nullptr);
+			esim::Event *retry_event = nullptr,
+			int message_class = 0);
 
 	/// Send a message through network.
 	///
@@ -244,6 +332,10 @@ public:
 	///	invoked within an event handler, the current event frame will
 	///	be available once `receive_event` is scheduled.
 	///
+	/// \param message_class
+	///	Class of the message, used to select its virtual channel. See
+	///	getRouteBuffer().
+	///
 	/// \return
 	///	The function returns a new message object internally used in
 	///	the network to track the progress of the packets. Careful: the
@@ -254,7 +346,8 @@ public:
 	Message *Send(EndNode *source_node,
 			EndNode *destination_node,
 			int size,
-			esim::Event *receive_event = nullptr);
+			esim::Event *receive_event = nullptr,
+			int message_class = 0);
 
 	/// Send a message through the network, only if it is possible to send
 	/// it right away. A message can be sent if:
@@ -290,6 +383,10 @@ public:
 	///	time. The current event frame will be available at that time.
 	///	This argument has no effect if the message was sent right away.
 	///
+	/// \param message_class
+	///	Class of the message, used to select its virtual channel. See
+	///	getRouteBuffer().
+	///
 	/// \return
 	///	If the message was sent right away, the function returns a
 	///	pointer to the created message object. Careful: the validity of
@@ -301,14 +398,16 @@ public:
 			EndNode *destination_node,
 			int size,
 			esim::Event *receive_event = nullptr,
-			esim::Event *retry_event = nullptr);
+			esim::Event *retry_event = nullptr,
+			int message_class = 0);
 
 
 	/// Absorb a message located at the head of the input buffer of a
 	/// node. The caller must make sure that this is the actual location
 	/// of the message. This function should be called when the
 	/// `receive_event` is triggered after a call to Send() or TrySend().
-	/// The message object is freed in this call.
+	/// The message object is recycled in this call, and may be returned
+	/// again by a later call to Send() or TrySend().
 	void Receive(EndNode *node, Message *message);
 
 
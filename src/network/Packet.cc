@@ -23,12 +23,22 @@
 namespace net
 {
 
-Packet::Packet(Message *message, int size) :
+Packet::Packet(Message *message, int id, int size) :
 		message(message),
-		size(size)
+		size(size),
+		id(id)
 {
-	// Assigning the packet's id
-	id = message->getNumPackets();
+	Reset(size);
+}
+
+
+void Packet::Reset(int size)
+{
+	this->size = size;
+	busy = 0;
+	node = nullptr;
+	buffer = nullptr;
+	received = false;
 }
 
 }  // namespace net
@@ -46,11 +46,17 @@ class Packet
 	// Current position in the network, which buffer it is at
 	Buffer *buffer;
 
+	// Whether the packet has been collected at its destination
+	bool received = false;
 
 public:
 
 	/// Constructor
-	Packet(Message *message, int size);
+	Packet(Message *message, int id, int size);
+
+	/// Prepare the packet to be reused by a new message with the same
+	/// owner, giving it a new size.
+	void Reset(int size);
 
 	/// Get session id
 	int getId() const { return id; }
@@ -79,6 +85,12 @@ public:
 	/// Get the cycle which the packet is busy
 	long long getBusy() const { return busy; }
 
+	/// Return whether the packet has been assembled at its destination
+	bool isReceived() const { return received; }
+
+	/// Mark the packet as assembled at its destination
+	void setReceived() { received = true; }
+
 };
 
 }  // namespace net
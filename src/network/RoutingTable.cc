@@ -17,12 +17,16 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <climits>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <unistd.h>
 
 #include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
 
 #include "Node.h"
 #include "Network.h"
@@ -52,15 +56,11 @@ void RoutingTable::Initialize()
 	dimension = network->getNumNodes();
 
 	// Initiate table with infinite costs
+	entries.reserve(dimension * dimension);
 	for (int i = 0; i < dimension; i++)
-	{
 		for (int j = 0; j < dimension; j++)
-		{
-			entries.emplace_back(misc::new_unique<Entry>(
-					i == j ? 0 : dimension, 
-					nullptr, nullptr));
-		}
-	}
+			entries.emplace_back(i == j ? 0 : dimension,
+					nullptr, nullptr);
 
 	// Set 1-hop connections
 	for (int i = 0; i < dimension; i++)
@@ -90,92 +90,233 @@ void RoutingTable::Initialize()
 }
 
 
-void RoutingTable::FloydWarshall()
+unsigned long long RoutingTable::getTopologyHash() const
 {
-	// The entry->next_node values do not necessarily point
-	// to the immediate next hop after this.
-	for (int k = 0; k < dimension; k++)
+	// FNV-1a hash of node names and connected node indices
+	unsigned long long hash = 14695981039346656037ull;
+	auto add = [&hash](unsigned long long value)
 	{
-		for (int i = 0; i < dimension; i++)
+		hash = (hash ^ value) * 1099511628211ull;
+	};
+	add(dimension);
+	for (int i = 0; i < dimension; i++)
+	{
+		Node *node = network->getNode(i);
+		for (char c : node->getName())
+			add(c);
+		add(node->getNumOutputBuffers());
+		for (int j = 0; j < node->getNumOutputBuffers(); j++)
 		{
-			for (int j = 0; j < dimension; j++)
-			{
-				Node *node_i = network->getNode(i);
-				Node *node_j = network->getNode(j);
-				Node *node_k = network->getNode(k);
+			Connection *connection = node->getOutputBuffer(j)->
+					getConnection();
+			add(connection->getNumDestinationBuffers());
+			for (int k = 0; k < connection->getNumDestinationBuffers();
+					k++)
+				add(connection->getDestinationBuffer(k)->
+						getNode()->getIndex());
+		}
+	}
+	return hash;
+}
 
-				Entry *entry_i_k = Lookup(node_i,node_k);
-				Entry *entry_k_j = Lookup(node_k,node_j);
-				Entry *entry_i_j = Lookup(node_i,node_j);
 
-				int temp_cost = entry_i_k->cost +
-						entry_k_j->cost;
-				if (entry_i_j->cost > temp_cost)
-				{
-					entry_i_j->cost = temp_cost;
-					entry_i_j->setNextNode(node_k);
-				}
-			}
-		}
+bool RoutingTable::LoadRoutes(const std::string &path)
+{
+	// Open file
+	std::ifstream f(path);
+	if (!f)
+		return false;
+
+	// Check header
+	std::string magic;
+	int file_dimension;
+	int num_file_entries;
+	f >> magic >> file_dimension >> num_file_entries;
+	if (!f || magic != "m2s-routes" || file_dimension != dimension ||
+			!misc::inRange(num_file_entries, 0,
+			dimension * dimension))
+		return false;
+
+	// Read entries with a next node. Entries not present in the file
+	// are unreachable.
+	std::vector<Entry> file_entries(entries.size(),
+			Entry(dimension, nullptr, nullptr));
+	for (int i = 0; i < dimension; i++)
+		file_entries[i * dimension + i].cost = 0;
+	for (int n = 0; n < num_file_entries; n++)
+	{
+		int source, destination, cost, next, buffer;
+		if (!(f >> source >> destination >> cost >> next >> buffer))
+			return false;
+		if (!misc::inRange(source, 0, dimension - 1) ||
+				!misc::inRange(destination, 0, dimension - 1) ||
+				!misc::inRange(next, 0, dimension - 1))
+			return false;
+		Node *node = network->getNode(source);
+		if (!misc::inRange(buffer, 0, node->getNumOutputBuffers() - 1))
+			return false;
+		Entry &entry = file_entries[source * dimension + destination];
+		entry.cost = cost;
+		entry.setNextNode(network->getNode(next));
+		entry.setBuffer(node->getOutputBuffer(buffer));
 	}
 
-	// Calculating the output buffer for the entry.
-	Node *next_node = nullptr;
-	Entry *entry = nullptr;
+	// A truncated file lacks the trailer, and a damaged one may have
+	// more entries than announced in the header
+	std::string trailer;
+	f >> trailer;
+	if (!f || trailer != "end" || (f >> trailer))
+		return false;
+
+	// Success
+	entries = std::move(file_entries);
+	return true;
+}
+
+
+void RoutingTable::SaveRoutes(const std::string &path) const
+{
+	// Count entries with a next node
+	int num_file_entries = 0;
+	for (const Entry &entry : entries)
+		if (entry.getNextNode())
+			num_file_entries++;
+
+	// Write into a temporary file first, so that an interrupted write or
+	// another simulator saving the same routes never leaves a truncated
+	// file under the final name
+	std::string temp_path = misc::fmt("%s.%d.tmp", path.c_str(),
+			(int) getpid());
+	std::ofstream f(temp_path);
+	if (!f)
+		throw Error(misc::fmt("%s: cannot open file for write",
+				temp_path.c_str()));
+
+	// Dump entries with a next node
+	f << "m2s-routes " << dimension << ' ' << num_file_entries << '\n';
 	for (int i = 0; i < dimension; i++)
 	{
 		for (int j = 0; j < dimension; j++)
 		{
+			const Entry &entry = entries[i * dimension + j];
+			if (!entry.getNextNode())
+				continue;
+			f << i << ' ' << j << ' ' << entry.cost << ' '
+					<< entry.getNextNode()->getIndex() << ' '
+					<< entry.getBuffer()->getIndex() << '\n';
+		}
+	}
+	f << "end\n";
 
-			Node *node_i = network->getNode(i);
-			Node *node_j = network->getNode(j);
+	// Move the complete file into place
+	f.close();
+	if (!f || rename(temp_path.c_str(), path.c_str()))
+	{
+		unlink(temp_path.c_str());
+		throw Error(misc::fmt("%s: cannot write file",
+				path.c_str()));
+	}
+}
 
-			auto entry_i_j = Lookup(node_i, node_j);
-			next_node = entry_i_j->getNextNode();
 
-			if (!next_node)
+void RoutingTable::CalculateRoutes()
+{
+	// Look for the routes in the cache
+	std::string cache_path;
+	const std::string &cache_directory = System::getRouteCacheDirectory();
+	if (!cache_directory.empty())
+	{
+		cache_path = misc::fmt("%s/%s-%016llx.routes",
+				cache_directory.c_str(),
+				network->getName().c_str(),
+				getTopologyHash());
+		if (LoadRoutes(cache_path))
+			return;
+	}
+
+	// Connections leaving each node, as pairs of output buffer and
+	// destination node, in the order of the node's output buffers. Also
+	// record the nodes with connections reaching each node.
+	std::vector<std::vector<std::pair<Buffer *, Node *>>>
+			successors(dimension);
+	std::vector<std::vector<int>> predecessors(dimension);
+	for (int i = 0; i < dimension; i++)
+	{
+		Node *node = network->getNode(i);
+		for (int j = 0; j < node->getNumOutputBuffers(); j++)
+		{
+			Buffer *buffer = node->getOutputBuffer(j);
+			Connection *connection = buffer->getConnection();
+			for (int k = 0; k < connection->getNumDestinationBuffers();
+					k++)
 			{
-				entry_i_j->setBuffer(nullptr);
-				continue;
+				Node *destination_node = connection->
+						getDestinationBuffer(k)->getNode();
+				if (destination_node == node)
+					continue;
+				successors[i].emplace_back(buffer,
+						destination_node);
+				predecessors[destination_node->getIndex()].
+						push_back(i);
 			}
+		}
+	}
 
-			// Follow the buffers path
-			for (;;)
+	// Breadth-first search from each destination, following connections
+	// backwards to obtain the distance in hops from every node
+	std::vector<int> distance(dimension);
+	std::vector<int> queue(dimension);
+	for (int j = 0; j < dimension; j++)
+	{
+		std::fill(distance.begin(), distance.end(), -1);
+		distance[j] = 0;
+		queue[0] = j;
+		int head = 0;
+		int tail = 1;
+		while (head < tail)
+		{
+			int index = queue[head++];
+			for (int predecessor : predecessors[index])
 			{
-				entry = Lookup(node_i, next_node);
-				if (entry->cost <= 1)
-					break;
-				next_node = entry->getNextNode();
+				if (distance[predecessor] >= 0)
+					continue;
+				distance[predecessor] = distance[index] + 1;
+				queue[tail++] = predecessor;
 			}
+		}
 
-			// Get the output buffer based on the next node
-			for (int k = 0; k < node_i->getNumOutputBuffers(); k++)
+		// The next hop from each source is the first neighbor that is
+		// one hop closer to the destination, in the order of the
+		// node's output buffers. When several shortest routes exist,
+		// this tie-breaking may pick a different one than the
+		// Floyd-Warshall algorithm used by earlier versions, although
+		// with the same cost.
+		for (int i = 0; i < dimension; i++)
+		{
+			Entry &entry = entries[i * dimension + j];
+			entry.setNextNode(nullptr);
+			entry.setBuffer(nullptr);
+			if (i == j || distance[i] < 0)
 			{
-				Buffer *buffer = node_i->getOutputBuffer(k);
-				bool found = false;
-				Connection *connection = buffer->getConnection();
-				for (int m = 0; m < connection->
-						getNumDestinationBuffers(); 
-						m++)
-				{
-					Buffer *destination_buffer = 
-						connection->
-						getDestinationBuffer(m);
-					Node *receive_node = 
-							destination_buffer->
-							getNode();
-					if (next_node != receive_node)
-						continue;
-					entry_i_j->setNextNode(receive_node);
-					entry_i_j->setBuffer(buffer);
-					found = true;
-					break;
-				}
-				if (found)
-					break;
+				entry.cost = i == j ? 0 : dimension;
+				continue;
+			}
+			entry.cost = distance[i];
+			for (auto &successor : successors[i])
+			{
+				if (distance[successor.second->getIndex()] !=
+						distance[i] - 1)
+					continue;
+				entry.setNextNode(successor.second);
+				entry.setBuffer(successor.first);
+				break;
 			}
 		}
 	}
+
+	// Save routes in the cache
+	if (!cache_path.empty())
+		SaveRoutes(cache_path);
 }
 
 
@@ -338,15 +479,25 @@ bool RoutingTable::hasCycle()
 }
 
 
-RoutingTable::Entry *RoutingTable::Lookup(Node *source,
-		Node *destination) const
+int RoutingTable::getEntryIndex(Node *source, Node *destination) const
 {
 	int i = source->getIndex();
 	int j = destination->getIndex();
 	assert((dimension > 0) && (i < dimension) && (j < dimension));
+	return i * dimension + j;
+}
+
 
-	int location = i * dimension + j;
-	return entries.at(location).get();
+RoutingTable::Entry *RoutingTable::Lookup(Node *source, Node *destination)
+{
+	return &entries[getEntryIndex(source, destination)];
+}
+
+
+const RoutingTable::Entry *RoutingTable::Lookup(Node *source,
+		Node *destination) const
+{
+	return &entries[getEntryIndex(source, destination)];
 }
 
 
@@ -370,7 +521,7 @@ void RoutingTable::Dump(std::ostream &os) const
 			unsigned int entry_text_size = 0;
 
 			// Get the entry of the table
-			Entry *entry = Lookup(node_i, network->getNode(j));
+			const Entry *entry = Lookup(node_i, network->getNode(j));
 
 			// Get the string size of the members that
 			// will be printed, and add them up
@@ -457,7 +608,7 @@ void RoutingTable::Dump(std::ostream &os) const
 		for (int j = 0; j < dimension; j++)
 		{
 			Node *node_j = network->getNode(j);
-			Entry *entry = Lookup(node_i,node_j);
+			const Entry *entry = Lookup(node_i,node_j);
 
 			// First we have to create the string that will be
 			// printed for each element:
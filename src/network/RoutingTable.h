@@ -20,6 +20,7 @@
 #ifndef NETWORK_ROUTINGTABLE_H
 #define NETWORK_ROUTINGTABLE_H
 
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -82,8 +83,26 @@ private:
 	// Dimension
 	int dimension = 0;
 
-	// Entries
-	std::vector<std::unique_ptr<Entry>> entries;
+	// Entries, indexed by source node index times the dimension plus the
+	// destination node index
+	std::vector<Entry> entries;
+
+	// Return a hash of the nodes and connections of the network, used to
+	// identify the routing table in the route cache
+	unsigned long long getTopologyHash() const;
+
+	// Return the index in 'entries' of the entry from a certain node to
+	// a certain node
+	int getEntryIndex(Node *source, Node *destination) const;
+
+	// Load the routes from a file in the route cache. Return false if the
+	// file does not exist, does not match the network, or is incomplete.
+	bool LoadRoutes(const std::string &path);
+
+	// Save the routes into a file in the route cache. The file is written
+	// under a temporary name and then renamed, so that readers never see
+	// a partially written file.
+	void SaveRoutes(const std::string &path) const;
 
 public:
 
@@ -98,11 +117,20 @@ public:
 	/// the table structures.
 	void Initialize();
 
-	/// Perform a Floyd-Warshall to find the best routes
-	void FloydWarshall();
+	/// Find the shortest routes between all pairs of nodes, with a
+	/// breadth-first search from each destination node. Among several
+	/// shortest routes, the next hop is the first one found in the order
+	/// of the node's output buffers, which may differ from the route
+	/// chosen by the Floyd-Warshall algorithm of earlier versions. If
+	/// option '--net-route-cache' is given, routes are loaded from the
+	/// cache when available, and saved into it otherwise.
+	void CalculateRoutes();
+
+	/// Look up the entry from a certain node to a certain node
+	Entry *Lookup(Node *source, Node *destination);
 
 	/// Look up the entry from a certain node to a certain node
-	Entry *Lookup(Node *source, Node *destination) const;
+	const Entry *Lookup(Node *source, Node *destination) const;
 
 	/// Generating the route file
 	void DumpRoutes(const std::string &path);
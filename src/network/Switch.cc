@@ -96,17 +96,35 @@ void Switch::Forward(Packet *packet)
 	}
 
 	// Look up the routing table for next output buffer
-	RoutingTable *routing_table = network->getRoutingTable();
 	Node *destination_node = message->getDestinationNode();
-	RoutingTable::Entry *entry = 
-			routing_table->Lookup(node, destination_node);
-	if (!entry) 
+	Buffer *output_buffer = network->getRouteBuffer(node,
+			destination_node, message->getClass());
+	if (!output_buffer) 
 		throw misc::Panic(misc::fmt("%s: no route from %s "
 				"to %s.",
 				network->getName().c_str(), 
 				node->getName().c_str(), 
 				destination_node->getName().c_str()));
-	Buffer *output_buffer = entry->getBuffer();
+
+	// With wormhole flow control, wait while the output buffer is
+	// reserved by another message
+	Message *owner = output_buffer->getWormholeOwner();
+	if (owner && owner != message)
+	{
+		// Update debug information
+		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+				"stl_wormhole_sw_dst_buf: %s:%s\n",
+				network->getName().c_str(),
+				message->getId(),
+				packet->getId(),
+				output_buffer->getNode()->
+				getName().c_str(),
+				output_buffer->getName().c_str());
+
+		// Come back when the buffer is released
+		output_buffer->Wait(current_event);
+		return;
+	}
 
 	// Check if the output buffer is busy
 	if (output_buffer->write_busy >= cycle)
@@ -203,6 +221,21 @@ void Switch::Forward(Packet *packet)
 	packet->setBuffer(output_buffer);
 	packet->setBusy(cycle + latency - 1);
 
+	// With wormhole flow control, the first packet of a message reserves
+	// the output buffer, and the last one releases it
+	if (network->isWormhole())
+	{
+		if (packet->getId() == message->getNumPackets() - 1)
+		{
+			output_buffer->setWormholeOwner(nullptr);
+			output_buffer->Wakeup();
+		}
+		else if (packet->getId() == 0)
+		{
+			output_buffer->setWormholeOwner(message);
+		}
+	}
+
 	// Buffer's trace information
 	System::trace << misc::fmt("net.packet_extract "
 			"net=\"%s\" node=\"%s\" buffer=\"%s\" "
@@ -292,17 +325,21 @@ Buffer *Switch::Schedule(Buffer *output_buffer)
 		Message *message = packet->getMessage();
 		Node *destination_node = message->getDestinationNode();
 		Network *network = message->getNetwork();
-		RoutingTable *routingTable = network->getRoutingTable();
-		RoutingTable::Entry *entry = routingTable->Lookup(this, 
-				destination_node);
-		if (!entry) 
+		Buffer *next_buffer = network->getRouteBuffer(this,
+				destination_node, message->getClass());
+		if (!next_buffer) 
 			throw misc::Panic(misc::fmt("No route found from "
 					"node %s to node %s", 
 					this->getName().c_str(),
 					destination_node->getName().c_str()));
-		Buffer *next_buffer = entry->getBuffer();
 		if (next_buffer != output_buffer)
 			continue;
+
+		// Skip packets of other messages while a message holds the
+		// output buffer with wormhole flow control
+		Message *owner = output_buffer->getWormholeOwner();
+		if (owner && owner != message)
+			continue;
 	
 		// There must be enough space left in the output buffer
 		if (output_buffer->getCount() + packet->getSize() > 
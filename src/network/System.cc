@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <fstream>
+
 #include <lib/cpp/CommandLine.h>
 #include <lib/esim/Engine.h>
 #include <lib/cpp/Misc.h>
@@ -39,6 +41,8 @@ std::string System::graph_file;
 
 std::string System::route_file;
 
+std::string System::route_cache_directory;
+
 misc::Debug System::debug;
 
 esim::Trace System::trace;
@@ -53,6 +57,35 @@ double System::injection_rate = 0.001;
 
 bool System::stand_alone = false;
 
+int System::traffic_pattern = TrafficUniform;
+
+int System::injection_process = InjectionExponential;
+
+double System::hotspot_fraction = 0.2;
+
+double System::burst_length = 10;
+
+std::string System::sweep_file;
+
+int System::sweep_steps = 20;
+
+const misc::StringMap System::TrafficPatternMap =
+{
+	{ "uniform", TrafficUniform },
+	{ "transpose", TrafficTranspose },
+	{ "bit-complement", TrafficBitComplement },
+	{ "hotspot", TrafficHotspot },
+	{ "neighbor", TrafficNeighbor },
+	{ "tornado", TrafficTornado }
+};
+
+const misc::StringMap System::InjectionProcessMap =
+{
+	{ "exponential", InjectionExponential },
+	{ "bernoulli", InjectionBernoulli },
+	{ "bursty", InjectionBursty }
+};
+
 bool System::help = false;
 
 int System::frequency = 1000;
@@ -150,6 +183,66 @@ void System::RegisterOptions()
 			"lambda = <rate>. This option must be used together "
 			"with '--net-sim'.");
 
+	// Traffic pattern for stand-alone simulator
+	command_line->RegisterEnum("--net-traffic {uniform|transpose|"
+			"bit-complement|hotspot|neighbor|tornado} "
+			"(default = uniform)",
+			traffic_pattern, TrafficPatternMap,
+			"For network simulation, destination of the messages "
+			"injected by each end node, with end nodes numbered in "
+			"the order they appear in the network. 'uniform' picks "
+			"random destinations, 'transpose' swaps the row and "
+			"column of the node in a square grid, 'bit-complement' "
+			"sends node i to node N-1-i, 'hotspot' sends a fraction "
+			"of the messages to node 0 (option "
+			"'--net-hotspot-fraction'), 'neighbor' sends node i to "
+			"node i+1, and 'tornado' sends node i halfway around the "
+			"nodes. This option must be used together with "
+			"'--net-sim'.");
+
+	// Injection process for stand-alone simulator
+	command_line->RegisterEnum("--net-injection {exponential|bernoulli|"
+			"bursty} (default = exponential)",
+			injection_process, InjectionProcessMap,
+			"For network simulation, process used to inject messages "
+			"at the rate given in '--net-injection-rate'. "
+			"'exponential' uses random delays with exponential "
+			"distribution, 'bernoulli' injects a message in each "
+			"cycle with a probability equal to the rate, and "
+			"'bursty' alternates on and off periods, injecting one "
+			"message per cycle while on (option "
+			"'--net-burst-length').");
+
+	// Hotspot fraction
+	command_line->RegisterDouble("--net-hotspot-fraction <fraction> "
+			"(default = 0.2)",
+			hotspot_fraction,
+			"Fraction of the messages sent to the hotspot node with "
+			"'--net-traffic hotspot'.");
+
+	// Burst length
+	command_line->RegisterDouble("--net-burst-length <cycles> "
+			"(default = 10)",
+			burst_length,
+			"Average length of the bursts in cycles with "
+			"'--net-injection bursty'.");
+
+	// Injection rate sweep
+	command_line->RegisterString("--net-sweep <file>", sweep_file,
+			"For network simulation, run steps of increasing "
+			"injection rate, equal to the step number times the rate "
+			"given in '--net-injection-rate'. Each step injects "
+			"traffic for '--net-max-cycles' cycles and then drains "
+			"the network. The average and percentile latency and "
+			"the offered and accepted throughput of each step are "
+			"dumped into <file>, stopping when the network "
+			"saturates.");
+	command_line->RegisterInt32("--net-sweep-steps <number> "
+			"(default = 20)",
+			sweep_steps,
+			"Maximum number of steps of the sweep requested with "
+			"'--net-sweep'.");
+
 	// Stand-alone simulator
 	command_line->RegisterString("--net-sim <network name>",
 			sim_net_name,
@@ -183,6 +276,14 @@ void System::RegisterOptions()
 			"Files for representing the routing table of each individual "
 			"network. The input is a string that consequently creates "
 			"an individual file for each network.");
+
+	// Routing table cache
+	command_line->RegisterString("--net-route-cache <directory>",
+			route_cache_directory,
+			"Directory where the routing tables computed for each "
+			"network are saved, and loaded from in later runs with "
+			"the same network topology. Networks with manual routes "
+			"are not cached.");
 }
 
 
@@ -208,6 +309,13 @@ void System::ProcessOptions()
 	if (stand_alone && config_file.empty())
 		throw Error(misc::fmt("Option --net-sim requires "
 				" --net-config option "));
+
+	// Sweep requires stand-alone simulation
+	if (!sweep_file.empty() && !stand_alone)
+		throw Error("Option --net-sweep requires --net-sim option");
+	if (burst_length < 1)
+		throw Error(misc::fmt("Invalid burst length (%g)",
+				burst_length));
 }
 
 
@@ -243,79 +351,294 @@ void System::TraceHeader()
 }
 
 
-void System::UniformTrafficSimulation(Network *network)
+int System::getTrafficDestination(TrafficPattern pattern, int source,
+		int num_end_nodes)
 {
-	// Initiate a list of double for injection time
-	auto inject_time = misc::new_unique_array<double>(network->getNumNodes());
+	int destination = source;
+	switch (pattern)
+	{
+
+	case TrafficUniform:
+
+		while (destination == source)
+			destination = random() % num_end_nodes;
+		break;
+
+	case TrafficTranspose:
+	{
+		// Swap row and column of the node in a square grid
+		int side = lround(sqrt(num_end_nodes));
+		if (side * side != num_end_nodes)
+			throw Error(misc::fmt("Traffic pattern 'transpose' "
+					"requires a square number of end nodes "
+					"(%d given)", num_end_nodes));
+		destination = source % side * side + source / side;
+		break;
+	}
+
+	case TrafficBitComplement:
+
+		// Equivalent to complementing the bits of the node index for
+		// a power-of-two number of end nodes
+		destination = num_end_nodes - 1 - source;
+		break;
+
+	case TrafficHotspot:
+
+		// End node 0 is the hotspot
+		if (RandomUniform() < hotspot_fraction)
+			destination = 0;
+		else
+			while (destination == source)
+				destination = random() % num_end_nodes;
+		break;
+
+	case TrafficNeighbor:
+
+		destination = (source + 1) % num_end_nodes;
+		break;
+
+	case TrafficTornado:
+
+		// Halfway around the nodes, minus one
+		destination = (source + std::max(1, (num_end_nodes + 1) / 2 - 1))
+				% num_end_nodes;
+		break;
+
+	default:
+
+		throw misc::Panic("Invalid traffic pattern");
+	}
+
+	// Nodes sending to themselves do not inject
+	return destination == source ? -1 : destination;
+}
+
+
+long long System::TrafficSimulation(Network *network, double injection_rate,
+		long long cycles)
+{
+	// Get end nodes
+	std::vector<EndNode *> end_nodes;
+	for (int i = 0; i < network->getNumNodes(); i++)
+	{
+		EndNode *node = dynamic_cast<EndNode *>(network->getNode(i));
+		if (node)
+			end_nodes.push_back(node);
+	}
+	int num_end_nodes = end_nodes.size();
+	if (num_end_nodes < 2)
+		throw Error(misc::fmt("%s: Network '%s' needs at least two end "
+				"nodes for stand-alone simulation",
+				config_file.c_str(),
+				network->getName().c_str()));
+
+	// Injection rate
+	if (injection_rate <= 0 || (injection_process != InjectionExponential
+			&& injection_rate >= 1))
+		throw Error(misc::fmt("Invalid injection rate (%g). Injection "
+				"processes other than 'exponential' need a rate "
+				"between 0 and 1.", injection_rate));
+
+	// Injection state of end nodes
+	long long start_cycle = getCycle();
+	std::vector<double> inject_time(num_end_nodes, start_cycle);
+	std::vector<bool> burst(num_end_nodes, false);
 
 	// Loop from the beginning to the end the simulation
+	long long num_messages = 0;
 	while (1)
 	{
 		// Get current cycle and check max cycles
-		esim::Engine *esim_engine = esim::Engine::getInstance();
-		long long cycle = System::getInstance()->getCycle();
-		if (cycle >= max_cycles)
+		long long cycle = getCycle();
+		if (cycle - start_cycle >= cycles)
 			break;
 
-		// Traverse all nodes to check if some nodes need injection
-		for (int i = 0; i < network->getNumNodes(); i++)
+		// Traverse all end nodes to check if they need injection
+		for (int i = 0; i < num_end_nodes; i++)
 		{
-			// Get end node
-			EndNode *node = dynamic_cast<EndNode *>(
-					network->getNode(i));
-			if (!node)
-				continue;
-
-			// Check turn for next injection
-			if (inject_time[i] > cycle)
-				continue;
-
-			// Get a random destination node
-			EndNode *destination_node = nullptr;
-			while (1)
+			// Number of messages injected in this cycle
+			int count = 0;
+			switch (injection_process)
 			{
-				int num_nodes = network->getNumNodes();
-				int index = random() % num_nodes;
-				destination_node = dynamic_cast<EndNode *>(
-						network->getNode(index));
-				if (destination_node && destination_node != 
-						node)
-					break;
+
+			case InjectionExponential:
+
+				// Random delays with exponential distribution
+				while (inject_time[i] < cycle)
+				{
+					inject_time[i] += RandomExponential(
+							injection_rate);
+					count++;
+				}
+				break;
+
+			case InjectionBernoulli:
+
+				count = RandomUniform() < injection_rate;
+				break;
+
+			case InjectionBursty:
+
+				// On/off source injecting one message per cycle
+				// while on. Off periods are as long as needed to
+				// obtain the average injection rate.
+				if (burst[i])
+					burst[i] = RandomUniform() >= 1.0 / burst_length;
+				else
+					burst[i] = RandomUniform() < injection_rate /
+							(burst_length * (1 - injection_rate));
+				count = burst[i];
+				break;
+
+			default:
+
+				throw misc::Panic("Invalid injection process");
 			}
 
-			// Inject
-			while (inject_time[i] < cycle)
+			// Send messages
+			for (; count; count--)
 			{
-				// Schedule next injection
-				inject_time[i] += RandomExponential(
-						injection_rate);
-
-				// Send the packet
-				if (network->CanSend(node, destination_node,
-					System::message_size))
-					network->Send(node, destination_node,
-							System::message_size);
+				int destination = getTrafficDestination(
+						(TrafficPattern) traffic_pattern,
+						i, num_end_nodes);
+				if (destination < 0)
+					continue;
+				num_messages++;
+				if (network->CanSend(end_nodes[i],
+						end_nodes[destination],
+						message_size))
+					network->Send(end_nodes[i],
+							end_nodes[destination],
+							message_size);
 			}
 		}
 
 		// Next cycle
-		debug << misc::fmt("___ cycle %lld ___\n", cycle);	
+		debug << misc::fmt("___ cycle %lld ___\n", cycle);
+		esim_engine->ProcessEvents();
+	}
+
+	// Return number of messages generated
+	return num_messages;
+}
+
+
+bool System::DrainSimulation(Network *network, long long max_cycles)
+{
+	long long start_cycle = getCycle();
+	while (network->getNumMessagesInFlight())
+	{
+		if (getCycle() - start_cycle >= max_cycles)
+			return false;
 		esim_engine->ProcessEvents();
 	}
+	return true;
 }
 
+
+long long System::getLatencyPercentile(const std::vector<long long> &histogram,
+		long long count, double p)
+{
+	long long target = (long long) ceil(count * p);
+	long long accumulated = 0;
+	for (unsigned latency = 0; latency < histogram.size(); latency++)
+	{
+		accumulated += histogram[latency];
+		if (accumulated >= target)
+			return latency;
+	}
+	return histogram.size();
+}
+
+
+void System::SweepSimulation(Network *network)
+{
+	// Open file
+	std::ofstream f(sweep_file);
+	if (!f)
+		throw Error(misc::fmt("%s: Cannot open sweep file",
+				sweep_file.c_str()));
+
+	// Header
+	f << "; Injection rate sweep for network '" << network->getName()
+			<< "'\n";
+	f << ";    InjectionRate - Messages per cycle and end node\n";
+	f << ";    OfferedThroughput, AcceptedThroughput - Messages "
+			"generated and received per cycle and end node\n";
+	f << ";    AverageLatency, LatencyP50, LatencyP95, LatencyP99 - "
+			"Latency of messages in cycles\n";
+	f << ";    Saturated - Accepted throughput below 90% of the offered "
+			"throughput, or network not drained\n";
+	f << "\n";
+
+	// Steps
+	int num_end_nodes = network->getNumEndNodes();
+	for (int step = 1; step <= sweep_steps; step++)
+	{
+		// Inject traffic and drain the network
+		double rate = injection_rate * step;
+		std::vector<long long> histogram = network->getLatencyHistogram();
+		long long transfers = network->getTransfers();
+		long long num_messages = TrafficSimulation(network, rate,
+				max_cycles);
+		long long accepted = network->getTransfers() - transfers;
+		bool drained = DrainSimulation(network, max_cycles);
+
+		// Latency distribution of messages received in this step
+		histogram.resize(network->getLatencyHistogram().size());
+		long long count = 0;
+		long long total_latency = 0;
+		for (unsigned i = 0; i < histogram.size(); i++)
+		{
+			histogram[i] = network->getLatencyHistogram()[i] -
+					histogram[i];
+			count += histogram[i];
+			total_latency += histogram[i] * i;
+		}
+
+		// Throughput
+		double offered = (double) num_messages /
+				(num_end_nodes * max_cycles);
+		double throughput = (double) accepted /
+				(num_end_nodes * max_cycles);
+		bool saturated = !drained || throughput < 0.9 * offered;
+
+		// Dump
+		f << misc::fmt("[ Step %d ]\n", step);
+		f << misc::fmt("InjectionRate = %.6f\n", rate);
+		f << misc::fmt("OfferedThroughput = %.6f\n", offered);
+		f << misc::fmt("AcceptedThroughput = %.6f\n", throughput);
+		f << misc::fmt("AverageLatency = %.2f\n", count ?
+				(double) total_latency / count : 0.0);
+		f << misc::fmt("LatencyP50 = %lld\n",
+				getLatencyPercentile(histogram, count, 0.5));
+		f << misc::fmt("LatencyP95 = %lld\n",
+				getLatencyPercentile(histogram, count, 0.95));
+		f << misc::fmt("LatencyP99 = %lld\n",
+				getLatencyPercentile(histogram, count, 0.99));
+		f << "Saturated = " << (saturated ? "True" : "False") << "\n";
+		f << "\n";
+
+		// Stop at saturation
+		if (saturated)
+			break;
+	}
+}
+
+
 void System::StandAlone()
 {
-	// Generate a uniform traffic pattern on the network.
-	// Later, this function can be easily extended (via a switch)
-	// to support other traffic patterns, hence the stand-alone
-	// function is not combined with the uniform traffic function.
+	// Synthetic traffic on the network, or a sweep of injection rates
 	Network *network = getNetworkByName(sim_net_name);
 	if (!network)
 		throw Error(misc::fmt("%s: The network does not exist for "
 				"stand-alone simulation\n",
 				config_file.c_str()));
-	UniformTrafficSimulation(network);
+	if (sweep_file.empty())
+		TrafficSimulation(network, injection_rate, max_cycles);
+	else
+		SweepSimulation(network);
 }
 
 
@@ -22,6 +22,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
 
 #include <lib/cpp/Debug.h>
 #include <lib/cpp/Error.h>
@@ -73,6 +74,9 @@ class System
 	// Static router file
 	static std::string route_file;
 
+	// Directory where computed routing tables are cached
+	static std::string route_cache_directory;
+
 	// Show help for network configuration file
 	static bool help;
 
@@ -91,6 +95,22 @@ class System
 	// Stand-alone simulator instantiator
 	static bool stand_alone;
 
+	// Traffic pattern and injection process for stand-alone simulation
+	static int traffic_pattern;
+	static int injection_process;
+
+	// Fraction of messages sent to the hotspot node with traffic pattern
+	// 'hotspot'
+	static double hotspot_fraction;
+
+	// Average length in cycles of bursts with injection process 'bursty'
+	static double burst_length;
+
+	// File for the results of an injection rate sweep, and maximum number
+	// of steps in the sweep
+	static std::string sweep_file;
+	static int sweep_steps;
+
 	// Unique instance of singleton
 	static std::unique_ptr<System> instance;
 
@@ -107,6 +127,16 @@ class System
 	// Get a exponential random valueclass Network;
 	static double RandomExponential(double lambda);
 
+	// Get a uniform random value between 0 and 1
+	static double RandomUniform() { return (double) random() / RAND_MAX; }
+
+	// Return the latency below which a fraction \a p of the messages in
+	// a latency histogram fall, given the total number of messages.
+	static long long getLatencyPercentile(
+			const std::vector<long long> &histogram,
+			long long count,
+			double p);
+
 
 
 
@@ -155,6 +185,46 @@ public:
 
 
 
+	//
+	// Synthetic traffic
+	//
+
+	/// Traffic patterns for stand-alone simulation. End nodes are
+	/// numbered in the order they appear in the network.
+	enum TrafficPattern
+	{
+		TrafficUniform = 0,
+		TrafficTranspose,
+		TrafficBitComplement,
+		TrafficHotspot,
+		TrafficNeighbor,
+		TrafficTornado
+	};
+
+	/// String map for TrafficPattern
+	static const misc::StringMap TrafficPatternMap;
+
+	/// Injection processes for stand-alone simulation
+	enum InjectionProcess
+	{
+		InjectionExponential = 0,
+		InjectionBernoulli,
+		InjectionBursty
+	};
+
+	/// String map for InjectionProcess
+	static const misc::StringMap InjectionProcessMap;
+
+	/// Return the destination end node for a message injected by end node
+	/// \a source, or -1 if the node does not inject messages with the
+	/// given traffic pattern. Pattern 'transpose' requires a square number
+	/// of end nodes.
+	static int getTrafficDestination(TrafficPattern pattern, int source,
+			int num_end_nodes);
+
+
+
+
 	//
 	// Event driven simulation event types
 	//
@@ -199,6 +269,21 @@ public:
 	/// by the user.
 	static int getMessageSize() { return message_size; }
 
+	/// Return the directory where computed routing tables are cached, as
+	/// given in option '--net-route-cache', or an empty string if routes
+	/// should not be cached.
+	static const std::string &getRouteCacheDirectory()
+	{
+		return route_cache_directory;
+	}
+
+	/// Set the directory where computed routing tables are cached, or an
+	/// empty string to disable the route cache.
+	static void setRouteCacheDirectory(const std::string &directory)
+	{
+		route_cache_directory = directory;
+	}
+
 
 
 
@@ -242,8 +327,25 @@ public:
 	// file passed with '--net-config' by the user.
 	void ReadConfiguration();
 
-	// Uniform traffic simulation
-	void UniformTrafficSimulation(Network *network);
+	/// Inject synthetic traffic into a network for \a cycles cycles,
+	/// following the traffic pattern and injection process selected by
+	/// the user. Messages that cannot be sent because the source buffer
+	/// is full are dropped.
+	///
+	/// \return
+	///	Number of messages generated, including dropped messages.
+	long long TrafficSimulation(Network *network, double injection_rate,
+			long long cycles);
+
+	/// Run the simulation without injecting traffic until all messages
+	/// in flight are received, for at most \a max_cycles cycles. Return
+	/// whether the network was drained.
+	bool DrainSimulation(Network *network, long long max_cycles);
+
+	/// Run synthetic traffic with an increasing injection rate until the
+	/// network saturates, dumping the latency and throughput for each
+	/// step into the file given in option '--net-sweep'.
+	void SweepSimulation(Network *network);
 
 	// Stand-Alone simulation
 	void StandAlone();
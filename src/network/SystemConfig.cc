@@ -70,6 +70,22 @@ const std::string System::help_message =
 		"      packetizing, with the fix_latency, regardless of\n"
 		"      the network topology. The ideal option still requires a\n"
 		"      network to connect the end-nodes to each other\n"
+		"  DefaultVC = <virtual channels> (Default = 1)\n"
+		"      Default number of virtual channels for links.\n"
+		"  Wormhole = <true/false> (Default = False)\n"
+		"      If set to true, the packets of a message hold the output\n"
+		"      buffers of switches from the arrival of its first packet\n"
+		"      until the arrival of its last packet, preventing packets\n"
+		"      of other messages from interleaving with them. Use it\n"
+		"      with 'DefaultPacketSize' to model flits.\n"
+		"  Analytic = <true/false> (Optional)\n"
+		"      If set to true, messages are not simulated through buffers\n"
+		"      and connections. Their latency is estimated from the\n"
+		"      number of hops in their route, the bandwidth of each\n"
+		"      link or bus, and the time each of them remains busy with\n"
+		"      earlier messages. This option is faster than the detailed\n"
+		"      model, and cannot be combined with 'Ideal' or\n"
+		"      'FixLatency'.\n"
 		"\n"
 		"Sections '[ Network.<network>.Node.<node> ]' are used to \n"
 		"define nodes in network '<network>'.\n"
@@ -102,8 +118,11 @@ const std::string System::help_message =
 		"      directions.\n"
 		"  Bandwidth = <bandwidth> (Default = <network>.DefaultBandwidth)\n"
 		"      Bandwidth of the link in bytes per cycle.\n"
-		"  VC = <virtual channels> (Default = 1)\n"
-		"       Number of virtual channels a link can have.\n"
+		"  VC = <virtual channels> (Default = <network>.DefaultVC)\n"
+		"       Number of virtual channels a link can have. Messages of\n"
+		"       different classes (e.g., requests, replies, and evictions\n"
+		"       in the memory hierarchy) use different virtual channels\n"
+		"       when the link has enough of them.\n"
 		"  InputBufferSize = <size> (Default = <network>.DefaultInputBufferSize)\n"
 		"	Size of the link's input buffer(s) in bytes.\n"
 		"  OutputBufferSize = <size> (Default = <network>/DefaultOutputBufferSize)\n"
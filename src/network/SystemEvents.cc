@@ -73,12 +73,37 @@ void System::EventTypeSendHandler(esim::Event *event,
 		return;
 	}
 
+	// For analytic networks, estimate the latency from the route and
+	// deliver the packet directly to its destination
+	if (network->isAnalytic())
+	{
+		long long latency = network->CalculateAnalyticLatency(
+				source_node,
+				destination_node,
+				packet->getSize());
+
+		// Debug Information
+		debug << misc::fmt("net: %s - M-%lld:%d - "
+				"analytic_lat=%lld\n",
+				network->getName().c_str(),
+				message->getId(),
+				packet->getId(),
+				latency);
+
+		// Update the network related statistics
+		source_node->incSentBytes(packet->getSize());
+		source_node->incSentPackets();
+		destination_node->incReceivedBytes(packet->getSize());
+		destination_node->incReceivedPackets();
+		packet->setNode(destination_node);
+		esim_engine->Next(event_receive, latency);
+		return;
+	}
+
 	// Lookup route from routing table
-	RoutingTable *routing_table = network->getRoutingTable();
-	RoutingTable::Entry *entry = routing_table->Lookup(
-			source_node,
-			destination_node);
-	Buffer *output_buffer = entry->getBuffer();
+	Buffer *output_buffer = network->getRouteBuffer(source_node,
+			destination_node,
+			message->getClass());
 	if (!output_buffer)
 		throw misc::Panic(misc::fmt("%s: no route from "
 				"%s to %s.",
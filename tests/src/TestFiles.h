@@ -0,0 +1,66 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TESTS_SRC_TESTFILES_H
+#define TESTS_SRC_TESTFILES_H
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+
+
+// Helpers shared by the unit tests that work with host files
+namespace test
+{
+
+// Create a temporary host file with the given content, and return its path.
+// The name of the file starts with '/tmp/m2s-<name>-'. The caller removes
+// the file with unlink().
+inline std::string CreateTempFile(const std::string &name,
+		const std::string &content)
+{
+	std::string path = "/tmp/m2s-" + name + "-XXXXXX";
+	int fd = mkstemp(&path[0]);
+	EXPECT_GE(fd, 0);
+	EXPECT_EQ((ssize_t) content.size(),
+			write(fd, content.c_str(), content.size()));
+	close(fd);
+	return path;
+}
+
+
+// Return the number of file descriptors open in this process
+inline int getNumOpenFiles()
+{
+	DIR *dir = opendir("/proc/self/fd");
+	if (!dir)
+		return -1;
+	int count = 0;
+	while (readdir(dir))
+		count++;
+	closedir(dir);
+	return count;
+}
+
+}  // namespace test
+
+#endif
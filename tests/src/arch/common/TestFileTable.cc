@@ -0,0 +1,142 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+#include <arch/common/FileTable.h>
+
+#include "TestFiles.h"
+
+
+namespace comm
+{
+
+TEST(TestFileTable, test_reopen_host_files_offset)
+{
+	std::string path = test::CreateTempFile("file-table", "0123456789");
+	int host_index = open(path.c_str(), O_RDWR);
+	ASSERT_GE(host_index, 0);
+	FileTable file_table;
+	file_table.newFileDescriptor(FileDescriptor::TypeRegular,
+			host_index, path, O_RDWR);
+
+	// Move the offset, and keep a descriptor sharing it, as a parent
+	// process would after fork()
+	char buffer[4] = {};
+	ASSERT_EQ(3, read(host_index, buffer, 3));
+	int shared_index = dup(host_index);
+	ASSERT_GE(shared_index, 0);
+
+	// The host file is replaced in place, keeping its offset
+	file_table.ReopenHostFiles();
+	EXPECT_EQ(3, lseek(host_index, 0, SEEK_CUR));
+	ASSERT_EQ(2, read(host_index, buffer, 2));
+	EXPECT_EQ('3', buffer[0]);
+	EXPECT_EQ('4', buffer[1]);
+
+	// The offset is no longer shared
+	EXPECT_EQ(3, lseek(shared_index, 0, SEEK_CUR));
+	EXPECT_EQ(5, lseek(host_index, 0, SEEK_CUR));
+
+	close(shared_index);
+	close(host_index);
+	unlink(path.c_str());
+}
+
+
+TEST(TestFileTable, test_reopen_host_files_flags)
+{
+	// A file created and truncated by the guest is not truncated again
+	std::string path = test::CreateTempFile("file-table", "");
+	int host_index = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC |
+			O_APPEND, 0600);
+	ASSERT_GE(host_index, 0);
+	FileTable file_table;
+	file_table.newFileDescriptor(FileDescriptor::TypeRegular,
+			host_index, path, O_WRONLY | O_CREAT | O_TRUNC |
+			O_APPEND);
+	ASSERT_EQ(5, write(host_index, "01234", 5));
+	file_table.ReopenHostFiles();
+
+	// Remaining flags are kept
+	int flags = fcntl(host_index, F_GETFL);
+	EXPECT_EQ(O_WRONLY, flags & O_ACCMODE);
+	EXPECT_TRUE(flags & O_APPEND);
+	ASSERT_EQ(3, write(host_index, "567", 3));
+	close(host_index);
+
+	// Check file content
+	char buffer[16] = {};
+	int fd = open(path.c_str(), O_RDONLY);
+	ASSERT_GE(fd, 0);
+	EXPECT_EQ(8, read(fd, buffer, sizeof buffer));
+	EXPECT_EQ("01234567", std::string(buffer));
+	close(fd);
+	unlink(path.c_str());
+}
+
+
+TEST(TestFileTable, test_reopen_host_files_other_types)
+{
+	// Pipes are not reopened. Replacing the host descriptor would clear
+	// its close-on-exec flag.
+	int pipe_fds[2];
+	ASSERT_EQ(0, pipe(pipe_fds));
+	ASSERT_EQ(0, fcntl(pipe_fds[0], F_SETFD, FD_CLOEXEC));
+	FileTable file_table;
+	file_table.newFileDescriptor(FileDescriptor::TypePipe,
+			pipe_fds[0], "", O_RDONLY);
+	file_table.ReopenHostFiles();
+	EXPECT_EQ(FD_CLOEXEC, fcntl(pipe_fds[0], F_GETFD));
+
+	// Standard descriptors are untouched
+	for (int i = 0; i < 3; i++)
+		EXPECT_EQ(FileDescriptor::TypeStandard,
+				file_table.getFileDescriptor(i)->getType());
+
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+}
+
+
+TEST(TestFileTable, test_reopen_host_files_missing)
+{
+	// A file that can no longer be opened keeps its host descriptor
+	std::string path = test::CreateTempFile("file-table", "0123456789");
+	int host_index = open(path.c_str(), O_RDONLY);
+	ASSERT_GE(host_index, 0);
+	FileTable file_table;
+	file_table.newFileDescriptor(FileDescriptor::TypeRegular,
+			host_index, path, O_RDONLY);
+	unlink(path.c_str());
+	file_table.ReopenHostFiles();
+
+	char buffer[4] = {};
+	ASSERT_EQ(3, read(host_index, buffer, 3));
+	EXPECT_EQ("012", std::string(buffer));
+	close(host_index);
+}
+
+
+}  // namespace comm
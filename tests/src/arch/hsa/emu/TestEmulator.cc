@@ -0,0 +1,102 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <arch/hsa/emulator/Emulator.h>
+#include <arch/hsa/emulator/HsaInstructionWorker.h>
+#include <lib/cpp/Error.h>
+#include <memory/Memory.h>
+
+
+namespace HSA
+{
+
+// Workers are only bound to work items and stack frames by address
+static WorkItem *const work_item_a = reinterpret_cast<WorkItem *>(0x10);
+static WorkItem *const work_item_b = reinterpret_cast<WorkItem *>(0x20);
+static StackFrame *const stack_frame_a = reinterpret_cast<StackFrame *>(0x30);
+static StackFrame *const stack_frame_b = reinterpret_cast<StackFrame *>(0x40);
+
+TEST(TestEmulator, instruction_worker_sharing)
+{
+	Emulator *emulator = Emulator::getInstance();
+
+	// One worker per opcode, created on first use
+	HsaInstructionWorker *add = emulator->getInstructionWorker(
+			BRIG_OPCODE_ADD);
+	ASSERT_TRUE(add != nullptr);
+	EXPECT_EQ(nullptr, add->getWorkItem());
+	EXPECT_EQ(add, emulator->getInstructionWorker(BRIG_OPCODE_ADD));
+	HsaInstructionWorker *mov = emulator->getInstructionWorker(
+			BRIG_OPCODE_MOV);
+	ASSERT_TRUE(mov != nullptr);
+	EXPECT_NE(add, mov);
+
+	// The shared worker acts on the last work item it was bound to
+	add->Bind(work_item_a, stack_frame_a);
+	EXPECT_EQ(work_item_a, add->getWorkItem());
+	EXPECT_EQ(stack_frame_a, add->getStackFrame());
+	add->Bind(work_item_b, stack_frame_b);
+	EXPECT_EQ(add, emulator->getInstructionWorker(BRIG_OPCODE_ADD));
+	EXPECT_EQ(work_item_b, add->getWorkItem());
+	EXPECT_EQ(stack_frame_b, add->getStackFrame());
+	EXPECT_EQ(nullptr, mov->getWorkItem());
+}
+
+TEST(TestEmulator, instruction_worker_unsupported)
+{
+	Emulator *emulator = Emulator::getInstance();
+
+	// Opcodes with no worker fail every time they are requested
+	EXPECT_THROW(emulator->getInstructionWorker(BRIG_OPCODE_NOP),
+			misc::Panic);
+	EXPECT_THROW(emulator->getInstructionWorker(BRIG_OPCODE_NOP),
+			misc::Panic);
+
+	// Vendor extension opcodes
+	EXPECT_THROW(emulator->getInstructionWorker((BrigOpcode)
+			(BRIG_OPCODE_WAVEID + 1)), misc::Panic);
+	EXPECT_THROW(emulator->getInstructionWorker((BrigOpcode) 0x8000),
+			misc::Panic);
+}
+
+TEST(TestEmulator, instruction_worker_memory_change)
+{
+	Emulator *emulator = Emulator::getInstance();
+	mem::Memory *old_memory = emulator->getMemory();
+
+	// Changing the memory discards workers, since some of them keep a
+	// reference to it
+	mem::Memory memory;
+	emulator->setMemory(&memory);
+	HsaInstructionWorker *add = emulator->getInstructionWorker(
+			BRIG_OPCODE_ADD);
+	add->Bind(work_item_a, stack_frame_a);
+	mem::Memory other_memory;
+	emulator->setMemory(&other_memory);
+	add = emulator->getInstructionWorker(BRIG_OPCODE_ADD);
+	EXPECT_EQ(nullptr, add->getWorkItem());
+	EXPECT_EQ(add, emulator->getInstructionWorker(BRIG_OPCODE_ADD));
+
+	// Restore memory
+	emulator->setMemory(old_memory);
+}
+
+}  // namespace HSA
@@ -0,0 +1,159 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <arch/hsa/emulator/Function.h>
+#include <arch/hsa/emulator/StackFrame.h>
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+
+
+namespace HSA
+{
+
+// Return a function with 2 control, 3 single, 2 double, and 1 quad registers
+static std::unique_ptr<Function> NewFunction()
+{
+	auto function = misc::new_unique<Function>("test");
+	unsigned int max_register[4] = { 2, 3, 2, 1 };
+	function->AllocateRegister(max_register);
+	return function;
+}
+
+TEST(TestStackFrame, register_layout)
+{
+	// Wider registers come first, and control registers take one byte
+	auto function = NewFunction();
+	EXPECT_EQ(16u + 2 * 8 + 3 * 4 + 2, function->getRegisterSize());
+	EXPECT_EQ(0u, function->getRegisterSlot(BRIG_REGISTER_KIND_QUAD, 0)
+			.offset);
+	EXPECT_EQ(16u, function->getRegisterSlot(BRIG_REGISTER_KIND_DOUBLE, 0)
+			.offset);
+	EXPECT_EQ(24u, function->getRegisterSlot(BRIG_REGISTER_KIND_DOUBLE, 1)
+			.offset);
+	EXPECT_EQ(32u, function->getRegisterSlot(BRIG_REGISTER_KIND_SINGLE, 0)
+			.offset);
+	EXPECT_EQ(40u, function->getRegisterSlot(BRIG_REGISTER_KIND_SINGLE, 2)
+			.offset);
+	EXPECT_EQ(44u, function->getRegisterSlot(BRIG_REGISTER_KIND_CONTROL, 0)
+			.offset);
+	EXPECT_EQ(45u, function->getRegisterSlot(BRIG_REGISTER_KIND_CONTROL, 1)
+			.offset);
+
+	// All registers are naturally aligned
+	for (int kind = BRIG_REGISTER_KIND_CONTROL;
+			kind <= BRIG_REGISTER_KIND_QUAD; kind++)
+	{
+		BrigRegisterKind register_kind = (BrigRegisterKind) kind;
+		unsigned int size = Function::getRegisterKindSize(
+				register_kind);
+		for (unsigned int i = 0; i < function->getRegisterCount(
+				register_kind); i++)
+		{
+			Function::RegisterSlot slot = function->getRegisterSlot(
+					register_kind, i);
+			EXPECT_EQ(size, slot.size);
+			EXPECT_EQ(0u, slot.offset % size);
+		}
+	}
+}
+
+TEST(TestStackFrame, register_names)
+{
+	// Name lookups resolve to the same slot as kind and number
+	auto function = NewFunction();
+	EXPECT_EQ(function->getRegisterSlot(BRIG_REGISTER_KIND_SINGLE, 2)
+			.offset, function->getRegisterOffset("$s2"));
+	EXPECT_EQ(function->getRegisterSlot(BRIG_REGISTER_KIND_DOUBLE, 1)
+			.offset, function->getRegisterOffset("$d1"));
+	EXPECT_EQ(function->getRegisterSlot(BRIG_REGISTER_KIND_QUAD, 0)
+			.offset, function->getRegisterOffset("$q0"));
+	EXPECT_EQ(function->getRegisterSlot(BRIG_REGISTER_KIND_CONTROL, 1)
+			.offset, function->getRegisterOffset("$c1"));
+
+	// Registers out of the allocated range, or with an invalid name
+	EXPECT_THROW(function->getRegisterSlot(BRIG_REGISTER_KIND_SINGLE, 3),
+			misc::Panic);
+	EXPECT_THROW(function->getRegisterSlot("$q1"), misc::Panic);
+	EXPECT_THROW(function->getRegisterSlot("$x0"), misc::Panic);
+	EXPECT_THROW(function->getRegisterSlot("$s"), misc::Panic);
+
+	// A function with no registers of a kind has no slot for it
+	auto empty = misc::new_unique<Function>("empty");
+	unsigned int max_register[4] = { 0, 0, 0, 0 };
+	empty->AllocateRegister(max_register);
+	EXPECT_EQ(0u, empty->getRegisterSize());
+	EXPECT_THROW(empty->getRegisterSlot(BRIG_REGISTER_KIND_SINGLE, 0),
+			misc::Panic);
+}
+
+TEST(TestStackFrame, register_values)
+{
+	auto function = NewFunction();
+	StackFrame frame(function.get(), nullptr, nullptr);
+
+	// Write every register with a distinct pattern
+	for (int kind = BRIG_REGISTER_KIND_CONTROL;
+			kind <= BRIG_REGISTER_KIND_QUAD; kind++)
+	{
+		BrigRegisterKind register_kind = (BrigRegisterKind) kind;
+		for (unsigned int i = 0; i < function->getRegisterCount(
+				register_kind); i++)
+		{
+			char value[16];
+			memset(value, kind * 16 + i + 1, sizeof value);
+			frame.setRegisterValue(register_kind, i, value);
+		}
+	}
+
+	// Registers do not overlap
+	for (int kind = BRIG_REGISTER_KIND_CONTROL;
+			kind <= BRIG_REGISTER_KIND_QUAD; kind++)
+	{
+		BrigRegisterKind register_kind = (BrigRegisterKind) kind;
+		unsigned int size = Function::getRegisterKindSize(
+				register_kind);
+		for (unsigned int i = 0; i < function->getRegisterCount(
+				register_kind); i++)
+		{
+			char expected[16];
+			char value[16];
+			memset(expected, kind * 16 + i + 1, sizeof expected);
+			frame.getRegisterValue(register_kind, i, value);
+			EXPECT_EQ(0, memcmp(expected, value, size));
+		}
+	}
+
+	// Accesses by name and by kind and number reach the same storage
+	unsigned int single = 0x12345678;
+	frame.setRegisterValue("$s1", &single);
+	unsigned int result = 0;
+	frame.getRegisterValue(BRIG_REGISTER_KIND_SINGLE, 1, &result);
+	EXPECT_EQ(single, result);
+	unsigned long long value = 0x0102030405060708ull;
+	frame.setRegisterValue(BRIG_REGISTER_KIND_DOUBLE, 0, &value);
+	unsigned long long double_result = 0;
+	frame.getRegisterValue("$d0", &double_result);
+	EXPECT_EQ(value, double_result);
+}
+
+}  // namespace HSA
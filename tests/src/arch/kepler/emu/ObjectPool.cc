@@ -0,0 +1,116 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <elf.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "ObjectPool.h"
+#include "TestFiles.h"
+
+namespace Kepler
+{
+
+// Build a 32-bit ELF file with sections '.text.kernel', containing the given
+// instruction words, and '.nv.info.kernel', describing a kernel with no
+// arguments
+static std::string BuildCubin(const std::vector<unsigned long long> &code)
+{
+	const char shstrtab[] = "\0.shstrtab\0.text.kernel\0.nv.info.kernel";
+	const unsigned info_size = 12;
+	const unsigned text_size = code.size() * sizeof(unsigned long long);
+	const unsigned shstrtab_offset = sizeof(Elf32_Ehdr);
+	const unsigned text_offset = (shstrtab_offset + sizeof shstrtab + 7)
+			& ~7;
+	const unsigned info_offset = text_offset + text_size;
+	const unsigned shoff = (info_offset + info_size + 3) & ~3;
+	const int num_sections = 4;
+	std::string content(shoff + num_sections * sizeof(Elf32_Shdr), '\0');
+	char *buffer = &content[0];
+
+	// Header
+	Elf32_Ehdr *ehdr = (Elf32_Ehdr *) buffer;
+	memcpy(ehdr->e_ident, ELFMAG, SELFMAG);
+	ehdr->e_ident[EI_CLASS] = ELFCLASS32;
+	ehdr->e_ident[EI_DATA] = ELFDATA2LSB;
+	ehdr->e_ident[EI_VERSION] = EV_CURRENT;
+	ehdr->e_type = ET_EXEC;
+	ehdr->e_shoff = shoff;
+	ehdr->e_ehsize = sizeof(Elf32_Ehdr);
+	ehdr->e_shentsize = sizeof(Elf32_Shdr);
+	ehdr->e_shnum = num_sections;
+	ehdr->e_shstrndx = 1;
+
+	// Section content
+	memcpy(buffer + shstrtab_offset, shstrtab, sizeof shstrtab);
+	memcpy(buffer + text_offset, code.data(), text_size);
+
+	// Section headers
+	Elf32_Shdr *shdr = (Elf32_Shdr *) (buffer + shoff);
+	shdr[1].sh_name = 1;
+	shdr[1].sh_type = SHT_STRTAB;
+	shdr[1].sh_offset = shstrtab_offset;
+	shdr[1].sh_size = sizeof shstrtab;
+	shdr[2].sh_name = 11;
+	shdr[2].sh_type = SHT_PROGBITS;
+	shdr[2].sh_offset = text_offset;
+	shdr[2].sh_size = text_size;
+	shdr[3].sh_name = 24;
+	shdr[3].sh_type = SHT_PROGBITS;
+	shdr[3].sh_offset = info_offset;
+	shdr[3].sh_size = info_size;
+	return content;
+}
+
+
+ObjectPool::ObjectPool(const std::vector<unsigned long long> &code,
+		unsigned thread_block_size)
+{
+	// Write cubin file
+	path = test::CreateTempFile("test-cubin", BuildCubin(code));
+
+	// Load kernel
+	module.reset(new Module(0, path));
+	Function *function = module->addFunction(module.get(), "kernel");
+
+	// Grid with two thread blocks
+	grid.reset(new Grid(function));
+	unsigned thread_block_count[3] = { 2, 1, 1 };
+	unsigned thread_block_size3[3] = { thread_block_size, 1, 1 };
+	grid->SetupSize(thread_block_count, thread_block_size3);
+}
+
+
+ObjectPool::~ObjectPool()
+{
+	unlink(path.c_str());
+}
+
+
+std::unique_ptr<ThreadBlock> ObjectPool::newThreadBlock(int id)
+{
+	unsigned id_3d[3] = { (unsigned) id, 0, 0 };
+	return std::unique_ptr<ThreadBlock>(new ThreadBlock(grid.get(), id,
+			id_3d));
+}
+
+
+} // namespace Kepler
@@ -0,0 +1,75 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SRC_ARCH_KEPLER_EMU_OBJECTPOOL_H
+#define SRC_ARCH_KEPLER_EMU_OBJECTPOOL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arch/kepler/driver/Function.h>
+#include <arch/kepler/driver/Module.h>
+#include <arch/kepler/emulator/Grid.h>
+#include <arch/kepler/emulator/ThreadBlock.h>
+
+namespace Kepler
+{
+
+// ObjectPool holds a grid running a kernel given as a sequence of 64-bit
+// instruction words, loaded from a minimal cubin file, so that thread blocks
+// can be created for testing
+class ObjectPool
+{
+	// Path of the temporary cubin file
+	std::string path;
+
+	// Module loaded from the cubin file
+	std::unique_ptr<Module> module;
+
+	// Grid
+	std::unique_ptr<Grid> grid;
+
+public:
+
+	/// Constructor
+	///
+	/// \param code
+	///	Instruction words of the kernel. Word 0, and every 8th word
+	///	after it, holds scheduling information and is not executed.
+	///
+	/// \param thread_block_size
+	///	Number of threads in each thread block
+	ObjectPool(const std::vector<unsigned long long> &code,
+			unsigned thread_block_size);
+
+	/// Destructor
+	~ObjectPool();
+
+	/// Return the grid
+	Grid *getGrid() { return grid.get(); }
+
+	/// Create a thread block of the grid with the given identifier
+	std::unique_ptr<ThreadBlock> newThreadBlock(int id);
+};
+
+
+} // namespace Kepler
+
+#endif
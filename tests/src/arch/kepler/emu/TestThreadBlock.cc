@@ -0,0 +1,126 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <arch/kepler/emulator/Emulator.h>
+#include <arch/kepler/emulator/Thread.h>
+#include <arch/kepler/emulator/ThreadBlock.h>
+#include <memory/Memory.h>
+
+#include "ObjectPool.h"
+
+namespace Kepler
+{
+
+// Kernel made of NOP instructions
+static const std::vector<unsigned long long> nop_kernel(16,
+		0x8580000000000002ull);
+
+// Size of the local memory of each thread
+static const unsigned local_memory_size = 1 << 20;
+
+// Return the generic address of the local memory of a thread, as provided to
+// the kernel in c[0x0][0x24]
+static unsigned getLocalMemoryBase(Thread *thread)
+{
+	unsigned base;
+	thread->ReadConstantMemory(0x24, 4, (char *) &base);
+	return base;
+}
+
+TEST(TestThreadBlock, local_memory_pool)
+{
+	Emulator *emulator = Emulator::getInstance();
+	ObjectPool pool(nop_kernel, 32);
+	int num_free = emulator->getNumFreeLocalMemories();
+
+	// A thread block that never accesses local memory does not take one
+	auto thread_block = pool.newThreadBlock(0);
+	thread_block.reset();
+	EXPECT_EQ(num_free, emulator->getNumFreeLocalMemories());
+
+	// The local memory is allocated on first access, and returned to the
+	// pool when the thread block is destroyed
+	thread_block = pool.newThreadBlock(0);
+	mem::Memory *local_memory = thread_block->getLocalMemory();
+	EXPECT_EQ(local_memory, thread_block->getLocalMemory());
+	unsigned value = 0x1234;
+	local_memory->Write(0x100, 4, (const char *) &value);
+	thread_block.reset();
+	EXPECT_EQ(num_free + 1, emulator->getNumFreeLocalMemories());
+
+	// The next thread block reuses it, with its content cleared
+	thread_block = pool.newThreadBlock(1);
+	EXPECT_EQ(local_memory, thread_block->getLocalMemory());
+	EXPECT_EQ(num_free, emulator->getNumFreeLocalMemories());
+	local_memory->Read(0x100, 4, (char *) &value);
+	EXPECT_EQ(0u, value);
+
+	// Thread blocks alive at the same time get different memories
+	auto other_thread_block = pool.newThreadBlock(0);
+	EXPECT_NE(local_memory, other_thread_block->getLocalMemory());
+	thread_block.reset();
+	other_thread_block.reset();
+	EXPECT_EQ(num_free + 2, emulator->getNumFreeLocalMemories());
+}
+
+TEST(TestThreadBlock, local_memory_regions)
+{
+	// Two warps
+	ObjectPool pool(nop_kernel, 64);
+	auto thread_block = pool.newThreadBlock(0);
+
+	// Each thread writes its identifier at the same offset of its local
+	// memory, whose generic address is the one reported to the kernel
+	for (int i = 0; i < thread_block->getThreadsCount(); i++)
+	{
+		Thread *thread = thread_block->getThread(i);
+		unsigned base = getLocalMemoryBase(thread);
+		EXPECT_EQ(getLocalMemoryBase(thread_block->getThread(0)) +
+				i * local_memory_size, base);
+		unsigned value = i + 1;
+		thread->WriteLocalMemory(base + 16, 4, (char *) &value);
+	}
+
+	// Threads own consecutive regions of the thread block local memory
+	for (int i = 0; i < thread_block->getThreadsCount(); i++)
+	{
+		Thread *thread = thread_block->getThread(i);
+		unsigned value = 0;
+		thread->ReadLocalMemory(getLocalMemoryBase(thread) + 16, 4,
+				(char *) &value);
+		EXPECT_EQ((unsigned) i + 1, value);
+		thread_block->getLocalMemory()->Read(i * local_memory_size + 16,
+				4, (char *) &value);
+		EXPECT_EQ((unsigned) i + 1, value);
+	}
+
+	// Threads of another thread block see the same generic addresses, but
+	// a different local memory
+	auto other_thread_block = pool.newThreadBlock(1);
+	Thread *thread = other_thread_block->getThread(3);
+	unsigned base = getLocalMemoryBase(thread);
+	EXPECT_EQ(getLocalMemoryBase(thread_block->getThread(3)), base);
+	unsigned value = 0;
+	thread->ReadLocalMemory(base + 16, 4, (char *) &value);
+	EXPECT_EQ(0u, value);
+}
+
+} // namespace Kepler
@@ -0,0 +1,641 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <cfloat>
+
+#include <arch/kepler/disassembler/Instruction.h>
+#include <arch/kepler/emulator/Emulator.h>
+#include <arch/kepler/emulator/Register.h>
+#include <arch/kepler/emulator/SyncStack.h>
+#include <arch/kepler/emulator/Thread.h>
+#include <arch/kepler/emulator/ThreadBlock.h>
+#include <arch/kepler/emulator/Warp.h>
+
+#include "ObjectPool.h"
+
+namespace Kepler
+{
+
+// Encodings of the instructions with all fields other than the opcode cleared
+static const unsigned long long nop = 0x8580000000000002ull;
+static const unsigned long long mov_b = 0x64c0000000000002ull;
+static const unsigned long long mov32i = 0x7400000000000002ull;
+static const unsigned long long iadd32i = 0x4000000000000001ull;
+static const unsigned long long psetp = 0x8480000000000002ull;
+static const unsigned long long imad = 0x5000000000000002ull;
+static const unsigned long long iadd_a = 0xc080000000000001ull;
+static const unsigned long long iadd_b_constant = 0x6080000000000002ull;
+static const unsigned long long iadd_b_register = 0xe080000000000002ull;
+static const unsigned long long isetp_a = 0x5b00000000000002ull;
+static const unsigned long long isetp_b = 0xb300000000000001ull;
+static const unsigned long long fmul = 0x6340000000000002ull;
+static const unsigned long long fadd_b_constant = 0x62c0000000000002ull;
+static const unsigned long long fadd_b_register = 0xe2c0000000000002ull;
+static const unsigned long long ffma_b = 0x0c00000000000002ull;
+
+// Constant memory entries holding an integer and a float
+static const unsigned constant_int = 0x30;
+static const unsigned constant_float = 0x34;
+
+// Predicate PT, always true, and the offset negating a predicate
+static const unsigned pt = 7;
+static const unsigned neg = 8;
+
+static unsigned long long EncodeMOV_B(unsigned pred, unsigned dst,
+		unsigned src, bool register_source)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = mov_b;
+	bytes.general0.pred = pred;
+	bytes.general0.dst = dst;
+	bytes.general0.srcB = src;
+	bytes.general0.srcB_mod = register_source;
+	return bytes.as_dword;
+}
+
+static unsigned long long EncodeMOV32I(unsigned pred, unsigned dst,
+		unsigned imm32)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = mov32i;
+	bytes.immediate.pred = pred;
+	bytes.immediate.dst = dst;
+	bytes.immediate.imm32 = imm32;
+	return bytes.as_dword;
+}
+
+static unsigned long long EncodeIADD32I(unsigned pred, unsigned dst,
+		unsigned src, unsigned imm32, unsigned po, unsigned x)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = iadd32i;
+	bytes.iadd32i.pred = pred;
+	bytes.iadd32i.dst = dst;
+	bytes.iadd32i.src = src;
+	bytes.iadd32i.imm32 = imm32;
+	bytes.iadd32i.po = po;
+	bytes.iadd32i.x = x;
+	return bytes.as_dword;
+}
+
+// Encode 'dst = (srcA bool_op0 srcB) bool_op1 srcC'
+static unsigned long long EncodePSETP(unsigned pred, unsigned dst,
+		unsigned srcA, unsigned bool_op0, unsigned srcB,
+		unsigned bool_op1, unsigned srcC)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = psetp;
+	bytes.psetp.pred = pred;
+	bytes.psetp.pred0 = dst;
+	bytes.psetp.pred1 = pt;
+	bytes.psetp.pred2 = srcA;
+	bytes.psetp.bool_op0 = bool_op0;
+	bytes.psetp.pred3 = srcB;
+	bytes.psetp.bool_op1 = bool_op1;
+	bytes.psetp.pred4 = srcC;
+	return bytes.as_dword;
+}
+
+// Encode an instruction with the general format, where 'srcA' is given in
+// field 'mod0', and 'srcB' is a register or a constant memory entry
+static unsigned long long EncodeGeneral0(unsigned long long opcode,
+		unsigned pred, unsigned dst, unsigned srcA, unsigned srcB,
+		unsigned mod1, bool register_source)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = opcode;
+	bytes.general0.pred = pred;
+	bytes.general0.dst = dst;
+	bytes.general0.mod0 = srcA;
+	bytes.general0.srcB = srcB;
+	bytes.general0.mod1 = mod1;
+	bytes.general0.srcB_mod = register_source;
+	return bytes.as_dword;
+}
+
+// Encode 'dst1 = (srcA cmp_op srcB) bool_op srcC' and
+// 'dst2 = !(srcA cmp_op srcB) bool_op srcC', subtracting the carry flag from
+// 'srcA' if 'x' is set
+static unsigned long long EncodeISETP(unsigned long long opcode,
+		unsigned pred, unsigned dst1, unsigned dst2, unsigned srcA,
+		unsigned srcB, unsigned cmp_op, unsigned bool_op, unsigned srcC,
+		unsigned x, bool register_source)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = EncodeGeneral0(opcode, pred, dst1 << 3 | dst2, srcA,
+			srcB, (cmp_op & 3) << 10 | bool_op << 6 | x << 4 |
+			srcC, register_source);
+	bytes.general0.op1 |= cmp_op >> 2;
+	return bytes.as_dword;
+}
+
+static unsigned long long EncodeIADD(unsigned long long opcode,
+		unsigned pred, unsigned dst, unsigned src1, unsigned src2,
+		unsigned po, unsigned x, unsigned cc)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = opcode;
+	bytes.iadd.pred = pred;
+	bytes.iadd.dst = dst;
+	bytes.iadd.src1 = src1;
+	bytes.iadd.src2 = src2;
+	bytes.iadd.po = po;
+	bytes.iadd.x = x;
+	bytes.iadd.cc = cc;
+	return bytes.as_dword;
+}
+
+// Encode 'dst = src1 + src2' with the absolute value and negation modifiers
+// of each operand given as the bits of 'src1_mod' and 'src2_mod'
+static unsigned long long EncodeFADD(unsigned long long opcode,
+		unsigned pred, unsigned dst, unsigned src1, unsigned src2,
+		unsigned src1_mod, unsigned src2_mod, unsigned ftz)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = opcode;
+	bytes.fadd.pred = pred;
+	bytes.fadd.dst = dst;
+	bytes.fadd.src1 = src1;
+	bytes.fadd.src2 = src2;
+	bytes.fadd.src1_abs = src1_mod & 1;
+	bytes.fadd.src1_negate = src1_mod >> 1;
+	bytes.fadd.src2_abs = src2_mod & 1;
+	bytes.fadd.src2_negate = src2_mod >> 1;
+	bytes.fadd.ftz = ftz;
+	return bytes.as_dword;
+}
+
+// Encode 'dst = src1 * src2 + src3', where the operand form 'op2' selects
+// which of 'src2' and 'src3' are constant memory entries
+static unsigned long long EncodeFFMA(unsigned pred, unsigned dst,
+		unsigned src1, unsigned src2, unsigned src3, unsigned op2,
+		unsigned negate_ab, unsigned negate_c)
+{
+	Instruction::Bytes bytes;
+	bytes.as_dword = ffma_b;
+	bytes.ffma.pred = pred;
+	bytes.ffma.dst = dst;
+	bytes.ffma.src1 = src1;
+	bytes.ffma.src2 = src2;
+	bytes.ffma.src3 = src3;
+	bytes.ffma.op2 = op2;
+	bytes.ffma.negate_ab = negate_ab;
+	bytes.ffma.negate_c = negate_c;
+	return bytes.as_dword;
+}
+
+// Kernel with the instructions under test. Words 0, 8, 16, 24, and 32 hold
+// scheduling information.
+static std::vector<unsigned long long> BuildKernel()
+{
+	std::vector<unsigned long long> code(40, nop);
+
+	// Moves
+	code[1] = EncodeMOV32I(0, 3, 0xdeadbeef);
+	code[2] = EncodeMOV_B(1 + neg, 4, 5, true);
+	code[3] = EncodeMOV_B(pt, 6, 0x24 >> 2, false);
+
+	// Additions, plain, with carry in, and with each .PO form
+	code[4] = EncodeIADD32I(2, 7, 2, 0xfffffff0, 0, 0);
+	code[5] = EncodeIADD32I(pt, 8, 2, 0x7ffffff8, 0, 1);
+	code[6] = EncodeIADD32I(pt, 9, 2, 0x10, 1, 0);
+	code[7] = EncodeIADD32I(3 + neg, 10, 2, 0x10, 2, 0);
+	code[9] = EncodeIADD32I(pt, 11, 2, 0x10, 3, 0);
+
+	// Predicates, with boolean operations and (0), or (1), and xor (3)
+	code[10] = EncodePSETP(3, 4, 0, 0, 1 + neg, 1, 2);
+	code[11] = EncodePSETP(pt, 5, 1, 1, 2, 3, 0 + neg);
+	code[12] = EncodePSETP(pt, 6, 0, 3, 1, 0, 3);
+
+	// Integer multiply-add, with a constant and a register operand
+	code[13] = EncodeGeneral0(imad, pt, 12, 0, constant_int >> 2, 1,
+			false);
+	code[14] = EncodeGeneral0(imad, 1, 13, 2, 3, 4, true);
+
+	// Integer additions with a negative immediate, a register, and a
+	// constant, updating condition codes or not
+	code[15] = EncodeIADD(iadd_a | 1ull << 59, pt, 14, 2, 0x7fffb, 0, 0,
+			1);
+	code[17] = EncodeIADD(iadd_a, 2 + neg, 15, 0, 0x1234, 0, 0, 0);
+	code[18] = EncodeIADD(iadd_b_register, pt, 5, 2, 3, 0, 0, 0);
+	code[19] = EncodeIADD(iadd_b_constant, pt, 6, 2, constant_int >> 2,
+			0, 1, 0);
+
+	// Integer comparisons with a constant, with a register and carry, and
+	// with an immediate
+	code[20] = EncodeISETP(isetp_a, pt, 0, 1, 2, constant_int >> 2, 1,
+			0, pt, 0, false);
+	code[21] = EncodeISETP(isetp_a, pt, 2, pt, 2, 2, 6, 1, 3 + neg, 1,
+			true);
+	code[22] = EncodeISETP(isetp_b, 3, 4, 5, 2, 20, 4, 0, 6, 0, true);
+
+	// Floating-point multiplications, with |R18| * -R17, and with a
+	// constant
+	code[25] = EncodeGeneral0(fmul, pt, 16, 18, 17, 1 << 3 | 1 << 4,
+			true);
+	code[26] = EncodeGeneral0(fmul, 0, 20, 16, constant_float >> 2, 0,
+			false);
+
+	// Floating-point additions, with R16 + -|R18|, flushing denormals in
+	// each operand, and with a constant
+	code[27] = EncodeFADD(fadd_b_register, pt, 21, 16, 18, 0, 3, 0);
+	code[28] = EncodeFADD(fadd_b_register, pt, 22, 23, 19, 0, 0, 1);
+	code[34] = EncodeFADD(fadd_b_register, pt, 19, 19, 23, 0, 0, 1);
+	code[29] = EncodeFADD(fadd_b_constant, 1 + neg, 23, 17,
+			constant_float >> 2, 2, 0, 0);
+
+	// Floating-point multiply-adds, in each operand form and with each
+	// negation
+	code[30] = EncodeFFMA(pt, 16, 17, 18, 16, 3, 0, 1);
+	code[31] = EncodeFFMA(pt, 20, 17, constant_float >> 2, 19, 1, 1, 0);
+	code[33] = EncodeFFMA(2, 21, 17, constant_float >> 2, 18, 2, 0, 0);
+	return code;
+}
+
+// Program counter of each instruction
+static const unsigned pc_mov32i = 1 * 8;
+static const unsigned pc_mov_b_register = 2 * 8;
+static const unsigned pc_mov_b_constant = 3 * 8;
+static const unsigned pc_iadd32i = 4 * 8;
+static const unsigned pc_iadd32i_x = 5 * 8;
+static const unsigned pc_iadd32i_po = 6 * 8;
+static const unsigned pc_psetp = 10 * 8;
+static const unsigned pc_imad = 13 * 8;
+static const unsigned pc_iadd = 15 * 8;
+static const unsigned pc_isetp = 20 * 8;
+static const unsigned pc_fmul = 25 * 8;
+static const unsigned pc_fadd = 27 * 8;
+static const unsigned pc_ffma = 30 * 8;
+static const unsigned pc_fadd_ftz = 34 * 8;
+
+// Initial predicate registers P0-P6 of every warp
+static const unsigned predicates[7] = {
+	0x5555aaaa, 0x0f0f3c3c, 0x33cc33cc, 0xff00f0f0,
+	0x12345678, 0x9abcdef0, 0x0ff0f00f
+};
+
+// Active masks of the full and the partial warp
+static const unsigned active_masks[2] = { 0xfff0ff3f, 0x000f7ffe };
+
+
+// Two identical thread blocks with a full and a partial warp. Instructions
+// are executed at the warp level on the first one, and on each thread on the
+// second one, which must produce the same registers.
+class WarpTest : public testing::Test
+{
+protected:
+
+	// One full warp and one partial warp of 20 threads
+	static const unsigned thread_block_size = 52;
+
+	// Number of general purpose registers used by the kernel
+	static const int num_gprs = 24;
+
+	ObjectPool pool;
+
+	std::unique_ptr<ThreadBlock> warp_thread_block;
+
+	std::unique_ptr<ThreadBlock> thread_thread_block;
+
+	WarpTest() : pool(BuildKernel(), thread_block_size)
+	{
+		int value = 20;
+		float float_value = 1.5f;
+		Emulator *emulator = Emulator::getInstance();
+		emulator->WriteConstantMemory(constant_int, 4,
+				(const char *) &value);
+		emulator->WriteConstantMemory(constant_float, 4,
+				(const char *) &float_value);
+		warp_thread_block = pool.newThreadBlock(0);
+		thread_thread_block = pool.newThreadBlock(0);
+		Initialize(warp_thread_block.get());
+		Initialize(thread_thread_block.get());
+	}
+
+	// Return a warp of a thread block
+	static Warp *getWarp(ThreadBlock *thread_block, int id)
+	{
+		return thread_block->getThread(id *
+				WarpRegisters::NumLanes)->getWarp();
+	}
+
+	// Give the registers, condition codes, and active masks a value that
+	// varies across lanes. Registers R16-R19 and R23 hold floating-point
+	// values, with a denormal one in R19 of every third thread, and the
+	// smallest normal one in R23.
+	static void Initialize(ThreadBlock *thread_block)
+	{
+		for (int i = 0; i < thread_block->getThreadsCount(); i++)
+		{
+			Thread *thread = thread_block->getThread(i);
+			for (int gpr = 0; gpr < num_gprs; gpr++)
+				thread->WriteGPR(gpr, gpr << 16 | i);
+			thread->WriteGPR(2, i + 4);
+			thread->WriteFloatGPR(16, i * 0.5f - 3.0f);
+			thread->WriteFloatGPR(17, 1.0f / (i + 1));
+			thread->WriteFloatGPR(18, i * -1.25f);
+			thread->WriteFloatGPR(19, i % 3 ? i * 0.75f : 1e-40f);
+			thread->WriteFloatGPR(23, FLT_MIN);
+			thread->WriteCC_ZF(i & 1);
+			thread->WriteCC_SF((i >> 1) & 1);
+			thread->WriteCC_CF((i >> 2) & 1);
+			thread->WriteCC_OF((i >> 3) & 1);
+		}
+		for (unsigned id = 0; id < thread_block->getWarpCount(); id++)
+		{
+			Warp *warp = getWarp(thread_block, id);
+			for (int pred = 0; pred < 7; pred++)
+				warp->getRegisters()->WritePredicateMask(pred,
+						~0u, predicates[pred]);
+			warp->getSyncStack()->get()->setActiveMask(
+					active_masks[id]);
+		}
+	}
+
+	// Execute the instruction at the given program counter on both
+	// thread blocks
+	void Execute(unsigned pc, Instruction::Opcode opcode)
+	{
+		Instruction *inst = pool.getGrid()->getInstruction(pc);
+		ASSERT_EQ((unsigned) opcode, inst->getOpcode());
+		for (unsigned id = 0; id < warp_thread_block->getWarpCount();
+				id++)
+		{
+			Warp *warp = getWarp(warp_thread_block.get(), id);
+			warp->setPC(pc);
+			warp->Execute();
+			EXPECT_EQ(pc + 8, warp->getPC());
+
+			warp = getWarp(thread_thread_block.get(), id);
+			warp->setPC(pc);
+			for (unsigned lane = 0; lane < warp->getThreadCount();
+					lane++)
+				warp->getThread(lane)->Execute(opcode, inst);
+		}
+	}
+
+	// Check that both thread blocks have the same registers
+	void Compare()
+	{
+		for (int i = 0; i < warp_thread_block->getThreadsCount(); i++)
+		{
+			SCOPED_TRACE(i);
+			Thread *warp_thread = warp_thread_block->getThread(i);
+			Thread *thread = thread_thread_block->getThread(i);
+			for (int gpr = 0; gpr < num_gprs; gpr++)
+				EXPECT_EQ(thread->ReadGPR(gpr),
+						warp_thread->ReadGPR(gpr));
+			for (int pred = 0; pred <= (int) pt; pred++)
+				EXPECT_EQ(thread->ReadPredicate(pred),
+						warp_thread->ReadPredicate(pred));
+			EXPECT_EQ(thread->ReadCC_ZF(), warp_thread->ReadCC_ZF());
+			EXPECT_EQ(thread->ReadCC_SF(), warp_thread->ReadCC_SF());
+			EXPECT_EQ(thread->ReadCC_CF(), warp_thread->ReadCC_CF());
+			EXPECT_EQ(thread->ReadCC_OF(), warp_thread->ReadCC_OF());
+		}
+	}
+};
+
+
+TEST_F(WarpTest, mov)
+{
+	Execute(pc_mov32i, Instruction::INST_MOV32I);
+	Execute(pc_mov_b_register, Instruction::INST_MOV_B);
+	Execute(pc_mov_b_constant, Instruction::INST_MOV_B);
+	Compare();
+
+	// Active lane with a true predicate
+	Thread *thread = warp_thread_block->getThread(1);
+	EXPECT_EQ(0xdeadbeef, thread->ReadGPR(3));
+	EXPECT_EQ(5u << 16 | 1, thread->ReadGPR(4));
+
+	// Lane with a false predicate, and inactive lane with a true one
+	thread = warp_thread_block->getThread(0);
+	EXPECT_EQ(3u << 16 | 0, thread->ReadGPR(3));
+	thread = warp_thread_block->getThread(7);
+	EXPECT_EQ(3u << 16 | 7, thread->ReadGPR(3));
+
+	// Constant memory entries private to each thread
+	for (int i : { 1, 33 })
+	{
+		thread = warp_thread_block->getThread(i);
+		unsigned value;
+		thread->ReadConstantMemory(0x24, 4, (char *) &value);
+		EXPECT_EQ(value, thread->ReadGPR(6));
+	}
+	EXPECT_NE(warp_thread_block->getThread(1)->ReadGPR(6),
+			warp_thread_block->getThread(33)->ReadGPR(6));
+
+	// Lanes past the end of the partial warp are not written
+	Warp *warp = getWarp(warp_thread_block.get(), 1);
+	EXPECT_EQ(0u, warp->getRegisters()->ReadGPR(6, 20));
+}
+
+
+TEST_F(WarpTest, iadd32i)
+{
+	Execute(pc_iadd32i, Instruction::INST_IADD32I);
+	Compare();
+
+	// Result zero with carry out
+	Thread *thread = warp_thread_block->getThread(12);
+	EXPECT_EQ(0u, thread->ReadGPR(7));
+	EXPECT_EQ(1u, thread->ReadCC_ZF());
+	EXPECT_EQ(1u, thread->ReadCC_CF());
+
+	// Remaining forms
+	for (unsigned pc = pc_iadd32i + 8; pc < pc_psetp; pc += 8)
+		if (pc % 64)
+			Execute(pc, Instruction::INST_IADD32I);
+	Compare();
+}
+
+
+TEST_F(WarpTest, iadd32i_carry)
+{
+	// Each lane adds its own carry in
+	Execute(pc_iadd32i_x, Instruction::INST_IADD32I);
+	Compare();
+	Thread *thread = warp_thread_block->getThread(4);
+	EXPECT_EQ(0x80000001u, thread->ReadGPR(8));
+	EXPECT_EQ(0x7ffffffcu, warp_thread_block->getThread(0)->ReadGPR(8));
+
+	// The carry in is the one left by the previous instruction
+	Execute(pc_iadd32i_x, Instruction::INST_IADD32I);
+	Compare();
+
+	// Signed overflow
+	EXPECT_EQ(0x80000000u, thread->ReadGPR(8));
+	EXPECT_EQ(1u, thread->ReadCC_OF());
+	EXPECT_EQ(1u, thread->ReadCC_SF());
+
+	// Negated immediate
+	Execute(pc_iadd32i_po, Instruction::INST_IADD32I);
+	Compare();
+	EXPECT_EQ(8u - 0x10, thread->ReadGPR(9));
+}
+
+
+TEST_F(WarpTest, psetp)
+{
+	for (unsigned pc = pc_psetp; pc < pc_psetp + 3 * 8; pc += 8)
+		Execute(pc, Instruction::INST_PSETP);
+	Compare();
+
+	// Inactive lanes and lanes with a false predicate keep their value
+	WarpRegisters *registers = getWarp(warp_thread_block.get(), 0)
+			->getRegisters();
+	unsigned mask = active_masks[0] & predicates[3];
+	unsigned value = ((predicates[0] & ~predicates[1]) | predicates[2]);
+	EXPECT_EQ((predicates[4] & ~mask) | (value & mask),
+			registers->getPredicateMask(4));
+
+	// Predicate PT is not changed
+	EXPECT_EQ(~0u, registers->getPredicateMask(pt));
+}
+
+
+TEST_F(WarpTest, reconvergence)
+{
+	// All threads reconverge at the first instruction
+	for (ThreadBlock *thread_block : { warp_thread_block.get(),
+			thread_thread_block.get() })
+	{
+		for (unsigned id = 0; id < thread_block->getWarpCount(); id++)
+		{
+			SyncStack *stack = getWarp(thread_block, id)
+					->getSyncStack()->get();
+			stack->push(pc_mov32i, id ? 0xfffff : ~0u,
+					SyncStackEntrySSY);
+			stack->setActiveMask(1);
+		}
+	}
+	Execute(pc_mov32i, Instruction::INST_MOV32I);
+	Compare();
+
+	// The active mask is restored before executing the instruction
+	Warp *warp = getWarp(warp_thread_block.get(), 0);
+	EXPECT_EQ(~0u, warp->getSyncStack()->get()->getActiveMask());
+	EXPECT_EQ(0xdeadbeef, warp->getThread(7)->ReadGPR(3));
+	warp = getWarp(warp_thread_block.get(), 1);
+	EXPECT_EQ(0xfffffu, warp->getSyncStack()->get()->getActiveMask());
+}
+
+TEST_F(WarpTest, imad)
+{
+	Execute(pc_imad, Instruction::INST_IMAD);
+	Execute(pc_imad + 8, Instruction::INST_IMAD);
+	Compare();
+
+	// R0 * c[0x0][0x30] + R1
+	Thread *thread = warp_thread_block->getThread(1);
+	EXPECT_EQ(1u * 20 + (1u << 16 | 1), thread->ReadGPR(12));
+}
+
+
+TEST_F(WarpTest, iadd)
+{
+	// Negative immediate, updating condition codes
+	Execute(pc_iadd, Instruction::INST_IADD_A);
+	Compare();
+	Thread *thread = warp_thread_block->getThread(1);
+	EXPECT_EQ(0u, thread->ReadGPR(14));
+	EXPECT_EQ(1u, thread->ReadCC_ZF());
+	EXPECT_EQ(1u, thread->ReadCC_CF());
+
+	// Condition codes are kept without .CC
+	Execute(pc_iadd + 2 * 8, Instruction::INST_IADD_A);
+	Compare();
+	EXPECT_EQ(1u, thread->ReadCC_ZF());
+
+	// Register and constant operands
+	Execute(pc_iadd + 3 * 8, Instruction::INST_IADD_B);
+	Execute(pc_iadd + 4 * 8, Instruction::INST_IADD_B);
+	Compare();
+	EXPECT_EQ(5u + (3u << 16 | 1), thread->ReadGPR(5));
+}
+
+
+TEST_F(WarpTest, isetp)
+{
+	// R2 < c[0x0][0x30] holds in threads 0 to 15
+	Execute(pc_isetp, Instruction::INST_ISETP_A);
+	Compare();
+	WarpRegisters *registers = getWarp(warp_thread_block.get(), 0)
+			->getRegisters();
+	unsigned mask = active_masks[0];
+	EXPECT_EQ((predicates[0] & ~mask) | (0x0000ffff & mask),
+			registers->getPredicateMask(0));
+	EXPECT_EQ((predicates[1] & ~mask) | (0xffff0000 & mask),
+			registers->getPredicateMask(1));
+
+	// With a register and the carry flag, and with an immediate
+	Execute(pc_isetp + 8, Instruction::INST_ISETP_A);
+	Execute(pc_isetp + 2 * 8, Instruction::INST_ISETP_B);
+	Compare();
+
+	// R2 - CF >= R2 holds only without carry
+	EXPECT_EQ(1, warp_thread_block->getThread(0)->ReadPredicate(2));
+	EXPECT_EQ(0, warp_thread_block->getThread(4)->ReadPredicate(2));
+	EXPECT_EQ(~0u, registers->getPredicateMask(pt));
+}
+
+
+TEST_F(WarpTest, fmul_fadd)
+{
+	for (unsigned pc = pc_fmul; pc < pc_fadd; pc += 8)
+		Execute(pc, Instruction::INST_FMUL);
+	Compare();
+
+	// |R18| * -R17
+	Thread *thread = warp_thread_block->getThread(2);
+	EXPECT_EQ(2.5f * -(1.0f / 3), thread->ReadFloatGPR(16));
+
+	Execute(pc_fadd, Instruction::INST_FADD_B);
+	Execute(pc_fadd + 8, Instruction::INST_FADD_B);
+	Execute(pc_fadd_ftz, Instruction::INST_FADD_B);
+	Execute(pc_fadd + 2 * 8, Instruction::INST_FADD_B);
+	Compare();
+
+	// Denormal operands are flushed to zero
+	thread = warp_thread_block->getThread(0);
+	EXPECT_EQ(FLT_MIN, thread->ReadFloatGPR(22));
+	EXPECT_EQ(FLT_MIN, thread->ReadFloatGPR(19));
+	thread = warp_thread_block->getThread(1);
+	EXPECT_EQ(FLT_MIN + 0.75f, thread->ReadFloatGPR(22));
+}
+
+
+TEST_F(WarpTest, ffma)
+{
+	for (unsigned pc = pc_ffma; pc < pc_ffma + 4 * 8; pc += 8)
+		if (pc % 64)
+			Execute(pc, Instruction::INST_FFMA_B);
+	Compare();
+
+	// R17 * R18 + c[0x0][0x34]
+	float expected = (1.0f / 3) * -2.5f;
+	expected += 1.5f;
+	Thread *thread = warp_thread_block->getThread(2);
+	EXPECT_EQ(expected, thread->ReadFloatGPR(21));
+}
+
+} // namespace Kepler
@@ -0,0 +1,61 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <arch/southern-islands/emulator/Emulator.h>
+#include <arch/southern-islands/emulator/NDRange.h>
+
+namespace SI
+{
+
+// ND-Ranges launched through an asynchronous queue run in launch order
+TEST(TestNDRange, wait_for_queued_ndrange)
+{
+	Emulator *emulator = Emulator::getInstance();
+	NDRange *first = emulator->addNDRange();
+	NDRange *second = emulator->addNDRange();
+	NDRange *third = emulator->addNDRange();
+
+	// Not queued behind any ND-Range
+	EXPECT_TRUE(emulator->isNDRangeReady(first));
+
+	// Each ND-Range waits for the one launched before it, while it has
+	// waiting work-groups
+	first->AddWorkgroupIdToWaitingList(0);
+	second->AddWorkgroupIdToWaitingList(0);
+	second->setWaitNDRangeId(first->getId());
+	third->setWaitNDRangeId(second->getId());
+	EXPECT_FALSE(emulator->isNDRangeReady(second));
+	EXPECT_FALSE(emulator->isNDRangeReady(third));
+
+	// The first ND-Range completes
+	first->GetWaitingWorkGroup();
+	EXPECT_TRUE(emulator->isNDRangeReady(second));
+	EXPECT_EQ(-1, second->getWaitNDRangeId());
+	EXPECT_FALSE(emulator->isNDRangeReady(third));
+
+	// A freed ND-Range has completed
+	emulator->RemoveNDRange(first);
+	emulator->RemoveNDRange(second);
+	EXPECT_TRUE(emulator->isNDRangeReady(third));
+	emulator->RemoveNDRange(third);
+}
+
+}  // namespace SI
@@ -104,4 +104,140 @@ TEST(TestTiming, config_section_device_frequency_1)
 }
 
 
+// This test checks that a DMA link with no bandwidth is rejected
+TEST(TestTiming, config_section_dma_bandwidth)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// Create config file. The frequency is given explicitly, since
+	// previous tests leave an invalid value.
+	std::string config =
+			"[ Device ]\n"
+			"Frequency = 1000\n"
+			"[ DMA ]\n"
+			"Bandwidth = 0";
+
+	// Load config file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(config);
+
+	// Try ParseConfiguration for invalid bandwidth
+	std::string message;
+	try
+	{
+		Timing::ParseConfiguration(&ini_file);
+	}
+	catch(misc::Error &error)
+	{
+		message = error.getMessage();
+	}
+
+	// Check error message
+	EXPECT_REGEX_MATCH(misc::fmt(".*%s: The values for 'Bandwidth' and "
+			"'BlockSize' in section \\[DMA\\] must be at least 1.\n.*",
+			ini_file.getPath().c_str()).c_str(),
+			message.c_str());
+}
+
+
+// This test checks the number of cycles that transfers occupy the DMA link
+TEST(TestTiming, dma_transfer_cycles)
+{
+	DmaEngine::bandwidth = 16;
+	DmaEngine::block_size = 64;
+	EXPECT_EQ(0, DmaEngine::getTransferCycles(0));
+	EXPECT_EQ(4, DmaEngine::getTransferCycles(1));
+	EXPECT_EQ(4, DmaEngine::getTransferCycles(64));
+	EXPECT_EQ(8, DmaEngine::getTransferCycles(65));
+
+	// Blocks smaller than the link width still take a full cycle
+	DmaEngine::bandwidth = 32;
+	DmaEngine::block_size = 16;
+	EXPECT_EQ(4, DmaEngine::getTransferCycles(64));
+}
+
+
+// This test checks that queued transfers are served in order on the DMA link
+// without a host context
+TEST(TestTiming, dma_enqueue)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// Link parameters. The frequency is given explicitly, since previous
+	// tests leave an invalid value.
+	std::string config =
+			"[ Device ]\n"
+			"Frequency = 1000\n"
+			"[ DMA ]\n"
+			"Latency = 100\n"
+			"Bandwidth = 16\n"
+			"BlockSize = 64";
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(config);
+	Timing::ParseConfiguration(&ini_file);
+
+	// Queue two transfers. The second one waits for the link to be
+	// released by the first one.
+	Timing *timing = Timing::getInstance();
+	DmaEngine *dma_engine = timing->getDmaEngine();
+	long long cycle = timing->getCycle();
+	EXPECT_FALSE(dma_engine->isBusy());
+	dma_engine->Enqueue(DmaEngine::TransferHostToDevice, 64);
+	EXPECT_EQ(cycle + 104, dma_engine->getQueueDoneCycle());
+	dma_engine->Enqueue(DmaEngine::TransferHostToDevice, 128);
+	EXPECT_EQ(cycle + 112, dma_engine->getQueueDoneCycle());
+	EXPECT_TRUE(dma_engine->isBusy());
+
+	// Cleanup singleton instances
+	Cleanup();
+}
+
+
+// This test checks that copies within device memory do not occupy the DMA
+// link
+TEST(TestTiming, dma_device_copy)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// Link parameters
+	std::string config =
+			"[ Device ]\n"
+			"Frequency = 1000\n"
+			"[ DMA ]\n"
+			"Latency = 100\n"
+			"Bandwidth = 16\n"
+			"BlockSize = 64\n"
+			"DeviceBandwidth = 32";
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(config);
+	Timing::ParseConfiguration(&ini_file);
+	EXPECT_EQ(2, DmaEngine::getCopyCycles(64));
+	EXPECT_EQ(3, DmaEngine::getCopyCycles(65));
+
+	// A device copy completes without the link latency
+	Timing *timing = Timing::getInstance();
+	DmaEngine *dma_engine = timing->getDmaEngine();
+	long long cycle = timing->getCycle();
+	dma_engine->Enqueue(DmaEngine::TransferDeviceToDevice, 256);
+	EXPECT_EQ(cycle + 8, dma_engine->getQueueDoneCycle());
+
+	// A host transfer issued next does not wait for the copy
+	dma_engine->Enqueue(DmaEngine::TransferHostToDevice, 64);
+	EXPECT_EQ(cycle + 104, dma_engine->getQueueDoneCycle());
+
+	// Copies are serialized among themselves
+	dma_engine->Enqueue(DmaEngine::TransferDeviceToDevice, 64);
+	dma_engine->Enqueue(DmaEngine::TransferHostToDevice, 64);
+	EXPECT_EQ(cycle + 108, dma_engine->getQueueDoneCycle());
+	dma_engine->Enqueue(DmaEngine::TransferDeviceToDevice, 4096);
+	EXPECT_EQ(cycle + 138, dma_engine->getQueueDoneCycle());
+
+	// Cleanup singleton instances
+	Cleanup();
+}
+
+
 } // namespace SI
@@ -0,0 +1,252 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <arch/southern-islands/disassembler/Instruction.h>
+#include <arch/southern-islands/emulator/NDRange.h>
+#include <arch/southern-islands/emulator/Wavefront.h>
+#include <arch/southern-islands/emulator/WorkGroup.h>
+#include <arch/southern-islands/timing/ComputeUnit.h>
+#include <arch/southern-islands/timing/Gpu.h>
+#include <arch/southern-islands/timing/Timing.h>
+#include <arch/southern-islands/timing/Uop.h>
+#include <arch/southern-islands/timing/VectorMemoryUnit.h>
+#include <arch/southern-islands/timing/WavefrontPool.h>
+#include <lib/cpp/IniFile.h>
+#include <lib/cpp/Misc.h>
+#include <lib/esim/Engine.h>
+#include <memory/Mmu.h>
+#include <memory/Module.h>
+
+namespace SI
+{
+
+// Uop of a full wavefront in compute unit 0, with a vector cache of 64-byte
+// blocks, whose work-item addresses are coalesced by a vector memory unit
+class CoalesceTest : public testing::Test
+{
+protected:
+
+	// Base virtual address of the accesses, at the start of a page
+	static const unsigned base = 0x10000;
+
+	ComputeUnit *compute_unit;
+
+	mem::Mmu *mmu;
+
+	std::unique_ptr<mem::Module> vector_cache;
+
+	std::unique_ptr<NDRange> ndrange;
+
+	std::unique_ptr<WorkGroup> work_group;
+
+	std::unique_ptr<WavefrontPool> wavefront_pool;
+
+	std::unique_ptr<Uop> uop;
+
+	void SetUp() override
+	{
+		// Cleanup singleton instances. The frequency is given
+		// explicitly, since previous tests leave an invalid value.
+		esim::Engine::Destroy();
+		Timing::Destroy();
+		comm::ArchPool::Destroy();
+		misc::IniFile ini_file;
+		ini_file.LoadFromString("[ Device ]\nFrequency = 1000");
+		Timing::ParseConfiguration(&ini_file);
+		VectorMemoryUnit::coalesce = true;
+
+		// Compute unit and vector cache
+		Gpu *gpu = Timing::getInstance()->getGpu();
+		compute_unit = gpu->getComputeUnit(0);
+		mmu = gpu->getMmu();
+		vector_cache = misc::new_unique<mem::Module>("VectorCache",
+				mem::Module::TypeCache, 1, 64, 1);
+		compute_unit->vector_cache = vector_cache.get();
+
+		// One work-group with one wavefront
+		unsigned global_size[1] = { 64 };
+		unsigned local_size[1] = { 64 };
+		ndrange = misc::new_unique<NDRange>();
+		ndrange->SetupSize(global_size, local_size, 1);
+		ndrange->address_space = mmu->newSpace("test");
+		work_group = misc::new_unique<WorkGroup>(ndrange.get(), 0);
+		Wavefront *wavefront = work_group->getWavefront(0);
+		setExecMask(~0ull);
+
+		// Uop
+		wavefront_pool = misc::new_unique<WavefrontPool>(0,
+				compute_unit);
+		uop = misc::new_unique<Uop>(wavefront,
+				wavefront_pool->begin()->get(), 0,
+				work_group.get(), 0);
+	}
+
+	void TearDown() override
+	{
+		uop.reset();
+		wavefront_pool.reset();
+		work_group.reset();
+		ndrange.reset();
+		Timing::Destroy();
+		VectorMemoryUnit::coalesce = true;
+	}
+
+	// Set the mask of active work-items
+	void setExecMask(unsigned long long mask)
+	{
+		Wavefront *wavefront = work_group->getWavefront(0);
+		wavefront->setSregUint(Instruction::RegisterExec, mask);
+		wavefront->setSregUint(Instruction::RegisterExec + 1,
+				mask >> 32);
+	}
+
+	// Give each work-item the virtual address returned by the given
+	// function for its index, coalesce, and return the physical addresses
+	// of the vector cache accesses
+	std::vector<unsigned> Coalesce(std::function<unsigned(int)> address)
+	{
+		for (int i = 0; i < WorkGroup::WavefrontSize; i++)
+			uop->work_item_info_list[i].global_memory_access_address =
+					address(i);
+		VectorMemoryUnit vector_memory_unit(compute_unit);
+		vector_memory_unit.Coalesce(uop.get());
+		EXPECT_TRUE(uop->vector_memory_coalesced);
+		return uop->vector_memory_addresses;
+	}
+
+	// Return the physical address for a virtual address
+	unsigned Translate(unsigned virtual_address)
+	{
+		return mmu->TranslateVirtualAddress(ndrange->address_space,
+				virtual_address);
+	}
+};
+
+
+// Consecutive 4-byte accesses take one access per 64-byte block, through the
+// address of the first work-item in the block
+TEST_F(CoalesceTest, test_unit_stride)
+{
+	std::vector<unsigned> addresses = Coalesce([](int i)
+	{
+		return base + i * 4;
+	});
+	ASSERT_EQ(4u, addresses.size());
+	for (int i = 0; i < 4; i++)
+		EXPECT_EQ(Translate(base + i * 64), addresses[i]);
+	EXPECT_EQ(64, compute_unit->num_vector_memory_work_item_accesses);
+	EXPECT_EQ(4, compute_unit->num_vector_memory_cache_accesses);
+}
+
+
+// Blocks already accessed by earlier work-items are not accessed again, even
+// if they are not the last one added
+TEST_F(CoalesceTest, test_repeated_blocks)
+{
+	// All work-items access the same address
+	EXPECT_EQ(1u, Coalesce([](int i) { return base + 8; }).size());
+
+	// Work-items alternate between two blocks
+	uop->vector_memory_addresses.clear();
+	std::vector<unsigned> addresses = Coalesce([](int i)
+	{
+		return base + (i % 2) * 256 + i;
+	});
+	ASSERT_EQ(2u, addresses.size());
+	EXPECT_EQ(Translate(base), addresses[0]);
+	EXPECT_EQ(Translate(base + 257), addresses[1]);
+	EXPECT_EQ(128, compute_unit->num_vector_memory_work_item_accesses);
+	EXPECT_EQ(3, compute_unit->num_vector_memory_cache_accesses);
+}
+
+
+// Work-items in different blocks are not merged
+TEST_F(CoalesceTest, test_scattered)
+{
+	std::vector<unsigned> addresses = Coalesce([](int i)
+	{
+		return base + i * 64;
+	});
+	EXPECT_EQ(64u, addresses.size());
+}
+
+
+// Inactive work-items do not access memory
+TEST_F(CoalesceTest, test_inactive_work_items)
+{
+	// Only the upper half of the wavefront is active
+	setExecMask(0xffffffff00000000ull);
+	std::vector<unsigned> addresses = Coalesce([](int i)
+	{
+		return base + i * 4;
+	});
+	ASSERT_EQ(2u, addresses.size());
+	EXPECT_EQ(Translate(base + 128), addresses[0]);
+	EXPECT_EQ(Translate(base + 192), addresses[1]);
+	EXPECT_EQ(32, compute_unit->num_vector_memory_work_item_accesses);
+
+	// No active work-item
+	uop->vector_memory_addresses.clear();
+	setExecMask(0);
+	EXPECT_TRUE(Coalesce([](int i) { return base; }).empty());
+}
+
+
+// Work-items accessing different pages get the physical address of their own
+// page
+TEST_F(CoalesceTest, test_page_crossing)
+{
+	// Work-items alternate between two pages
+	unsigned page_size = mem::Mmu::PageSize;
+	std::vector<unsigned> addresses = Coalesce([&](int i)
+	{
+		return base + (i % 2) * 16 * page_size + i * 4;
+	});
+	ASSERT_EQ(8u, addresses.size());
+	EXPECT_EQ(Translate(base), addresses[0]);
+	EXPECT_EQ(Translate(base + 16 * page_size + 4), addresses[1]);
+	EXPECT_EQ(Translate(base + 64), addresses[2]);
+	EXPECT_NE(Translate(base) + 16 * page_size,
+			Translate(base + 16 * page_size));
+}
+
+
+// Without coalescing, each active work-item accesses the cache with its own
+// address
+TEST_F(CoalesceTest, test_disabled)
+{
+	VectorMemoryUnit::coalesce = false;
+	std::vector<unsigned> addresses = Coalesce([](int i)
+	{
+		return base + (i / 2) * 4;
+	});
+	ASSERT_EQ(64u, addresses.size());
+	for (int i = 0; i < 64; i++)
+		EXPECT_EQ(Translate(base + (i / 2) * 4), addresses[i]);
+	EXPECT_EQ(64, compute_unit->num_vector_memory_cache_accesses);
+}
+
+
+}  // namespace SI
@@ -0,0 +1,202 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <arch/x86/emulator/Emulator.h>
+#include <arch/x86/emulator/Reactor.h>
+#include <lib/cpp/Error.h>
+#include <lib/esim/Engine.h>
+
+#include "TestFiles.h"
+
+
+namespace x86
+{
+
+// Contexts are only used by the reactor as keys of its watch tables
+static Context *const context_0 = (Context *) 0x1000;
+static Context *const context_1 = (Context *) 0x2000;
+
+
+// Wait up to one second for the reactor to finish the watch for a context,
+// and return whether it did.
+static bool WaitForWatch(Reactor *reactor, Context *context)
+{
+	for (int i = 0; i < 1000; i++)
+	{
+		if (!reactor->isWatching(context))
+			return true;
+		usleep(1000);
+	}
+	return false;
+}
+
+
+TEST(TestReactor, test_watch_host_file)
+{
+	Reactor reactor(Emulator::getInstance());
+	int pipe_fds[2];
+	ASSERT_EQ(0, pipe(pipe_fds));
+
+	// Nothing to read yet
+	reactor.Watch(context_0, pipe_fds[0], POLLIN, 0);
+	usleep(10000);
+	EXPECT_TRUE(reactor.isWatching(context_0));
+
+	// The watch finishes when the pipe becomes readable
+	ASSERT_EQ(1, write(pipe_fds[1], "x", 1));
+	EXPECT_TRUE(WaitForWatch(&reactor, context_0));
+
+	// The write end of the pipe is ready right away
+	reactor.Watch(context_1, pipe_fds[1], POLLOUT, 0);
+	EXPECT_TRUE(WaitForWatch(&reactor, context_1));
+
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+}
+
+
+TEST(TestReactor, test_watch_deadline)
+{
+	Reactor reactor(Emulator::getInstance());
+	esim::Engine *esim = esim::Engine::getInstance();
+
+	// Only a deadline
+	long long start = esim->getRealTime();
+	reactor.Watch(context_0, -1, 0, start + 20000);
+	EXPECT_TRUE(reactor.isWatching(context_0));
+	EXPECT_TRUE(WaitForWatch(&reactor, context_0));
+	EXPECT_GE(esim->getRealTime() - start, 15000);
+
+	// A deadline finishes a watch on a host file with no events
+	int pipe_fds[2];
+	ASSERT_EQ(0, pipe(pipe_fds));
+	reactor.Watch(context_1, pipe_fds[0], POLLIN,
+			esim->getRealTime() + 10000);
+	EXPECT_TRUE(WaitForWatch(&reactor, context_1));
+
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+}
+
+
+TEST(TestReactor, test_watch_regular_file)
+{
+	// Regular files are not supported by 'epoll' and are always ready
+	std::string path = test::CreateTempFile("reactor", "");
+	int fd = open(path.c_str(), O_RDONLY);
+	ASSERT_GE(fd, 0);
+	Reactor reactor(Emulator::getInstance());
+	reactor.Watch(context_0, fd, POLLIN, 0);
+	EXPECT_TRUE(WaitForWatch(&reactor, context_0));
+	close(fd);
+	unlink(path.c_str());
+}
+
+
+TEST(TestReactor, test_cancel_and_replace)
+{
+	Reactor reactor(Emulator::getInstance());
+	int pipe_fds[2];
+	ASSERT_EQ(0, pipe(pipe_fds));
+
+	// Cancel
+	reactor.Watch(context_0, pipe_fds[0], POLLIN, 0);
+	reactor.Cancel(context_0);
+	EXPECT_FALSE(reactor.isWatching(context_0));
+	reactor.Cancel(context_0);
+
+	// A new watch replaces the previous one for the same context, so an
+	// event for the old one does not finish it
+	reactor.Watch(context_0, pipe_fds[0], POLLIN, 0);
+	reactor.Watch(context_0, -1, 0,
+			esim::Engine::getInstance()->getRealTime() + 60000000);
+	ASSERT_EQ(1, write(pipe_fds[1], "x", 1));
+	usleep(10000);
+	EXPECT_TRUE(reactor.isWatching(context_0));
+	reactor.Cancel(context_0);
+
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+}
+
+
+TEST(TestReactor, test_watch_invalid_file)
+{
+	Reactor reactor(Emulator::getInstance());
+
+	// A descriptor that is not open cannot be watched
+	int fd = open("/dev/null", O_RDONLY);
+	ASSERT_GE(fd, 0);
+	close(fd);
+	EXPECT_THROW(reactor.Watch(context_0, fd, POLLIN, 0), misc::Panic);
+
+	// No watch is left, and the reactor mutex was released
+	EXPECT_FALSE(reactor.isWatching(context_0));
+	reactor.Watch(context_0, -1, 0,
+			esim::Engine::getInstance()->getRealTime() + 1000);
+	EXPECT_TRUE(WaitForWatch(&reactor, context_0));
+}
+
+
+TEST(TestReactor, test_detach_after_fork)
+{
+	Reactor *reactor = new Reactor(Emulator::getInstance());
+	int pipe_fds[2];
+	ASSERT_EQ(0, pipe(pipe_fds));
+	reactor->Watch(context_0, pipe_fds[0], POLLIN, 0);
+
+	// In the child, destroying the reactor must not wait for the host
+	// thread, and must close the 'epoll', timer, and stop descriptors,
+	// plus the duplicate of the watched file.
+	pid_t pid = fork();
+	ASSERT_GE(pid, 0);
+	if (!pid)
+	{
+		int num_files = test::getNumOpenFiles();
+		reactor->DetachAfterFork();
+		delete reactor;
+		_exit(test::getNumOpenFiles() == num_files - 4 ? 0 : 1);
+	}
+
+	// Check child
+	int status;
+	ASSERT_EQ(pid, waitpid(pid, &status, 0));
+	ASSERT_TRUE(WIFEXITED(status));
+	EXPECT_EQ(0, WEXITSTATUS(status));
+
+	// The reactor still works in the parent
+	EXPECT_TRUE(reactor->isWatching(context_0));
+	ASSERT_EQ(1, write(pipe_fds[1], "x", 1));
+	EXPECT_TRUE(WaitForWatch(reactor, context_0));
+	delete reactor;
+
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+}
+
+
+}  // namespace x86
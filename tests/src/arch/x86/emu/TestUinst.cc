@@ -0,0 +1,159 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <arch/x86/emulator/Context.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <arch/x86/emulator/Uinst.h>
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <memory/Manager.h>
+#include <memory/Memory.h>
+
+
+namespace x86
+{
+
+// Context producing micro-instructions for a piece of code, with a data
+// area that its memory operands point to
+class UinstContext
+{
+public:
+
+	Context *context;
+
+	unsigned eip;
+
+	unsigned data;
+
+	UinstContext(const std::vector<unsigned char> &code)
+	{
+		// Create context
+		context = Emulator::getInstance()->newContext();
+		context->Initialize();
+		mem::Memory *memory = context->getMemory();
+		memory->setHeapBreak(misc::RoundUp(memory->getHeapBreak(),
+				mem::Memory::PageSize));
+
+		// Code and data
+		mem::Manager manager(memory);
+		eip = manager.Allocate(code.size(), 128);
+		memory->Write(eip, code.size(), (const char *) code.data());
+		data = manager.Allocate(256, 128);
+		context->setUinstActive(true);
+	}
+
+	// Emulate the instruction at the given offset of the code, with
+	// registers 'ebx' and 'esp' pointing to the given offsets of the data
+	// area, and return the dump of the micro-instructions produced.
+	std::string Execute(unsigned offset, unsigned ebx, unsigned esp)
+	{
+		Regs &regs = context->getRegs();
+		regs.setEip(eip + offset);
+		regs.setEbx(data + ebx);
+		regs.setEsp(data + esp);
+		context->Execute();
+		std::ostringstream os;
+		while (context->getNumUinsts())
+		{
+			context->ExtractUinst()->Dump(os);
+			os << '\n';
+		}
+		return os.str();
+	}
+};
+
+
+// Each instruction is executed twice at the same address, with different
+// memory operands. The second time, the micro-instructions are replayed
+// from the templates recorded in the first execution, and must be equal to
+// those of a context that never executed the instruction, including their
+// patched memory addresses.
+TEST(TestUinst, test_template_replay_addresses)
+{
+	try
+	{
+		std::vector<unsigned char> code = {
+			0x8b, 0x03,		// mov eax, [ebx]
+			0x01, 0x43, 0x04,	// add [ebx + 4], eax
+			0x50,			// push eax
+			0x8b, 0x43, 0x08	// mov eax, [ebx + 8]
+		};
+		std::vector<unsigned> offsets = { 0, 2, 5, 6 };
+		UinstContext replay(code);
+		UinstContext fresh(code);
+		for (unsigned offset : offsets)
+		{
+			std::string recorded = replay.Execute(offset, 16, 128);
+			std::string replayed = replay.Execute(offset, 64, 192);
+			std::string expected = fresh.Execute(offset, 64, 192);
+			EXPECT_EQ(expected, replayed);
+			EXPECT_NE(recorded, replayed);
+			EXPECT_NE(std::string::npos, replayed.find(" [0x"));
+		}
+
+		// Templates are replayed again with the new addresses of every
+		// execution
+		std::string replayed = replay.Execute(2, 96, 224);
+		std::string expected = fresh.Execute(2, 96, 224);
+		EXPECT_EQ(expected, replayed);
+		EXPECT_NE(std::string::npos, replayed.find(misc::fmt(
+				" [0x%x,4]", fresh.data + 100)));
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+
+TEST(TestUinst, test_allocator_free_blocks)
+{
+	// Freed blocks are kept for reuse up to the maximum
+	typedef Uinst::Allocator<long long> Allocator;
+	Allocator allocator;
+	int max_free_blocks = Allocator::MaxFreeBlocks;
+	int count = max_free_blocks + 16;
+	std::vector<long long *> blocks;
+	for (int i = 0; i < count; i++)
+		blocks.push_back(allocator.allocate(1));
+	for (long long *block : blocks)
+		allocator.deallocate(block, 1);
+	EXPECT_EQ(max_free_blocks, Allocator::getNumFreeBlocks());
+
+	// Blocks are recycled
+	long long *block = allocator.allocate(1);
+	EXPECT_EQ(max_free_blocks - 1, Allocator::getNumFreeBlocks());
+	allocator.deallocate(block, 1);
+	EXPECT_EQ(max_free_blocks, Allocator::getNumFreeBlocks());
+
+	// Arrays are not recycled
+	long long *array = allocator.allocate(4);
+	allocator.deallocate(array, 4);
+	EXPECT_EQ(max_free_blocks, Allocator::getNumFreeBlocks());
+}
+
+
+}  // namespace x86
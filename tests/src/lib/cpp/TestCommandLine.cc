@@ -0,0 +1,134 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <lib/cpp/CommandLine.h>
+#include <lib/cpp/Error.h>
+
+
+namespace misc
+{
+
+// Options registered in a fresh command line, processed with no arguments
+class CommandLineTest : public testing::Test
+{
+protected:
+
+	CommandLine command_line;
+
+	int count = 1;
+	std::string name = "default";
+	bool verbose = false;
+	int level = 0;
+
+	void SetUp() override
+	{
+		command_line.RegisterInt32("--count <n>", count, "Count");
+		command_line.RegisterString("--name <name>", name, "Name");
+		command_line.RegisterBool("--verbose", verbose, "Verbose");
+		command_line.RegisterInt32("-l <level>", level, "Level");
+
+		const char *argv[] = { "m2s" };
+		command_line.Process(1, (char **) argv);
+	}
+
+	// Return the error message produced by the overrides, or an empty
+	// string if they were accepted.
+	std::string Override(const std::vector<std::string> &options,
+			const std::unordered_set<std::string> *allowed =
+			nullptr)
+	{
+		try
+		{
+			command_line.ProcessOverrides(options, allowed);
+		}
+		catch (misc::Error &error)
+		{
+			return error.getMessage();
+		}
+		return "";
+	}
+};
+
+
+TEST_F(CommandLineTest, test_option_names)
+{
+	ASSERT_EQ(4, command_line.getNumOptions());
+	EXPECT_EQ("--count", command_line.getOptionName(0));
+	EXPECT_EQ("--name", command_line.getOptionName(1));
+	EXPECT_EQ("--verbose", command_line.getOptionName(2));
+	EXPECT_EQ("-l", command_line.getOptionName(3));
+}
+
+
+TEST_F(CommandLineTest, test_overrides)
+{
+	EXPECT_EQ("", Override({ "--count", "5", "--name", "other",
+			"--verbose", "-l3" }));
+	EXPECT_EQ(5, count);
+	EXPECT_EQ("other", name);
+	EXPECT_TRUE(verbose);
+	EXPECT_EQ(3, level);
+
+	// A later call overrides the same options again
+	EXPECT_EQ("", Override({ "--count", "7" }));
+	EXPECT_EQ(7, count);
+	EXPECT_EQ("other", name);
+}
+
+
+TEST_F(CommandLineTest, test_invalid_overrides)
+{
+	EXPECT_REGEX_MATCH(".*Invalid option override: argument.*",
+			Override({ "argument" }).c_str());
+	EXPECT_REGEX_MATCH(".*Invalid option override: --help.*",
+			Override({ "--help" }).c_str());
+	EXPECT_REGEX_MATCH(".*Invalid option: --unknown\n.*",
+			Override({ "--unknown" }).c_str());
+	EXPECT_REGEX_MATCH(".*Option '--count' expects 1 argument.*",
+			Override({ "--count" }).c_str());
+	EXPECT_REGEX_MATCH(".*Multiple occurrences of option '--name'.*",
+			Override({ "--name", "a", "--name", "b" }).c_str());
+	EXPECT_EQ(1, count);
+}
+
+
+TEST_F(CommandLineTest, test_allowed_overrides)
+{
+	std::unordered_set<std::string> allowed = { "--count", "-l" };
+	EXPECT_EQ("", Override({ "--count", "5", "-l", "2" }, &allowed));
+	EXPECT_EQ(5, count);
+	EXPECT_EQ(2, level);
+
+	// Options out of the allowed set are rejected and not applied
+	EXPECT_REGEX_MATCH(".*Option '--name' cannot be overridden.*",
+			Override({ "--name", "other" }, &allowed).c_str());
+	EXPECT_EQ("default", name);
+	EXPECT_REGEX_MATCH(".*Option '--verbose' cannot be overridden.*",
+			Override({ "--verbose" }, &allowed).c_str());
+	EXPECT_FALSE(verbose);
+}
+
+
+}  // namespace misc
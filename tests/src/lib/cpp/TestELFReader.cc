@@ -0,0 +1,197 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include <lib/cpp/ELFReader.h>
+
+#include "TestFiles.h"
+
+
+namespace ELFReader
+{
+
+// Build a minimal 32-bit ELF file with sections '.shstrtab', '.symtab', and
+// '.strtab', and one symbol 'main' with value 4 and 4 bytes of content in
+// '.text'.
+static std::string BuildELF()
+{
+	const char shstrtab[] = "\0.shstrtab\0.symtab\0.strtab\0.text";
+	const char strtab[] = "\0main";
+	const char text[] = "\x01\x02\x03\x04";
+	const unsigned shstrtab_offset = sizeof(Elf32_Ehdr);
+	const unsigned strtab_offset = shstrtab_offset + sizeof shstrtab;
+	const unsigned text_offset = strtab_offset + sizeof strtab;
+	const unsigned symtab_offset = (text_offset + 4 + 3) & ~3;
+	const unsigned shoff = symtab_offset + 2 * sizeof(Elf32_Sym);
+	const int num_sections = 5;
+	std::string content(shoff + num_sections * sizeof(Elf32_Shdr), '\0');
+	char *buffer = &content[0];
+
+	// Header
+	Elf32_Ehdr *ehdr = (Elf32_Ehdr *) buffer;
+	memcpy(ehdr->e_ident, ELFMAG, SELFMAG);
+	ehdr->e_ident[EI_CLASS] = ELFCLASS32;
+	ehdr->e_ident[EI_DATA] = ELFDATA2LSB;
+	ehdr->e_ident[EI_VERSION] = EV_CURRENT;
+	ehdr->e_type = ET_EXEC;
+	ehdr->e_shoff = shoff;
+	ehdr->e_ehsize = sizeof(Elf32_Ehdr);
+	ehdr->e_shentsize = sizeof(Elf32_Shdr);
+	ehdr->e_shnum = num_sections;
+	ehdr->e_shstrndx = 1;
+
+	// Section content
+	memcpy(buffer + shstrtab_offset, shstrtab, sizeof shstrtab);
+	memcpy(buffer + strtab_offset, strtab, sizeof strtab);
+	memcpy(buffer + text_offset, text, 4);
+	Elf32_Sym *sym = (Elf32_Sym *) (buffer + symtab_offset) + 1;
+	sym->st_name = 1;
+	sym->st_value = 4;
+	sym->st_size = 4;
+	sym->st_info = ELF32_ST_INFO(STB_GLOBAL, STT_FUNC);
+	sym->st_shndx = 4;
+
+	// Section headers
+	Elf32_Shdr *shdr = (Elf32_Shdr *) (buffer + shoff);
+	shdr[1].sh_name = 1;
+	shdr[1].sh_type = SHT_STRTAB;
+	shdr[1].sh_offset = shstrtab_offset;
+	shdr[1].sh_size = sizeof shstrtab;
+	shdr[2].sh_name = 11;
+	shdr[2].sh_type = SHT_SYMTAB;
+	shdr[2].sh_offset = symtab_offset;
+	shdr[2].sh_size = 2 * sizeof(Elf32_Sym);
+	shdr[2].sh_link = 3;
+	shdr[3].sh_name = 19;
+	shdr[3].sh_type = SHT_STRTAB;
+	shdr[3].sh_offset = strtab_offset;
+	shdr[3].sh_size = sizeof strtab;
+	shdr[4].sh_name = 27;
+	shdr[4].sh_type = SHT_PROGBITS;
+	shdr[4].sh_offset = text_offset - 4;
+	shdr[4].sh_size = 8;
+	return content;
+}
+
+
+TEST(TestELFReader, test_read_tables)
+{
+	std::string content = BuildELF();
+	File file(content.c_str(), content.size());
+
+	// Sections
+	Section *symtab = file.getSection(".symtab");
+	ASSERT_TRUE(symtab != nullptr);
+	EXPECT_EQ(SHT_SYMTAB, (int) symtab->getType());
+	EXPECT_EQ(5, (int) file.getSections().size());
+	EXPECT_EQ(file.getSection(1), file.getStringTable());
+
+	// Symbols
+	Symbol *symbol = file.getSymbol("main");
+	ASSERT_TRUE(symbol != nullptr);
+	EXPECT_EQ(4u, symbol->getValue());
+	EXPECT_EQ(symbol, file.getSymbolByAddress(6));
+	EXPECT_EQ(1, (int) file.getSymbols().size());
+
+	// Symbol content is copied into the stream
+	std::istringstream stream;
+	symbol->getStream(stream);
+	char data[4];
+	stream.read(data, 4);
+	EXPECT_EQ(0, memcmp(data, "\x01\x02\x03\x04", 4));
+}
+
+
+TEST(TestELFReader, test_lazy_tables)
+{
+	// Invalid section header size. Only the ELF header is read when the
+	// file is loaded.
+	std::string content = BuildELF();
+	((Elf32_Ehdr *) &content[0])->e_shentsize = 1;
+	File file(content.c_str(), content.size());
+	EXPECT_EQ(ET_EXEC, ((const Elf32_Ehdr *) file.getBuffer())->e_type);
+
+	// The error is reported when the section table is first needed,
+	// and again on every later attempt
+	EXPECT_THROW(file.getSection(".symtab"), Error);
+	EXPECT_THROW(file.getSymbol("main"), Error);
+	EXPECT_THROW(file.getSections(), Error);
+
+	// Program headers are read independently of sections
+	EXPECT_TRUE(file.getProgramHeaders().empty());
+
+	// Without reading the content, no table is ever parsed
+	File header_only(content.c_str(), content.size(), false);
+	EXPECT_TRUE(header_only.getSection(".symtab") == nullptr);
+	EXPECT_TRUE(header_only.getSymbol("main") == nullptr);
+	EXPECT_TRUE(header_only.getSections().empty());
+
+	// An invalid ELF header is still reported right away
+	content[0] = 0;
+	EXPECT_THROW(File(content.c_str(), content.size()), Error);
+}
+
+
+TEST(TestELFReader, test_mapping_sharing)
+{
+	std::string content = BuildELF();
+	std::string path = test::CreateTempFile("test-elf", content);
+	EXPECT_EQ(0, File::getNumMappings());
+	{
+		// Readers of the same file share one mapping
+		File file_a(path);
+		File file_b(path);
+		EXPECT_EQ(file_a.getBuffer(), file_b.getBuffer());
+		EXPECT_EQ(1, File::getNumMappings());
+		ASSERT_TRUE(file_b.getSymbol("main") != nullptr);
+
+		// A modified file is mapped again for new readers. Current
+		// readers keep their own mapping and size, but not a snapshot
+		// of the content: pages they have not touched show later writes
+		// to the file, and pages past a truncated end fault on access.
+		// Growing the file leaves their pages valid.
+		content.append(16, '\0');
+		ASSERT_EQ(0, truncate(path.c_str(), content.size()));
+		File file_c(path);
+		EXPECT_NE(file_a.getBuffer(), file_c.getBuffer());
+		EXPECT_EQ(content.size(), file_c.getSize());
+		EXPECT_EQ(content.size() - 16, file_a.getSize());
+		EXPECT_EQ(1, File::getNumMappings());
+		ASSERT_TRUE(file_a.getSymbol("main") != nullptr);
+		ASSERT_TRUE(file_c.getSymbol("main") != nullptr);
+	}
+
+	// Entries are removed when the last reader is destroyed
+	EXPECT_EQ(0, File::getNumMappings());
+
+	// Failing to load a file leaves no entry
+	unlink(path.c_str());
+	EXPECT_THROW(File file(path), Error);
+	EXPECT_EQ(0, File::getNumMappings());
+}
+
+
+}  // namespace ELFReader
@@ -19,6 +19,8 @@
 
 #include "gtest/gtest.h"
 
+#include <sstream>
+
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/Error.h>
 #include <lib/esim/Engine.h>
@@ -516,9 +518,85 @@ TEST(TestEngine, test_event_queue_priority)
 	}
 }
 
+
+
+//
+// Test 5
+//
+
+// Event executed synchronously by the handler of the other event
+Event *event_5_inner = nullptr;
+
+void testHandler_5_inner(Event *event, Frame *frame)
+{
 }
 
+void testHandler_5_outer(Event *event, Frame *frame)
+{
+	Engine *engine = Engine::getInstance();
+	engine->Execute(event_5_inner, misc::new_shared<Frame>(), nullptr);
+}
 
+// Tests that the simulator profile counts executed events and profile
+// regions, and reports them
+TEST(TestEngine, test_profile)
+{
+	try
+	{
+		// Cleanup pointers to singleton instances
+		Cleanup();
 
+		// Activate profile
+		Engine::setProfilePath("");
+		Engine *engine = Engine::getInstance();
+
+		// Set up events
+		FrequencyDomain *domain = engine->RegisterFrequencyDomain(
+				"profile domain", 1000);
+		Event *event_outer = engine->RegisterEvent("outer event",
+				testHandler_5_outer, domain);
+		event_5_inner = engine->RegisterEvent("inner event",
+				testHandler_5_inner, domain);
+
+		// Regions with the same name are registered once
+		ProfileRegion *region = engine->RegisterProfileRegion("region");
+		EXPECT_EQ(region, engine->RegisterProfileRegion("region"));
+
+		// Run the outer event three times
+		engine->Call(event_outer, nullptr, nullptr, 1, 0);
+		engine->Call(event_outer, nullptr, nullptr, 2, 0);
+		engine->Call(event_outer, nullptr, nullptr, 2, 0);
+		for (int i = 0; i < 4; i++)
+		{
+			ProfileScope profile(region);
+			engine->ProcessEvents();
+		}
 
+		// Check counts
+		EXPECT_EQ(3, event_outer->getNumExecuted());
+		EXPECT_EQ(3, event_5_inner->getNumExecuted());
+		EXPECT_EQ(4, region->getCount());
+
+		// Check report
+		std::ostringstream os;
+		engine->DumpProfile(os);
+		std::string report = os.str();
+		EXPECT_NE(std::string::npos, report.find("Events = 6\n"));
+		EXPECT_NE(std::string::npos, report.find("\nprofile domain "));
+		EXPECT_NE(std::string::npos, report.find("\nouter event "));
+		EXPECT_NE(std::string::npos, report.find("\ninner event "));
+		EXPECT_NE(std::string::npos, report.find("\nregion "));
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		ADD_FAILURE();
+	}
+
+	// Deactivate profile for the following tests
+	ProfileRegion::Deactivate();
+	EXPECT_FALSE(ProfileRegion::isActive());
+}
+
+}
 
@@ -0,0 +1,217 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory/Memory.h>
+
+#include "TestFiles.h"
+
+namespace mem
+{
+
+TEST(TestMemory, code_version_write_to_code_page)
+{
+	Memory memory;
+	memory.Map(0x1000, 2 * Memory::PageSize, Memory::AccessRead |
+			Memory::AccessWrite | Memory::AccessExec);
+	unsigned value = 0;
+	memory.Write(0x1000, 4, (char *) &value);
+
+	// Writes to pages without cached code keep the version
+	memory.MarkCode(0x1000);
+	unsigned long long version = memory.getCodeVersion();
+	memory.Write(0x2000, 4, (char *) &value);
+	EXPECT_EQ(version, memory.getCodeVersion());
+
+	// A write to a page with cached code increases the version once
+	memory.Write(0x1004, 4, (char *) &value);
+	EXPECT_NE(version, memory.getCodeVersion());
+	version = memory.getCodeVersion();
+	memory.Write(0x1008, 4, (char *) &value);
+	EXPECT_EQ(version, memory.getCodeVersion());
+}
+
+TEST(TestMemory, code_version_unmap_and_protect)
+{
+	Memory memory;
+	memory.Map(0x1000, 2 * Memory::PageSize, Memory::AccessRead |
+			Memory::AccessExec);
+
+	// Pages without cached code keep the version
+	unsigned long long version = memory.getCodeVersion();
+	memory.Protect(0x2000, Memory::PageSize, Memory::AccessRead);
+	memory.Unmap(0x2000, Memory::PageSize);
+	EXPECT_EQ(version, memory.getCodeVersion());
+
+	// Pages with cached code increase it
+	memory.MarkCode(0x1000);
+	memory.Protect(0x1000, Memory::PageSize, Memory::AccessRead);
+	EXPECT_NE(version, memory.getCodeVersion());
+
+	version = memory.getCodeVersion();
+	memory.MarkCode(0x1000);
+	memory.Unmap(0x1000, Memory::PageSize);
+	EXPECT_NE(version, memory.getCodeVersion());
+}
+
+TEST(TestMemory, code_version_new_page)
+{
+	// In safe mode, no instruction can have been fetched from a page
+	// before it exists
+	Memory memory;
+	memory.setSafe(true);
+	unsigned long long version = memory.getCodeVersion();
+	memory.Map(0x1000, Memory::PageSize, Memory::AccessRead);
+	EXPECT_EQ(version, memory.getCodeVersion());
+
+	// In unsafe mode, zeros may have been fetched and cached
+	memory.setSafe(false);
+	memory.Map(0x2000, Memory::PageSize, Memory::AccessRead);
+	EXPECT_NE(version, memory.getCodeVersion());
+}
+
+TEST(TestMemory, copy_from_across_pages)
+{
+	Memory src;
+	Memory dest;
+	src.Map(0x1000, 3 * Memory::PageSize, Memory::AccessRead |
+			Memory::AccessWrite);
+	dest.Map(0x8000, 3 * Memory::PageSize, Memory::AccessRead |
+			Memory::AccessWrite);
+
+	// Source data spans three pages, with unaligned start and end
+	std::string data(2 * Memory::PageSize + 100, 'a');
+	for (unsigned i = 0; i < data.size(); i++)
+		data[i] = 'a' + i % 26;
+	src.Write(0x1010, data.size(), data.c_str());
+
+	// Copy with a different page offset in the destination
+	dest.CopyFrom(src, 0x1010, 0x8123, data.size());
+	std::string result(data.size(), 0);
+	dest.Read(0x8123, result.size(), &result[0]);
+	EXPECT_EQ(data, result);
+
+	// Pages never written read as zeros
+	dest.Write(0x8000, 4, "xxxx");
+	dest.CopyFrom(src, 0x3f00, 0x8000, 4);
+	char buffer[4] = { 1, 1, 1, 1 };
+	dest.Read(0x8000, 4, buffer);
+	EXPECT_EQ(0, buffer[0] | buffer[1] | buffer[2] | buffer[3]);
+}
+
+TEST(TestMemory, copy_from_overlapping)
+{
+	Memory memory;
+	memory.Map(0x1000, Memory::PageSize, Memory::AccessRead |
+			Memory::AccessWrite);
+	memory.Write(0x1000, 8, "abcdefgh");
+	memory.CopyFrom(memory, 0x1000, 0x1002, 6);
+	char buffer[9] = { };
+	memory.Read(0x1000, 8, buffer);
+	EXPECT_STREQ("ababcdef", buffer);
+}
+
+TEST(TestMemory, copy_from_permission_denied)
+{
+	Memory src;
+	Memory dest;
+	src.Map(0x1000, Memory::PageSize, Memory::AccessWrite);
+	dest.Map(0x1000, Memory::PageSize, Memory::AccessWrite);
+	EXPECT_THROW(dest.CopyFrom(src, 0x1000, 0x1000, 4), Memory::Error);
+}
+
+// Create a temporary host file with one page of 'a' characters followed by
+// 100 'b' characters, and return its descriptor opened for reading and
+// writing.
+static int CreateMappedFile(std::string &path)
+{
+	std::string content(Memory::PageSize, 'a');
+	content += std::string(100, 'b');
+	path = test::CreateTempFile("test-memory", content);
+	int fd = open(path.c_str(), O_RDWR);
+	EXPECT_GE(fd, 0);
+	return fd;
+}
+
+TEST(TestMemory, map_file_private_copy_on_write)
+{
+	std::string path;
+	int fd = CreateMappedFile(path);
+	Memory memory;
+	memory.Map(0x1000, 3 * Memory::PageSize, Memory::AccessRead |
+			Memory::AccessWrite);
+	ASSERT_TRUE(memory.MapFile(0x1000, 3 * Memory::PageSize, fd, 0,
+			false));
+
+	// Pages read from the file, and past its end as zeros
+	char buffer[4] = { };
+	memory.Read(0x1ffe, 4, buffer);
+	EXPECT_EQ(std::string("aabb"), std::string(buffer, 4));
+	memory.Read(0x3000, 4, buffer);
+	EXPECT_EQ(std::string(4, 0), std::string(buffer, 4));
+
+	// Writes, also into a copy, do not reach the file
+	memory.Write(0x1000, 4, "xxxx");
+	Memory copy(memory);
+	copy.Write(0x2000, 4, "yyyy");
+	memory.Read(0x2000, 4, buffer);
+	EXPECT_EQ(std::string("bbbb"), std::string(buffer, 4));
+	copy.Read(0x1000, 4, buffer);
+	EXPECT_EQ(std::string("xxxx"), std::string(buffer, 4));
+	EXPECT_EQ(4, pread(fd, buffer, 4, 0));
+	EXPECT_EQ(std::string("aaaa"), std::string(buffer, 4));
+
+	close(fd);
+	unlink(path.c_str());
+}
+
+TEST(TestMemory, map_file_shared_write_through)
+{
+	std::string path;
+	int fd = CreateMappedFile(path);
+	Memory memory;
+	memory.Map(0x1000, 2 * Memory::PageSize, Memory::AccessRead |
+			Memory::AccessWrite);
+	ASSERT_TRUE(memory.MapFile(0x1000, 2 * Memory::PageSize, fd, 0,
+			true));
+
+	// Writes go into the file
+	memory.Write(0x2000, 4, "xxxx");
+	char buffer[4] = { };
+	EXPECT_EQ(4, pread(fd, buffer, 4, Memory::PageSize));
+	EXPECT_EQ(std::string("xxxx"), std::string(buffer, 4));
+
+	// Only regular files can be mapped
+	int pipe_fds[2];
+	ASSERT_EQ(0, pipe(pipe_fds));
+	EXPECT_FALSE(memory.MapFile(0x1000, Memory::PageSize, pipe_fds[0], 0,
+			false));
+
+	close(pipe_fds[0]);
+	close(pipe_fds[1]);
+	close(fd);
+	unlink(path.c_str());
+}
+
+}  // namespace mem
@@ -219,6 +219,74 @@ TEST(TestModule, is_in_flight_access)
 }
 
 
+// This test checks isInFlightAccess() and isInFlightAddress() with many
+// simultaneous in-flight accesses, some of them to blocks sharing the same
+// bucket of the in-flight block address table. The number of accesses is
+// large enough to force the table of in-flight access identifiers to grow.
+TEST(TestModule, is_in_flight_many_accesses)
+{
+	try
+	{
+		// Cleanup singleton instances
+		Cleanup();
+
+		// Load configuration file
+		misc::IniFile ini_file_mem;
+		misc::IniFile ini_file_x86;
+		ini_file_mem.LoadFromString(mem_config_0);
+		ini_file_x86.LoadFromString(x86_config_0);
+
+		// Set up x86 timing simulator
+		x86::Timing::ParseConfiguration(&ini_file_x86);
+		x86::Timing::getInstance();
+
+		// Set up memory system
+		System *memory_system = System::getInstance();
+		memory_system->ReadConfiguration(&ini_file_mem);
+
+		// Get Module
+		Module *module_mm = memory_system->getModule("mod-mm");
+		ASSERT_NE(module_mm, nullptr);
+
+		// Set up accesses. Addresses are 64 blocks apart, so every
+		// fourth access maps to the same bucket.
+		const int num_accesses = 100;
+		long long ids[num_accesses];
+		for (int i = 0; i < num_accesses; i++)
+			ids[i] = module_mm->Access(Module::AccessLoad,
+					i * 128 * 64);
+
+		// All accesses in flight after the first cycle
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		esim_engine->ProcessEvents();
+		EXPECT_EQ(num_accesses, module_mm->getNumInFlightAccesses());
+		for (int i = 0; i < num_accesses; i++)
+		{
+			EXPECT_TRUE(module_mm->isInFlightAccess(ids[i]));
+			EXPECT_TRUE(module_mm->isInFlightAddress(i * 128 * 64));
+		}
+		EXPECT_FALSE(module_mm->isInFlightAddress(128));
+
+		// Run until all accesses complete
+		for (int i = 0; i < 100000 &&
+				module_mm->getNumInFlightAccesses(); i++)
+			esim_engine->ProcessEvents();
+		EXPECT_EQ(0, module_mm->getNumInFlightAccesses());
+		EXPECT_EQ(nullptr, module_mm->getOldestAccess());
+		for (int i = 0; i < num_accesses; i++)
+		{
+			EXPECT_FALSE(module_mm->isInFlightAccess(ids[i]));
+			EXPECT_FALSE(module_mm->isInFlightAddress(i * 128 * 64));
+		}
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+
 // Tests a situation where all module ports are locked, and canAccess()
 // returns false. As soon as one port is ready, canAccess() returns true.
 // There are no cache misses so the only relevant latency is the
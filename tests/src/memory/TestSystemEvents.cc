@@ -19,7 +19,9 @@
 
 #include "gtest/gtest.h"
 
+#include <cstdlib>
 #include <regex>
+#include <unistd.h>
 
 #include <arch/x86/timing/Timing.h>
 #include <arch/common/Arch.h>
@@ -29,6 +31,8 @@
 #include <memory/System.h>
 #include <network/System.h>
 
+#include "TestFiles.h"
+
 namespace mem
 {
 
@@ -4764,6 +4768,157 @@ TEST(TestSystemEvents, test_flood)
 				"memory accesses").c_str(), message.c_str());
 }
 */
+// Trace with two accesses from l1_0 at cycle 0, and a store from l1_1 at
+// cycle 5, replayed with one in-flight access per module
+TEST(TestSystemEvents, config_0_trace_simulation)
+{
+	std::string path = test::CreateTempFile("test-mem-trace",
+			"# cycle module type address\n"
+			"0 mod-l1-0 load 0x400\n"
+			"0 mod-l1-0 load 0x800\n"
+			"\n"
+			"5 mod-l1-1 store 0x1000\n");
+
+	try
+	{
+		Cleanup();
+
+		// Load configuration files
+		misc::IniFile ini_file_mem;
+		misc::IniFile ini_file_x86;
+		misc::IniFile ini_file_net;
+		ini_file_mem.LoadFromString(mem_config_0);
+		ini_file_x86.LoadFromString(x86_config);
+		ini_file_net.LoadFromString(net_config);
+
+		// Set up x86 timing simulator
+		x86::Timing::ParseConfiguration(&ini_file_x86);
+		x86::Timing::getInstance();
+
+		// Set up network system
+		net::System *network_system = net::System::getInstance();
+		network_system->ParseConfiguration(&ini_file_net);
+
+		// Set up memory system
+		System *memory_system = System::getInstance();
+		memory_system->ReadConfiguration(&ini_file_mem);
+
+		// Replay trace
+		memory_system->TraceSimulation(path, 1);
+		EXPECT_EQ(3, memory_system->getTraceNumAccesses());
+		EXPECT_GT(memory_system->getTraceNumStalls(), 0);
+		EXPECT_GT(memory_system->getTraceCycles(), 5);
+
+		// All accesses completed
+		Module *module_l1_0 = memory_system->getModule("mod-l1-0");
+		Module *module_l1_1 = memory_system->getModule("mod-l1-1");
+		ASSERT_NE(module_l1_0, nullptr);
+		ASSERT_NE(module_l1_1, nullptr);
+		EXPECT_EQ(0, module_l1_0->getNumInFlightAccesses());
+		EXPECT_EQ(0, module_l1_1->getNumInFlightAccesses());
+		int set;
+		int way;
+		int tag;
+		Cache::BlockState state;
+		EXPECT_TRUE(module_l1_1->FindBlock(0x1000, set, way, tag, state));
+		EXPECT_EQ(state, Cache::BlockModified);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+	unlink(path.c_str());
+}
+
+// Lines longer than the 'gzgets' buffer are read whole, lines over the
+// maximum length are rejected, and the trace file is closed when an error
+// is thrown.
+TEST(TestSystemEvents, config_0_trace_simulation_lines)
+{
+	// Valid trace with a long comment, and an access with long leading
+	// whitespace, and no newline at the end
+	std::string valid_path = test::CreateTempFile("test-mem-trace",
+			"# " + std::string(3000, 'c') + "\n" +
+			std::string(2000, ' ') + "0 mod-l1-0 load 0x400\n" +
+			"3 mod-l1-1 store 0x1000");
+
+	// Line over the maximum length
+	std::string long_path = test::CreateTempFile("test-mem-trace",
+			"0 mod-l1-0 load 0x400\n" +
+			std::string(5000, ' ') + "1 mod-l1-0 load 0x800\n");
+
+	// Invalid line
+	std::string invalid_path = test::CreateTempFile("test-mem-trace",
+			"0 mod-l1-0 load 0x400\n"
+			"1 mod-l1-0 fetch 0x800\n");
+
+	std::string message;
+	try
+	{
+		Cleanup();
+
+		// Load configuration files
+		misc::IniFile ini_file_mem;
+		misc::IniFile ini_file_x86;
+		misc::IniFile ini_file_net;
+		ini_file_mem.LoadFromString(mem_config_0);
+		ini_file_x86.LoadFromString(x86_config);
+		ini_file_net.LoadFromString(net_config);
+
+		// Set up x86 timing simulator
+		x86::Timing::ParseConfiguration(&ini_file_x86);
+		x86::Timing::getInstance();
+
+		// Set up network system
+		net::System *network_system = net::System::getInstance();
+		network_system->ParseConfiguration(&ini_file_net);
+
+		// Set up memory system
+		System *memory_system = System::getInstance();
+		memory_system->ReadConfiguration(&ini_file_mem);
+
+		// Replay valid trace
+		memory_system->TraceSimulation(valid_path, 1);
+		EXPECT_EQ(2, memory_system->getTraceNumAccesses());
+
+		// Errors
+		int num_open_files = test::getNumOpenFiles();
+		try
+		{
+			memory_system->TraceSimulation(long_path, 1);
+		}
+		catch (Error &error)
+		{
+			message = error.getMessage();
+		}
+		EXPECT_REGEX_MATCH(misc::fmt(".*%s:2: trace line too long.*",
+				long_path.c_str()).c_str(), message.c_str());
+		EXPECT_EQ(num_open_files, test::getNumOpenFiles());
+		message.clear();
+		try
+		{
+			memory_system->TraceSimulation(invalid_path, 1);
+		}
+		catch (Error &error)
+		{
+			message = error.getMessage();
+		}
+		EXPECT_REGEX_MATCH(misc::fmt(".*%s:2: invalid access type "
+				"'fetch'.*", invalid_path.c_str()).c_str(),
+				message.c_str());
+		EXPECT_EQ(num_open_files, test::getNumOpenFiles());
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+	unlink(valid_path.c_str());
+	unlink(long_path.c_str());
+	unlink(invalid_path.c_str());
+}
+
 // TODO: Add find_and_lock, find_and_lock_port, find_and_lock_action, and
 // find_and_lock_finish tests.
 
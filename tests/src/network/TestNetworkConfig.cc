@@ -19,9 +19,13 @@
 
 #include "gtest/gtest.h"
 
+#include <dirent.h>
+#include <fstream>
 #include <string>
 #include <regex>
 #include <exception>
+#include <unistd.h>
+#include <vector>
 #include <network/EndNode.h>
 #include <network/RoutingTable.h>
 #include <network/System.h>
@@ -2463,4 +2467,206 @@ TEST(TestSystemConfiguration, thorough_manual_routing)
 	}
 }
 
+
+TEST(TestSystemConfiguration, automatic_routing_ring)
+{
+	// Cleanup singleton instance
+	Cleanup();
+
+	// Setup configuration file. Four switches form a unidirectional
+	// ring s0 -> s1 -> s2 -> s3 -> s0, with one end node each.
+	std::string config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 4\n"
+			"DefaultOutputBufferSize = 4\n"
+			"DefaultBandwidth = 1\n";
+	for (int i = 0; i < 4; i++)
+		config += misc::fmt(
+				"[Network.net0.Node.N%d]\n"
+				"Type = EndNode\n"
+				"[Network.net0.Node.s%d]\n"
+				"Type = Switch\n"
+				"[Network.net0.Link.N%d-s%d]\n"
+				"Type = Bidirectional\n"
+				"Source = N%d\n"
+				"Dest = s%d\n"
+				"[Network.net0.Link.s%d-s%d]\n"
+				"Type = Unidirectional\n"
+				"Source = s%d\n"
+				"Dest = s%d\n",
+				i, i, i, i, i, i,
+				i, (i + 1) % 4, i, (i + 1) % 4);
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(config);
+
+	// Set up network instance
+	System *system = System::getInstance();
+	EXPECT_TRUE(system != nullptr);
+
+	// Test body
+	try
+	{
+		// Parse the configuration file
+		system->ParseConfiguration(&ini_file);
+
+		// Getting the routing table
+		Network *network = system->getNetworkByName("net0");
+		RoutingTable *table = network->getRoutingTable();
+		Node *N0 = network->getNodeByName("N0");
+		Node *N3 = network->getNodeByName("N3");
+		Node *S0 = network->getNodeByName("s0");
+		Node *S1 = network->getNodeByName("s1");
+		Node *S3 = network->getNodeByName("s3");
+
+		// Routes follow the direction of the ring
+		RoutingTable::Entry *entry = table->Lookup(N0, N3);
+		EXPECT_EQ(5, entry->cost);
+		EXPECT_EQ(S0, entry->getNextNode());
+		entry = table->Lookup(S0, N3);
+		EXPECT_EQ(4, entry->cost);
+		EXPECT_EQ(S1, entry->getNextNode());
+		EXPECT_EQ(S0, entry->getBuffer()->getNode());
+		entry = table->Lookup(N3, N0);
+		EXPECT_EQ(3, entry->cost);
+		EXPECT_EQ(S3, entry->getNextNode());
+
+		// A node has no route to itself
+		entry = table->Lookup(N0, N0);
+		EXPECT_EQ(0, entry->cost);
+		EXPECT_TRUE(entry->getNextNode() == nullptr);
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+
+TEST(TestSystemConfiguration, automatic_routing_cache)
+{
+	// Four switches form a unidirectional ring, with one end node each
+	std::string config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 4\n"
+			"DefaultOutputBufferSize = 4\n"
+			"DefaultBandwidth = 1\n";
+	for (int i = 0; i < 4; i++)
+		config += misc::fmt(
+				"[Network.net0.Node.N%d]\n"
+				"Type = EndNode\n"
+				"[Network.net0.Node.s%d]\n"
+				"Type = Switch\n"
+				"[Network.net0.Link.N%d-s%d]\n"
+				"Type = Bidirectional\n"
+				"Source = N%d\n"
+				"Dest = s%d\n"
+				"[Network.net0.Link.s%d-s%d]\n"
+				"Type = Unidirectional\n"
+				"Source = s%d\n"
+				"Dest = s%d\n",
+				i, i, i, i, i, i,
+				i, (i + 1) % 4, i, (i + 1) % 4);
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(config);
+
+	// Route cache directory
+	char directory[] = "/tmp/m2s-route-cache-XXXXXX";
+	ASSERT_TRUE(mkdtemp(directory) != nullptr);
+	System::setRouteCacheDirectory(directory);
+
+	// Return the names of the files in the cache directory
+	auto list_files = [&directory]()
+	{
+		std::vector<std::string> names;
+		DIR *dir = opendir(directory);
+		while (struct dirent *entry = readdir(dir))
+			if (entry->d_name[0] != '.')
+				names.push_back(entry->d_name);
+		closedir(dir);
+		return names;
+	};
+
+	// Return the lines of the cache file
+	auto read_lines = [](const std::string &path)
+	{
+		std::vector<std::string> lines;
+		std::ifstream f(path);
+		std::string line;
+		while (std::getline(f, line))
+			lines.push_back(line);
+		return lines;
+	};
+
+	// Write lines into the cache file
+	auto write_lines = [](const std::string &path,
+			const std::vector<std::string> &lines)
+	{
+		std::ofstream f(path);
+		for (const std::string &line : lines)
+			f << line << '\n';
+	};
+
+	try
+	{
+		// The first run saves the routes, leaving no temporary file
+		Cleanup();
+		System::getInstance()->ParseConfiguration(&ini_file);
+		std::vector<std::string> names = list_files();
+		ASSERT_EQ(1u, names.size());
+		std::string path = std::string(directory) + "/" + names[0];
+		std::vector<std::string> lines = read_lines(path);
+		ASSERT_LE(3u, lines.size());
+		EXPECT_EQ("end", lines.back());
+
+		// A complete file is loaded. Change the cost of the route from
+		// N0 to N3 to tell it apart from a computed route.
+		Network *network = System::getInstance()->
+				getNetworkByName("net0");
+		int n0 = network->getNodeByName("N0")->getIndex();
+		int n3 = network->getNodeByName("N3")->getIndex();
+		std::string prefix = misc::fmt("%d %d 5 ", n0, n3);
+		for (std::string &line : lines)
+			if (line.compare(0, prefix.size(), prefix) == 0)
+				line = misc::fmt("%d %d 6 ", n0, n3) +
+						line.substr(prefix.size());
+		write_lines(path, lines);
+		Cleanup();
+		System::getInstance()->ParseConfiguration(&ini_file);
+		network = System::getInstance()->getNetworkByName("net0");
+		EXPECT_EQ(6, network->getRoutingTable()->Lookup(
+				network->getNodeByName("N0"),
+				network->getNodeByName("N3"))->cost);
+
+		// A truncated file is rejected, and routes are computed and
+		// saved again
+		lines.resize(2);
+		write_lines(path, lines);
+		Cleanup();
+		System::getInstance()->ParseConfiguration(&ini_file);
+		network = System::getInstance()->getNetworkByName("net0");
+		RoutingTable *table = network->getRoutingTable();
+		EXPECT_EQ(5, table->Lookup(network->getNodeByName("N0"),
+				network->getNodeByName("N3"))->cost);
+		EXPECT_EQ(network->getNodeByName("s3"), table->Lookup(
+				network->getNodeByName("N3"),
+				network->getNodeByName("N0"))->getNextNode());
+		EXPECT_EQ("end", read_lines(path).back());
+		EXPECT_EQ(1u, list_files().size());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		ADD_FAILURE();
+	}
+
+	// Remove cache directory
+	for (const std::string &name : list_files())
+		unlink((std::string(directory) + "/" + name).c_str());
+	rmdir(directory);
+	System::setRouteCacheDirectory("");
+}
+
 }
@@ -19,12 +19,17 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <set>
 #include <string>
 #include <regex>
 #include <exception>
+#include <network/Buffer.h>
 #include <network/EndNode.h>
+#include <network/Link.h>
 #include <network/Message.h>
 #include <network/Network.h>
+#include <network/Packet.h>
 #include <network/System.h>
 #include <lib/cpp/IniFile.h>
 #include <lib/cpp/Error.h>
@@ -1884,4 +1889,540 @@ TEST(TestSystemConfiguration, event_config_13_ideal_fix_latency)
 	}
 }
 
+TEST(TestSystemConfiguration, event_config_7_analytic_latency)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	std::string net_config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 4\n"
+			"DefaultOutputBufferSize = 4\n"
+			"DefaultBandwidth = 1\n"
+			"Analytic = True\n"
+			"\n"
+			"[ Network.net0.Node.n0 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n1 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.s0 ]\n"
+			"Type = Switch\n"
+			"\n"
+			"[ Network.net0.Link.n0-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n0\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n1-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n1\n"
+			"Dest = s0";
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(net_config);
+
+	// Set up network instance
+	System *network_system = System::getInstance();
+
+	// Test body
+	try
+	{
+		// Parse the configuration file
+		network_system->ParseConfiguration(&ini_file);
+
+		// Getting the network
+		Network *network = network_system->getNetworkByName("net0");
+		EXPECT_TRUE(network->isAnalytic());
+
+		// Getting the source and destination nodes
+		EndNode *src = misc::cast<EndNode *>(network->getNodeByName("n0"));
+		EndNode *dst = misc::cast<EndNode *>(network->getNodeByName("n1"));
+
+		// One cycle to enter the output buffer, plus 4 cycles on
+		// each of the two links
+		EXPECT_EQ(9, network->CalculateAnalyticLatency(src, dst, 4));
+
+		// A second message waits for the first one on each link
+		EXPECT_EQ(13, network->CalculateAnalyticLatency(src, dst, 4));
+
+		// Buffer sizes are not modeled, so a message larger than the
+		// output buffer can be sent
+		EXPECT_TRUE(network->CanSend(src, dst, 16));
+
+		// Send a message, which is delivered as a single packet
+		Message *msg = network->TrySend(src, dst, 4);
+		ASSERT_TRUE(msg != nullptr);
+		EXPECT_EQ(1, msg->getNumPackets());
+		Packet *packet = msg->getPacket(0);
+		EXPECT_EQ(dst, packet->getNode());
+
+		// The output buffer is neither busy nor full for the next one
+		EXPECT_TRUE(network->CanSend(src, dst, 4));
+
+		// Receive the message
+		network->Receive(dst, msg);
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemConfiguration, event_config_8_message_recycling)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	std::string net_config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 8\n"
+			"DefaultOutputBufferSize = 8\n"
+			"DefaultBandwidth = 1\n"
+			"DefaultPacketSize = 2\n"
+			"\n"
+			"[ Network.net0.Node.n0 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n1 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.s0 ]\n"
+			"Type = Switch\n"
+			"\n"
+			"[ Network.net0.Link.n0-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n0\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n1-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n1\n"
+			"Dest = s0";
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(net_config);
+
+	// Set up network instance
+	System *network_system = System::getInstance();
+
+	// Test body
+	try
+	{
+		// Parse the configuration file
+		network_system->ParseConfiguration(&ini_file);
+
+		// Getting the network
+		Network *network = network_system->getNetworkByName("net0");
+
+		// Getting the source and destination nodes
+		EndNode *src = misc::cast<EndNode *>(network->getNodeByName("n0"));
+		EndNode *dst = misc::cast<EndNode *>(network->getNodeByName("n1"));
+
+		// Send messages one after another. Each one is received
+		// automatically, and its object is reused by the next one.
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		for (int i = 0; i < 3; i++)
+		{
+			Message *msg = network->TrySend(src, dst, 4 + 2 * i);
+			ASSERT_TRUE(msg != nullptr);
+			EXPECT_EQ(i, msg->getId());
+			EXPECT_EQ(2 + i, msg->getNumPackets());
+			EXPECT_EQ(1, network->getNumMessagesInFlight());
+			while (network->getNumMessagesInFlight())
+				esim_engine->ProcessEvents();
+			EXPECT_EQ(0, dst->getInputBuffer(0)->getNumPacket());
+		}
+		EXPECT_EQ(1, network->getNumAllocatedMessages());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemConfiguration, event_config_8_packet_queue_growth)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	std::string net_config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 32\n"
+			"DefaultOutputBufferSize = 32\n"
+			"DefaultBandwidth = 1\n"
+			"DefaultPacketSize = 1\n"
+			"\n"
+			"[ Network.net0.Node.n0 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n1 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.s0 ]\n"
+			"Type = Switch\n"
+			"\n"
+			"[ Network.net0.Link.n0-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n0\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n1-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n1\n"
+			"Dest = s0";
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(net_config);
+
+	// Set up network instance
+	System *network_system = System::getInstance();
+
+	// Test body
+	try
+	{
+		// Parse the configuration file
+		network_system->ParseConfiguration(&ini_file);
+
+		// Getting the network
+		Network *network = network_system->getNetworkByName("net0");
+
+		// Getting the source and destination nodes
+		EndNode *src = misc::cast<EndNode *>(network->getNodeByName("n0"));
+		EndNode *dst = misc::cast<EndNode *>(network->getNodeByName("n1"));
+
+		// Messages with more packets than the initial capacity of the
+		// packet queues. The second one is inserted while the queue
+		// head has moved, so it grows a wrapped-around queue.
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		Buffer *buffer = src->getOutputBuffer(0);
+		Message *msg = network->TrySend(src, dst, 12);
+		ASSERT_TRUE(msg != nullptr);
+		EXPECT_EQ(12, buffer->getNumPacket());
+		for (int i = 0; i < 3; i++)
+			esim_engine->ProcessEvents();
+		int num_packets = buffer->getNumPacket();
+		EXPECT_GT(12, num_packets);
+		msg = network->TrySend(src, dst, 20);
+		ASSERT_TRUE(msg != nullptr);
+		EXPECT_EQ(num_packets + 20, buffer->getNumPacket());
+		while (network->getNumMessagesInFlight())
+			esim_engine->ProcessEvents();
+		EXPECT_EQ(0, buffer->getNumPacket());
+		EXPECT_EQ(0, dst->getInputBuffer(0)->getNumPacket());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemConfiguration, event_config_9_message_class_virtual_channel)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	std::string net_config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 4\n"
+			"DefaultOutputBufferSize = 4\n"
+			"DefaultBandwidth = 1\n"
+			"DefaultVC = 2\n"
+			"\n"
+			"[ Network.net0.Node.n0 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n1 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.s0 ]\n"
+			"Type = Switch\n"
+			"\n"
+			"[ Network.net0.Link.n0-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n0\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n1-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n1\n"
+			"Dest = s0";
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(net_config);
+
+	// Set up network instance
+	System *network_system = System::getInstance();
+
+	// Test body
+	try
+	{
+		// Parse the configuration file
+		network_system->ParseConfiguration(&ini_file);
+
+		// Getting the network
+		Network *network = network_system->getNetworkByName("net0");
+
+		// Getting the source and destination nodes
+		EndNode *src = misc::cast<EndNode *>(network->getNodeByName("n0"));
+		EndNode *dst = misc::cast<EndNode *>(network->getNodeByName("n1"));
+
+		// Links take their number of virtual channels from the
+		// network default
+		EXPECT_EQ(2, src->getNumOutputBuffers());
+
+		// Messages of class 0 and 1 are sent on different virtual
+		// channels, both in the same cycle
+		Message *msg_0 = network->TrySend(src, dst, 4, nullptr,
+				nullptr, 0);
+		ASSERT_TRUE(msg_0 != nullptr);
+		EXPECT_EQ(src->getOutputBuffer(0),
+				msg_0->getPacket(0)->getBuffer());
+		Message *msg_1 = network->TrySend(src, dst, 4, nullptr,
+				nullptr, 1);
+		ASSERT_TRUE(msg_1 != nullptr);
+		EXPECT_EQ(src->getOutputBuffer(1),
+				msg_1->getPacket(0)->getBuffer());
+
+		// Both messages are received automatically
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		for (int i = 0; i < 100 && network->getNumMessagesInFlight(); i++)
+			esim_engine->ProcessEvents();
+		EXPECT_EQ(0, network->getNumMessagesInFlight());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemConfiguration, event_config_10_wormhole)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	std::string net_config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 8\n"
+			"DefaultOutputBufferSize = 8\n"
+			"DefaultBandwidth = 1\n"
+			"DefaultPacketSize = 1\n"
+			"Wormhole = True\n"
+			"\n"
+			"[ Network.net0.Node.n0 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n1 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n2 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.s0 ]\n"
+			"Type = Switch\n"
+			"\n"
+			"[ Network.net0.Link.n0-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n0\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n1-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n1\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n2-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n2\n"
+			"Dest = s0";
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(net_config);
+
+	// Set up network instance
+	System *network_system = System::getInstance();
+
+	// Test body
+	try
+	{
+		// Parse the configuration file
+		network_system->ParseConfiguration(&ini_file);
+
+		// Getting the network
+		Network *network = network_system->getNetworkByName("net0");
+		EXPECT_TRUE(network->isWormhole());
+
+		// Getting the nodes
+		EndNode *n0 = misc::cast<EndNode *>(network->getNodeByName("n0"));
+		EndNode *n1 = misc::cast<EndNode *>(network->getNodeByName("n1"));
+		EndNode *n2 = misc::cast<EndNode *>(network->getNodeByName("n2"));
+
+		// Switch output buffer towards n2
+		Node *s0 = network->getNodeByName("s0");
+		Buffer *output_buffer = nullptr;
+		for (int i = 0; i < s0->getNumOutputBuffers(); i++)
+		{
+			Buffer *buffer = s0->getOutputBuffer(i);
+			Link *link = dynamic_cast<Link *>(
+					buffer->getConnection());
+			if (link && link->getDestinationNode() == n2)
+				output_buffer = buffer;
+		}
+		ASSERT_TRUE(output_buffer != nullptr);
+
+		// Two sources send multi-packet messages to the same
+		// destination, competing for the same switch output buffer
+		Message *message_0 = network->TrySend(n0, n2, 4);
+		Message *message_1 = network->TrySend(n1, n2, 4);
+		ASSERT_TRUE(message_0 != nullptr);
+		ASSERT_TRUE(message_1 != nullptr);
+		ASSERT_GT(message_0->getNumPackets(), 1);
+		ASSERT_GT(message_1->getNumPackets(), 1);
+		long long message_0_id = message_0->getId();
+		long long message_1_id = message_1->getId();
+
+		// Record the messages of the packets in the order they enter
+		// the switch output buffer, until both messages are received
+		std::vector<long long> order;
+		std::set<Packet *> seen;
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		for (int i = 0; i < 200 && network->getNumMessagesInFlight(); i++)
+		{
+			for (int j = 0; j < output_buffer->getNumPacket(); j++)
+			{
+				Packet *packet = output_buffer->getPacket(j);
+				if (seen.insert(packet).second)
+					order.push_back(packet->getMessage()->getId());
+			}
+			esim_engine->ProcessEvents();
+		}
+		EXPECT_EQ(0, network->getNumMessagesInFlight());
+
+		// All packets went through the buffer, and the packets of the
+		// two messages never interleaved in it
+		ASSERT_EQ(8, (int) order.size());
+		int changes = 0;
+		for (int i = 1; i < (int) order.size(); i++)
+			if (order[i] != order[i - 1])
+				changes++;
+		EXPECT_EQ(1, changes);
+		EXPECT_EQ(4, std::count(order.begin(), order.end(),
+				message_0_id));
+		EXPECT_EQ(4, std::count(order.begin(), order.end(),
+				message_1_id));
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemConfiguration, event_config_11_synthetic_traffic)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	std::string net_config =
+			"[ Network.net0 ]\n"
+			"DefaultInputBufferSize = 8\n"
+			"DefaultOutputBufferSize = 8\n"
+			"DefaultBandwidth = 1\n"
+			"\n"
+			"[ Network.net0.Node.n0 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n1 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n2 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.n3 ]\n"
+			"Type = EndNode\n"
+			"\n"
+			"[ Network.net0.Node.s0 ]\n"
+			"Type = Switch\n"
+			"\n"
+			"[ Network.net0.Link.n0-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n0\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n1-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n1\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n2-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n2\n"
+			"Dest = s0\n"
+			"\n"
+			"[ Network.net0.Link.n3-s0 ]\n"
+			"Type = Bidirectional\n"
+			"Source = n3\n"
+			"Dest = s0";
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(net_config);
+
+	// Set up network instance
+	System *network_system = System::getInstance();
+
+	// Test body
+	try
+	{
+		// Traffic patterns on 4 end nodes, as a 2x2 grid for transpose
+		EXPECT_EQ(-1, System::getTrafficDestination(
+				System::TrafficTranspose, 0, 4));
+		EXPECT_EQ(2, System::getTrafficDestination(
+				System::TrafficTranspose, 1, 4));
+		EXPECT_EQ(3, System::getTrafficDestination(
+				System::TrafficBitComplement, 0, 4));
+		EXPECT_EQ(0, System::getTrafficDestination(
+				System::TrafficNeighbor, 3, 4));
+		EXPECT_EQ(2, System::getTrafficDestination(
+				System::TrafficTornado, 1, 4));
+		EXPECT_NE(1, System::getTrafficDestination(
+				System::TrafficUniform, 1, 4));
+		EXPECT_THROW(System::getTrafficDestination(
+				System::TrafficTranspose, 0, 3), Error);
+
+		// Parse the configuration file
+		network_system->ParseConfiguration(&ini_file);
+		Network *network = network_system->getNetworkByName("net0");
+
+		// Inject uniform traffic and drain the network
+		long long num_messages = network_system->TrafficSimulation(
+				network, 0.05, 200);
+		EXPECT_GT(num_messages, 0);
+		EXPECT_TRUE(network_system->DrainSimulation(network, 1000));
+		EXPECT_EQ(0, network->getNumMessagesInFlight());
+
+		// All received messages are in the latency histogram
+		long long count = 0;
+		for (long long value : network->getLatencyHistogram())
+			count += value;
+		EXPECT_GT(network->getTransfers(), 0);
+		EXPECT_EQ(network->getTransfers(), count);
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
 }